@@ -0,0 +1,295 @@
+#include "battery.h"
+
+#include "driver/gpio.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+// Without CONFIG_BATTERY_MONITOR the task never runs: battery_get stays
+// false and the dashboard keeps its placeholder
+static battery_state_t state;
+static bool have_state;
+static portMUX_TYPE state_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static battery_change_cb_t change_cb;
+static battery_stats_t stats;
+
+#if CONFIG_BATTERY_MONITOR
+
+static const char *TAG = "BATTERY";
+
+// The circuit is described in Kconfig.projbuild
+#define BATTERY_ADC_UNIT ADC_UNIT_1
+#define BATTERY_ADC_CHANNEL ((adc_channel_t)CONFIG_BATTERY_ADC_CHANNEL)
+#define BATTERY_ADC_ATTEN ADC_ATTEN_DB_11
+#define DIVIDER_TOP CONFIG_BATTERY_DIVIDER_TOP_KOHM
+#define DIVIDER_BOTTOM CONFIG_BATTERY_DIVIDER_BOTTOM_KOHM
+// Open drain, low while charging; -1 when not wired
+#define CHRG_PIN CONFIG_BATTERY_CHRG_GPIO
+
+// One burst: 64 conversions at 20 kHz, 3.2 ms
+#define BURST_SAMPLES 64
+#define BURST_FREQ_HZ 20000
+#define BURST_BYTES (BURST_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES)
+#define BURST_TIMEOUT_MS 50
+
+// IIR state is mV in Q4; each measurement moves it 1/8 of the way
+#define IIR_FRAC_BITS 4
+#define IIR_SHIFT 3
+
+// Percentage must pass a bucket edge by this much before the label moves
+#define HYSTERESIS_PCT 2
+
+// Discharge curve of a 1S LiPo at rest, 10 mV steps from 3300 to 4200 mV.
+// Linear interpolation of: 3270:0 3610:5 3690:10 3710:15 3730:20 3750:25
+// 3770:30 3790:35 3800:40 3820:45 3840:50 3850:55 3870:60 3910:65 3950:70
+// 3980:75 4020:80 4080:85 4110:90 4150:95 4200:100
+#define LUT_MIN_MV 3300
+#define LUT_STEP_MV 10
+static const uint8_t discharge_lut[] = {
+    0,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  2,  2,  3,
+    3,  3,  3,  3,  3,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,
+    6,  6,  7,  8,  8,  9,  9,  10, 12, 15, 18, 20, 22, 25, 28, 30,
+    32, 35, 40, 42, 45, 48, 50, 55, 58, 60, 61, 62, 64, 65, 66, 68,
+    69, 70, 72, 73, 75, 76, 78, 79, 80, 81, 82, 82, 83, 84, 85, 87,
+    88, 90, 91, 92, 94, 95, 96, 97, 98, 99, 100,
+};
+#define LUT_LEN (sizeof(discharge_lut) / sizeof(discharge_lut[0]))
+
+static adc_continuous_handle_t adc;
+static adc_cali_handle_t cali;
+static TaskHandle_t battery_task;
+
+static uint32_t iir_q; // 0 until seeded
+
+static esp_err_t adc_init(void) {
+  const adc_continuous_handle_cfg_t handle_cfg = {
+      .max_store_buf_size = BURST_BYTES * 2,
+      .conv_frame_size = BURST_BYTES,
+  };
+  ESP_RETURN_ON_ERROR(adc_continuous_new_handle(&handle_cfg, &adc), TAG,
+                      "ADC handle was not created");
+
+  adc_digi_pattern_config_t pattern = {
+      .atten = BATTERY_ADC_ATTEN,
+      .channel = BATTERY_ADC_CHANNEL,
+      .unit = BATTERY_ADC_UNIT,
+      .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+  };
+  const adc_continuous_config_t cfg = {
+      .pattern_num = 1,
+      .adc_pattern = &pattern,
+      .sample_freq_hz = BURST_FREQ_HZ,
+      .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+      .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+  };
+  ESP_RETURN_ON_ERROR(adc_continuous_config(adc, &cfg), TAG,
+                      "ADC was not configured");
+
+  const adc_cali_line_fitting_config_t cali_cfg = {
+      .unit_id = BATTERY_ADC_UNIT,
+      .atten = BATTERY_ADC_ATTEN,
+      .bitwidth = SOC_ADC_DIGI_MAX_BITWIDTH,
+  };
+  return adc_cali_create_scheme_line_fitting(&cali_cfg, &cali);
+}
+
+#if CHRG_PIN >= 0
+static void IRAM_ATTR on_chrg_edge(void *arg) {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(battery_task, &woken);
+  if (woken == pdTRUE)
+    portYIELD_FROM_ISR();
+}
+
+static esp_err_t chrg_init(void) {
+  const gpio_config_t io = {
+      .pin_bit_mask = 1ULL << CHRG_PIN,
+      .mode = GPIO_MODE_INPUT,
+      .pull_up_en = GPIO_PULLUP_ENABLE,
+      .intr_type = GPIO_INTR_ANYEDGE,
+  };
+  ESP_RETURN_ON_ERROR(gpio_config(&io), TAG, "CHRG pin was not configured");
+
+  // Already installed by another driver is fine
+  esp_err_t err = gpio_install_isr_service(0);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+    return err;
+
+  return gpio_isr_handler_add(CHRG_PIN, on_chrg_edge, NULL);
+}
+#else
+static esp_err_t chrg_init(void) { return ESP_OK; }
+#endif
+
+// Averaged pin voltage of one DMA burst, in mV
+static esp_err_t read_burst(uint32_t *out_mv) {
+  static uint8_t buf[BURST_BYTES];
+  uint32_t len = 0;
+
+  // Drop conversions left over from the previous burst
+  while (adc_continuous_read(adc, buf, sizeof(buf), &len, 0) == ESP_OK) {
+  }
+
+  // The read blocks until the DMA has filled one frame
+  ESP_RETURN_ON_ERROR(adc_continuous_start(adc), TAG, "ADC did not start");
+  esp_err_t err =
+      adc_continuous_read(adc, buf, sizeof(buf), &len, BURST_TIMEOUT_MS);
+  adc_continuous_stop(adc);
+  ESP_RETURN_ON_ERROR(err, TAG, "ADC burst read failed");
+
+  uint32_t sum = 0;
+  uint32_t count = 0;
+  for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len;
+       i += SOC_ADC_DIGI_RESULT_BYTES) {
+    const adc_digi_output_data_t *p = (const adc_digi_output_data_t *)&buf[i];
+    if (p->type1.channel != BATTERY_ADC_CHANNEL)
+      continue;
+    sum += p->type1.data;
+    count++;
+  }
+  ESP_RETURN_ON_FALSE(count > 0, ESP_ERR_INVALID_SIZE, TAG,
+                      "ADC burst had no samples");
+
+  stats.bursts++;
+  stats.samples += count;
+
+  // Calibrate the mean once instead of every sample
+  int mv = 0;
+  ESP_RETURN_ON_ERROR(
+      adc_cali_raw_to_voltage(cali, (int)((sum + count / 2) / count), &mv),
+      TAG, "ADC calibration failed");
+  *out_mv = (uint32_t)mv;
+  return ESP_OK;
+}
+
+static uint32_t cell_mv(uint32_t pin_mv) {
+  return (pin_mv * (DIVIDER_TOP + DIVIDER_BOTTOM) + DIVIDER_BOTTOM / 2) /
+         DIVIDER_BOTTOM;
+}
+
+static uint16_t iir_filter(uint32_t mv) {
+  const uint32_t x = mv << IIR_FRAC_BITS;
+
+  if (iir_q == 0)
+    iir_q = x;
+  else if (x > iir_q)
+    iir_q += (x - iir_q) >> IIR_SHIFT;
+  else
+    iir_q -= (iir_q - x) >> IIR_SHIFT;
+
+  return (uint16_t)((iir_q + (1 << (IIR_FRAC_BITS - 1))) >> IIR_FRAC_BITS);
+}
+
+static uint8_t lut_percent(uint16_t mv) {
+  if (mv <= LUT_MIN_MV)
+    return 0;
+
+  uint32_t i = (mv - LUT_MIN_MV) / LUT_STEP_MV;
+  return i >= LUT_LEN ? 100 : discharge_lut[i];
+}
+
+// Snaps to a bucket, moving only once the reading is HYSTERESIS_PCT past
+// the midpoint to the next one
+static uint8_t apply_hysteresis(uint8_t shown, uint8_t pct, bool reset) {
+  const int half = BATTERY_BUCKET_PCT / 2;
+  const uint8_t nearest =
+      (uint8_t)((pct + half) / BATTERY_BUCKET_PCT * BATTERY_BUCKET_PCT);
+
+  if (reset)
+    return nearest;
+
+  if (pct > shown + half + HYSTERESIS_PCT ||
+      pct + half + HYSTERESIS_PCT < shown)
+    return nearest;
+
+  if (nearest != shown)
+    stats.suppressed++;
+  return shown;
+}
+
+static void battery_task_loop(void *param) {
+  bool first = true;
+
+  while (true) {
+    uint32_t pin_mv;
+    const bool charging = CHRG_PIN >= 0 && gpio_get_level(CHRG_PIN) == 0;
+
+    if (read_burst(&pin_mv) == ESP_OK) {
+      // The charger lifts the cell voltage; start the filter over
+      const bool charger_changed = !first && charging != state.charging;
+      if (charger_changed)
+        iir_q = 0;
+
+      const uint16_t mv = iir_filter(cell_mv(pin_mv));
+      const uint8_t shown = apply_hysteresis(
+          state.percent, lut_percent(mv), first || charger_changed);
+      const bool changed =
+          first || shown != state.percent || charging != state.charging;
+
+      taskENTER_CRITICAL(&state_mux);
+      state = (battery_state_t){
+          .percent = shown, .charging = charging, .mv = mv};
+      have_state = true;
+      taskEXIT_CRITICAL(&state_mux);
+
+      if (changed) {
+        stats.events++;
+        ESP_LOGI(TAG, "%u%% (%u mV)%s", shown, mv,
+                 charging ? ", charging" : "");
+        if (change_cb)
+          change_cb();
+      }
+      first = false;
+    }
+
+    // A CHRG edge ends the wait early
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BATTERY_PERIOD_MS));
+  }
+}
+
+bool battery_start(void) {
+  if (adc_init() != ESP_OK)
+    return false;
+
+  // Keeps working without the charger pin, only without instant updates
+  if (xTaskCreate(battery_task_loop, "battery", 3072, NULL,
+                  tskIDLE_PRIORITY + 1, &battery_task) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start task");
+    return false;
+  }
+
+  if (chrg_init() != ESP_OK)
+    ESP_LOGW(TAG, "No CHRG interrupt, charging seen every %d s",
+             BATTERY_PERIOD_MS / 1000);
+
+  return true;
+}
+
+#endif
+
+void battery_set_change_callback(battery_change_cb_t cb) { change_cb = cb; }
+
+bool battery_get(battery_state_t *out) {
+  if (out == NULL)
+    return false;
+
+  taskENTER_CRITICAL(&state_mux);
+  bool ok = have_state;
+  if (ok)
+    *out = state;
+  taskEXIT_CRITICAL(&state_mux);
+
+  return ok;
+}
+
+void battery_get_stats(battery_stats_t *out) {
+  if (out)
+    *out = stats;
+}
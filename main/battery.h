@@ -0,0 +1,44 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// LiPo battery monitor. Every BATTERY_PERIOD_MS the cell voltage is
+// oversampled in one ADC DMA burst, averaged, smoothed with an integer IIR
+// filter and mapped to a percentage through a discharge-curve table. The
+// displayed percentage moves in BATTERY_BUCKET_PCT steps with hysteresis,
+// and the change callback only fires when it (or the charging state)
+// actually changes. The charger's CHRG output, when wired, wakes the task
+// at once. Only started with CONFIG_BATTERY_MONITOR, which also sets the
+// ADC channel, divider and CHRG GPIO.
+
+#define BATTERY_PERIOD_MS 30000
+#define BATTERY_BUCKET_PCT 5
+
+typedef struct {
+  uint8_t percent; // displayed, a multiple of BATTERY_BUCKET_PCT
+  bool charging;
+  uint16_t mv;     // filtered cell voltage
+} battery_state_t;
+
+typedef struct {
+  uint32_t bursts;
+  uint32_t samples; // conversions averaged over all bursts
+  uint32_t events;  // change callbacks fired
+  uint32_t suppressed; // percentage moves held back by the hysteresis
+} battery_stats_t;
+
+typedef void (*battery_change_cb_t)(void);
+
+bool battery_start(void);
+
+// Called from the battery task after the displayed state has changed
+void battery_set_change_callback(battery_change_cb_t cb);
+
+// False until the first measurement
+bool battery_get(battery_state_t *out);
+
+void battery_get_stats(battery_stats_t *out);
+
+#endif
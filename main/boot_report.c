@@ -0,0 +1,99 @@
+#include "boot_report.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+static const char *TAG = "BOOT";
+
+static const char *const phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_APP_MAIN] = "app_main",
+    [BOOT_PHASE_SPI_BUS] = "SPI bus up",
+    [BOOT_PHASE_PANEL_RESET] = "panel reset",
+    [BOOT_PHASE_LVGL_READY] = "LVGL ready",
+    [BOOT_PHASE_FIRST_FLUSH] = "first flush",
+    [BOOT_PHASE_DISPLAY_ON] = "display on",
+    [BOOT_PHASE_TOUCH_READY] = "touch ready",
+    [BOOT_PHASE_SENSOR_READY] = "sensor ready",
+    [BOOT_PHASE_FIRST_SAMPLE] = "first sample",
+};
+
+static int64_t phase_us[BOOT_PHASE_COUNT];
+static uint32_t phases_done;
+static bool printed; // by the last boot_mark or the timeout, whichever won
+static portMUX_TYPE boot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void boot_mark(boot_phase_t phase) {
+  if (phase >= BOOT_PHASE_COUNT)
+    return;
+
+  int64_t now = esp_timer_get_time();
+  bool print = false;
+
+  taskENTER_CRITICAL(&boot_lock);
+  if (!(phases_done & (1u << phase))) {
+    phase_us[phase] = now;
+    phases_done |= 1u << phase;
+    print = !printed && phases_done == (1u << BOOT_PHASE_COUNT) - 1;
+    printed |= print;
+  }
+  taskEXIT_CRITICAL(&boot_lock);
+
+  if (print)
+    boot_report_print();
+}
+
+// Prints the report anyway if a phase has not been reached in time, which
+// is when it is needed most
+static void timeout_task(void *param) {
+  vTaskDelay(pdMS_TO_TICKS(BOOT_REPORT_TIMEOUT_MS));
+
+  taskENTER_CRITICAL(&boot_lock);
+  const bool print = !printed;
+  const uint32_t done = phases_done;
+  printed = true;
+  taskEXIT_CRITICAL(&boot_lock);
+
+  if (print) {
+    char missing[128];
+    int len = 0;
+    missing[0] = '\0';
+    for (int i = 0; i < BOOT_PHASE_COUNT && len < (int)sizeof(missing); i++) {
+      if (!(done & (1u << i)))
+        len += snprintf(missing + len, sizeof(missing) - len, "%s%s",
+                        len > 0 ? ", " : "", phase_names[i]);
+    }
+    ESP_LOGW(TAG, "Boot not finished after %d s, never reached: %s",
+             BOOT_REPORT_TIMEOUT_MS / 1000, missing);
+    boot_report_print();
+  }
+
+  vTaskDelete(NULL);
+}
+
+bool boot_report_start(void) {
+  return xTaskCreate(timeout_task, "boot_report", 3072, NULL,
+                     tskIDLE_PRIORITY + 1, NULL) == pdPASS;
+}
+
+int64_t boot_phase_time(boot_phase_t phase) {
+  if (phase >= BOOT_PHASE_COUNT || !(phases_done & (1u << phase)))
+    return -1;
+  return phase_us[phase];
+}
+
+void boot_report_print(void) {
+  ESP_LOGI(TAG, "Boot report (ms since reset):");
+
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    int64_t t = boot_phase_time(i);
+    if (t < 0)
+      ESP_LOGI(TAG, "  %-13s      -", phase_names[i]);
+    else
+      ESP_LOGI(TAG, "  %-13s %6lld.%01lld", phase_names[i],
+               (long long)(t / 1000), (long long)(t % 1000 / 100));
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef BOOT_REPORT_H
+#define BOOT_REPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Boot milestones, recorded once each with the esp_timer time since reset.
+// The report is printed as soon as the last milestone is reached, or
+// BOOT_REPORT_TIMEOUT_MS after boot_report_start with the milestones that
+// were never reached, whichever comes first.
+
+#define BOOT_REPORT_TIMEOUT_MS 30000
+
+typedef enum {
+  BOOT_PHASE_APP_MAIN,
+  BOOT_PHASE_SPI_BUS,
+  BOOT_PHASE_PANEL_RESET,
+  BOOT_PHASE_LVGL_READY,
+  BOOT_PHASE_FIRST_FLUSH,
+  BOOT_PHASE_DISPLAY_ON,
+  BOOT_PHASE_TOUCH_READY,
+  BOOT_PHASE_SENSOR_READY,
+  BOOT_PHASE_FIRST_SAMPLE,
+  BOOT_PHASE_COUNT,
+} boot_phase_t;
+
+void boot_mark(boot_phase_t phase);
+
+// Starts the timeout, from app_main
+bool boot_report_start(void);
+
+// Time of a recorded phase in microseconds, or -1 if not reached yet
+int64_t boot_phase_time(boot_phase_t phase);
+
+void boot_report_print(void);
+
+#endif
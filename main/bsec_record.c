@@ -0,0 +1,314 @@
+#include "bsec_record.h"
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "log_defer.h"
+#include <assert.h>
+#include <string.h>
+
+static const char *TAG = "BSEC_REC";
+
+#define RECORD_MAGIC "BREC"
+#define RECORD_VERSION 1
+#define RECORD_END 0xff
+
+#define RECORD_DATA_LEN 22
+#define RECORD_OUTPUT_LEN 6
+#define RECORD_VARINT_MAX 10
+
+#define RECORD_PARTITION_LABEL "bsecrec"
+#define RECORD_SECTOR_SIZE 4096
+
+static_assert(1 + RECORD_VARINT_MAX + RECORD_DATA_LEN + 1 +
+                      BSEC_NUMBER_OUTPUTS * RECORD_OUTPUT_LEN <=
+                  BSEC_RECORD_MAX_LEN,
+              "a frame with every output fits a record");
+
+static bsec_record_sink_t sink;
+static void *sink_ctx;
+static int64_t prev_us;
+static bool sink_failed;
+static bsec_record_stats_t stats;
+
+static const esp_partition_t *partition;
+static size_t partition_pos;
+
+static uint8_t *put_f32(uint8_t *p, float v) {
+  uint32_t u;
+  memcpy(&u, &v, sizeof(u));
+  for (int i = 0; i < 4; i++)
+    *p++ = (uint8_t)(u >> (8 * i));
+  return p;
+}
+
+static const uint8_t *get_f32(const uint8_t *p, float *v) {
+  uint32_t u = 0;
+  for (int i = 0; i < 4; i++)
+    u |= (uint32_t)*p++ << (8 * i);
+  memcpy(v, &u, sizeof(u));
+  return p;
+}
+
+void bsec_record_header(uint8_t *buf) {
+  memcpy(buf, RECORD_MAGIC, 4);
+  buf[4] = RECORD_VERSION;
+  memset(buf + 5, 0, BSEC_RECORD_HEADER_LEN - 5);
+}
+
+size_t bsec_record_encode(uint8_t *buf, int64_t *prev, int64_t time_us,
+                          const bme68x_data_t *d,
+                          const bsec_outputs_t *outputs) {
+  uint8_t n = outputs->n_outputs;
+  uint8_t *p = buf + 1;
+
+  if (n > BSEC_NUMBER_OUTPUTS)
+    n = BSEC_NUMBER_OUTPUTS;
+
+  uint64_t dt = time_us > *prev ? (uint64_t)(time_us - *prev) : 0;
+  *prev = time_us;
+  do {
+    *p = dt & 0x7f;
+    dt >>= 7;
+    *p++ |= dt ? 0x80 : 0;
+  } while (dt);
+
+  *p++ = d->status;
+  *p++ = d->gas_index;
+  *p++ = d->meas_index;
+  *p++ = d->res_heat;
+  *p++ = d->idac;
+  *p++ = d->gas_wait;
+  p = put_f32(p, d->temperature);
+  p = put_f32(p, d->pressure);
+  p = put_f32(p, d->humidity);
+  p = put_f32(p, d->gas_resistance);
+
+  *p++ = n;
+  for (uint8_t i = 0; i < n; i++) {
+    const bsec_data_t *out = &outputs->output[i];
+    *p++ = out->sensor_id;
+    *p++ = out->accuracy;
+    p = put_f32(p, out->signal);
+  }
+
+  buf[0] = (uint8_t)(p - buf - 1);
+  return (size_t)(p - buf);
+}
+
+bool bsec_record_reader_init(bsec_record_reader_t *r, const uint8_t *buf,
+                             size_t len) {
+  if (len < BSEC_RECORD_HEADER_LEN || memcmp(buf, RECORD_MAGIC, 4) != 0 ||
+      buf[4] != RECORD_VERSION)
+    return false;
+
+  *r = (bsec_record_reader_t){
+      .buf = buf, .len = len, .pos = BSEC_RECORD_HEADER_LEN};
+  return true;
+}
+
+// Decodes the body of one record of `len` bytes
+static bool decode(const uint8_t *p, size_t len, int64_t *prev,
+                   bsec_record_frame_t *out) {
+  const uint8_t *end = p + len;
+  uint64_t dt = 0;
+
+  for (int shift = 0;; shift += 7) {
+    if (p == end || shift >= 7 * RECORD_VARINT_MAX)
+      return false;
+    dt |= (uint64_t)(*p & 0x7f) << shift;
+    if ((*p++ & 0x80) == 0)
+      break;
+  }
+  if (end - p < RECORD_DATA_LEN + 1)
+    return false;
+
+  bme68x_data_t *d = &out->data;
+  *d = (bme68x_data_t){0};
+  d->status = *p++;
+  d->gas_index = *p++;
+  d->meas_index = *p++;
+  d->res_heat = *p++;
+  d->idac = *p++;
+  d->gas_wait = *p++;
+  p = get_f32(p, &d->temperature);
+  p = get_f32(p, &d->pressure);
+  p = get_f32(p, &d->humidity);
+  p = get_f32(p, &d->gas_resistance);
+
+  const uint8_t n = *p++;
+  if (n > BSEC_NUMBER_OUTPUTS || end - p != n * RECORD_OUTPUT_LEN)
+    return false;
+
+  *prev += (int64_t)dt;
+  out->timestamp_us = *prev;
+  out->outputs.n_outputs = n;
+  for (uint8_t i = 0; i < n; i++) {
+    bsec_data_t *o = &out->outputs.output[i];
+    *o = (bsec_data_t){.time_stamp = out->timestamp_us * 1000,
+                       .signal_dimensions = 1};
+    o->sensor_id = *p++;
+    o->accuracy = *p++;
+    p = get_f32(p, &o->signal);
+  }
+  return true;
+}
+
+bool bsec_record_next(bsec_record_reader_t *r, bsec_record_frame_t *out) {
+  if (r->pos >= r->len || r->buf[r->pos] == RECORD_END)
+    return false;
+
+  const size_t len = r->buf[r->pos];
+  if (r->pos + 1 + len > r->len ||
+      !decode(r->buf + r->pos + 1, len, &r->prev_us, out))
+    return false;
+
+  r->pos += 1 + len;
+  return true;
+}
+
+static bool write_to_sink(const void *data, size_t len) {
+  if (sink == NULL || !sink(data, len, sink_ctx)) {
+    if (sink)
+      LOG_DEFER_W(TAG, "Recording stopped after %lu frames",
+                  (unsigned long)stats.frames);
+    sink = NULL;
+    sink_failed = true;
+    return false;
+  }
+  stats.bytes += len;
+  return true;
+}
+
+bool bsec_record_start(bsec_record_sink_t new_sink, void *ctx) {
+  uint8_t header[BSEC_RECORD_HEADER_LEN];
+
+  if (new_sink == NULL)
+    return false;
+
+  sink = new_sink;
+  sink_ctx = ctx;
+  sink_failed = false;
+  prev_us = 0;
+  bsec_record_header(header);
+  return write_to_sink(header, sizeof(header));
+}
+
+void bsec_record_stop(void) { sink = NULL; }
+
+void bsec_record_frame(int64_t time_us, const bme68x_data_t *data,
+                       const bsec_outputs_t *outputs) {
+  uint8_t buf[BSEC_RECORD_MAX_LEN];
+
+  if (sink == NULL) {
+    if (sink_failed)
+      stats.dropped++;
+    return;
+  }
+
+  const size_t len = bsec_record_encode(buf, &prev_us, time_us, data, outputs);
+  if (write_to_sink(buf, len))
+    stats.frames++;
+  else
+    stats.dropped++;
+}
+
+// Sectors are erased as the recording enters them, so everything past its
+// end is erased and reads as RECORD_END
+static bool partition_sink(const void *data, size_t len, void *ctx) {
+  if (partition_pos + len > partition->size)
+    return false;
+
+  const size_t end = partition_pos + len;
+  size_t sector = (partition_pos + RECORD_SECTOR_SIZE - 1) /
+                  RECORD_SECTOR_SIZE * RECORD_SECTOR_SIZE;
+  for (; sector < end; sector += RECORD_SECTOR_SIZE)
+    if (esp_partition_erase_range(partition, sector, RECORD_SECTOR_SIZE) !=
+        ESP_OK)
+      return false;
+
+  if (esp_partition_write(partition, partition_pos, data, len) != ESP_OK)
+    return false;
+  partition_pos = end;
+  return true;
+}
+
+typedef enum {
+  PARTITION_BLANK, // no recording yet
+  PARTITION_RECORDING,
+  PARTITION_TORN, // a record was cut short by a power loss
+} partition_content_t;
+
+// Walks the recording already on the partition; its end is where the next
+// frame goes
+static partition_content_t find_partition_end(uint32_t *frames) {
+  uint8_t buf[BSEC_RECORD_MAX_LEN];
+  bsec_record_frame_t frame;
+  int64_t t = 0;
+
+  if (esp_partition_read(partition, 0, buf, BSEC_RECORD_HEADER_LEN) !=
+          ESP_OK ||
+      memcmp(buf, RECORD_MAGIC, 4) != 0 || buf[4] != RECORD_VERSION)
+    return PARTITION_BLANK;
+
+  size_t pos = BSEC_RECORD_HEADER_LEN;
+  *frames = 0;
+  while (pos < partition->size) {
+    if (esp_partition_read(partition, pos, buf, 1) != ESP_OK ||
+        buf[0] == RECORD_END)
+      break;
+
+    const size_t len = buf[0];
+    if (pos + 1 + len > partition->size ||
+        esp_partition_read(partition, pos + 1, buf, len) != ESP_OK ||
+        !decode(buf, len, &t, &frame))
+      return PARTITION_TORN;
+
+    pos += 1 + len;
+    (*frames)++;
+  }
+
+  partition_pos = pos;
+  return PARTITION_RECORDING;
+}
+
+bool bsec_record_start_partition(void) {
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                       ESP_PARTITION_SUBTYPE_ANY,
+                                       RECORD_PARTITION_LABEL);
+  if (partition == NULL) {
+    ESP_LOGE(TAG, "No \"%s\" partition", RECORD_PARTITION_LABEL);
+    return false;
+  }
+
+  uint32_t frames = 0;
+  switch (find_partition_end(&frames)) {
+  case PARTITION_BLANK:
+    partition_pos = 0;
+    ESP_LOGI(TAG, "New recording");
+    return bsec_record_start(partition_sink, NULL);
+
+  case PARTITION_TORN:
+    // The bytes after a torn record are not erased, so nothing can be
+    // appended; the frames before it still replay
+    ESP_LOGE(TAG, "Recording ends in a torn record after %lu frames; erase "
+                  "the partition to start a new one",
+             (unsigned long)frames);
+    return false;
+
+  case PARTITION_RECORDING:
+    ESP_LOGI(TAG, "Appending to %lu frames (%lu of %lu bytes)",
+             (unsigned long)frames, (unsigned long)partition_pos,
+             (unsigned long)partition->size);
+    sink = partition_sink;
+    sink_ctx = NULL;
+    sink_failed = false;
+    prev_us = 0;
+    break;
+  }
+  return true;
+}
+
+void bsec_record_get_stats(bsec_record_stats_t *out) {
+  if (out)
+    *out = stats;
+}
@@ -0,0 +1,81 @@
+#ifndef BSEC_RECORD_H
+#define BSEC_RECORD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bsec2.h"
+
+// Recordings of what the BME680 driver hands to its pipeline: the raw
+// bme68x frame and the BSEC outputs of every on_read_data call, with the
+// esp_timer time of the call. A recording replays through the same path
+// (bme680_replay_driver), so the history, the log, the UI and any other
+// sample bus subscriber see exactly the recorded sequence.
+//
+// Layout, little endian: an 8-byte header ("BREC", version, 3 reserved),
+// then one record per frame:
+//
+//   u8      length of the rest of the record; 0xff ends the recording,
+//           as erased flash does
+//   varint  microseconds since the previous frame (LEB128)
+//   22 B    bme68x_data_t: six u8 fields, then temperature, pressure,
+//           humidity and gas resistance as f32
+//   u8      output count, then per output u8 sensor id, u8 accuracy and
+//           f32 signal
+//
+// Output time stamps are the frame time and are not stored. A frame with
+// six outputs takes about 64 bytes.
+
+#define BSEC_RECORD_HEADER_LEN 8
+#define BSEC_RECORD_MAX_LEN 255 // one record, length byte included
+
+typedef struct {
+  int64_t timestamp_us;
+  bme68x_data_t data;
+  bsec_outputs_t outputs;
+} bsec_record_frame_t;
+
+typedef struct {
+  const uint8_t *buf;
+  size_t len;
+  size_t pos;
+  int64_t prev_us;
+} bsec_record_reader_t;
+
+// Receives the bytes of the recording in order; false stops recording
+typedef bool (*bsec_record_sink_t)(const void *data, size_t len, void *ctx);
+
+typedef struct {
+  uint32_t frames;
+  uint64_t bytes;
+  uint32_t dropped; // after the sink failed or the partition filled up
+} bsec_record_stats_t;
+
+void bsec_record_header(uint8_t *buf);
+// Encodes a frame into `buf`, which must hold BSEC_RECORD_MAX_LEN bytes.
+// `prev_us` carries the time of the previous frame. Returns the length.
+size_t bsec_record_encode(uint8_t *buf, int64_t *prev_us, int64_t time_us,
+                          const bme68x_data_t *data,
+                          const bsec_outputs_t *outputs);
+
+// False if `buf` does not start with a recording header
+bool bsec_record_reader_init(bsec_record_reader_t *r, const uint8_t *buf,
+                             size_t len);
+// False at the end of the recording or at a damaged record
+bool bsec_record_next(bsec_record_reader_t *r, bsec_record_frame_t *out);
+
+// Records every frame from now on into `sink`, header first
+bool bsec_record_start(bsec_record_sink_t sink, void *ctx);
+// Appends to the recording on the "bsecrec" partition, or starts one.
+// Time runs on across reboots; each shows as a gap of the boot time.
+bool bsec_record_start_partition(void);
+void bsec_record_stop(void);
+
+// Called by the driver for every delivered frame; nothing when stopped
+void bsec_record_frame(int64_t time_us, const bme68x_data_t *data,
+                       const bsec_outputs_t *outputs);
+
+void bsec_record_get_stats(bsec_record_stats_t *out);
+
+#endif
@@ -0,0 +1,108 @@
+#include "bsec_state.h"
+
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "log_defer.h"
+#include "nvs.h"
+#include <stddef.h>
+#include <string.h>
+
+#include "bsec_datatypes.h"
+
+static const char *TAG = "BSEC_STATE";
+
+#define BSEC_STATE_NAMESPACE "bsec"
+#define BSEC_STATE_KEY "state"
+#define BSEC_STATE_MAGIC 0x42534543 // "BSEC"
+#define BSEC_STATE_VERSION 1
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t len;
+  uint32_t config_crc;
+  uint32_t crc; // over all fields above and data[0..len)
+  uint8_t data[BSEC_MAX_STATE_BLOB_SIZE];
+} bsec_state_blob_t;
+
+static uint32_t blob_crc(const bsec_state_blob_t *blob) {
+  uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)blob,
+                                  offsetof(bsec_state_blob_t, crc));
+  return esp_rom_crc32_le(crc, blob->data, blob->len);
+}
+
+bool bsec_state_load(uint8_t *state, size_t len, const uint8_t *config,
+                     size_t config_len) {
+  nvs_handle_t nvs;
+  if (nvs_open(BSEC_STATE_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+    LOG_DEFER_I(TAG, "No saved state");
+    return false;
+  }
+
+  bsec_state_blob_t blob;
+  size_t blob_len = sizeof(blob);
+  esp_err_t err = nvs_get_blob(nvs, BSEC_STATE_KEY, &blob, &blob_len);
+  nvs_close(nvs);
+
+  if (err != ESP_OK) {
+    LOG_DEFER_I(TAG, "No saved state (%s)", esp_err_to_name(err));
+    return false;
+  }
+
+  if (blob_len < offsetof(bsec_state_blob_t, data) ||
+      blob.magic != BSEC_STATE_MAGIC || blob.version != BSEC_STATE_VERSION) {
+    LOG_DEFER_W(TAG, "Saved state has an unknown format");
+    return false;
+  }
+
+  if (blob.len > len || blob.len > sizeof(blob.data) ||
+      blob_len != offsetof(bsec_state_blob_t, data) + blob.len ||
+      blob.crc != blob_crc(&blob)) {
+    LOG_DEFER_W(TAG, "Saved state is corrupt");
+    return false;
+  }
+
+  if (blob.config_crc != esp_rom_crc32_le(0, config, config_len)) {
+    LOG_DEFER_W(TAG, "Saved state belongs to another BSEC config");
+    return false;
+  }
+
+  memcpy(state, blob.data, blob.len);
+  return true;
+}
+
+bool bsec_state_save(const uint8_t *state, size_t len, const uint8_t *config,
+                     size_t config_len) {
+  bsec_state_blob_t blob = {
+      .magic = BSEC_STATE_MAGIC,
+      .version = BSEC_STATE_VERSION,
+      .len = (uint16_t)len,
+      .config_crc = esp_rom_crc32_le(0, config, config_len),
+  };
+
+  if (len > sizeof(blob.data))
+    return false;
+
+  memcpy(blob.data, state, len);
+  blob.crc = blob_crc(&blob);
+
+  nvs_handle_t nvs;
+  esp_err_t err = nvs_open(BSEC_STATE_NAMESPACE, NVS_READWRITE, &nvs);
+  if (err != ESP_OK) {
+    LOG_DEFER_E(TAG, "NVS open failed: %s", esp_err_to_name(err));
+    return false;
+  }
+
+  err = nvs_set_blob(nvs, BSEC_STATE_KEY, &blob,
+                     offsetof(bsec_state_blob_t, data) + len);
+  if (err == ESP_OK)
+    err = nvs_commit(nvs);
+  nvs_close(nvs);
+
+  if (err != ESP_OK) {
+    LOG_DEFER_E(TAG, "Saving state failed: %s", esp_err_to_name(err));
+    return false;
+  }
+
+  return true;
+}
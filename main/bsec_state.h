@@ -0,0 +1,17 @@
+#ifndef BSEC_STATE_H
+#define BSEC_STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// BSEC calibration state persisted in NVS. The blob is wrapped with a format
+// version, the CRC of the BSEC config it was produced with and a CRC over
+// everything, so a stale or corrupt state is rejected instead of loaded.
+
+bool bsec_state_load(uint8_t *state, size_t len, const uint8_t *config,
+                     size_t config_len);
+bool bsec_state_save(const uint8_t *state, size_t len, const uint8_t *config,
+                     size_t config_len);
+
+#endif
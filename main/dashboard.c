@@ -4,59 +4,79 @@
 #include "esp_lvgl_port.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <stdio.h>
+#include <stdatomic.h>
 #include <time.h>
 
+#include "sdkconfig.h"
+
+#include "battery.h"
 #include "lcd.h"
+#include "lcd_bench.h"
+#include "sample_bus.h"
 #include "sensors_bme680.h"
 #include "ui.h"
+#include "ui_fmt.h"
 
 static const char *TAG = "DASHBOARD";
 
-static void update_time(ui_state_t *ui) {
-  time_t now;
-  struct tm timeinfo;
-  char time_buff[16];
+#define DASHBOARD_CHANNELS                                                     \
+  (SAMPLE_MASK(SAMPLE_CH_IAQ) | SAMPLE_MASK(SAMPLE_CH_TEMP) |                  \
+   SAMPLE_MASK(SAMPLE_CH_PRESSURE) | SAMPLE_MASK(SAMPLE_CH_HUMIDITY) |         \
+   SAMPLE_MASK(SAMPLE_CH_CO2_EQ) | SAMPLE_MASK(SAMPLE_CH_CO2))
 
-  time(&now);
-  localtime_r(&now, &timeinfo);
+static EventGroupHandle_t dashboard_events;
 
-  snprintf(time_buff, sizeof(time_buff), "%02d:%02d", timeinfo.tm_hour,
-           timeinfo.tm_min);
+// Channels published since the dashboard task last copied them; all at first,
+// for samples published before the dashboard subscribed
+static atomic_uint_fast32_t changed_channels = DASHBOARD_CHANNELS;
+static sample_t samples[SAMPLE_CH_COUNT];
+
+static void update_time(ui_state_t *ui, const struct tm *timeinfo) {
+  char time_buff[16];
+
+  ui_fmt_time(time_buff, sizeof(time_buff), timeinfo->tm_hour,
+              timeinfo->tm_min);
 
   ui_clock_update(ui, time_buff);
 }
 
-static void update_date(ui_state_t *ui) {
-  time_t now;
-  struct tm timeinfo;
+static void update_date(ui_state_t *ui, const struct tm *timeinfo) {
   char date_buff[32];
 
-  time(&now);
-  localtime_r(&now, &timeinfo);
+  ui_fmt_date(date_buff, sizeof(date_buff), timeinfo->tm_wday,
+              timeinfo->tm_mday, timeinfo->tm_mon);
 
-  static const char *week_days[] = {"Sun", "Mon", "Tue", "Wed",
-                                    "Thu", "Fri", "Sat"};
+  ui_date_update(ui, date_buff);
+}
 
-  static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
-                                 "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+static void update_battery(ui_state_t *ui) {
+  battery_state_t battery;
 
-  snprintf(date_buff, sizeof(date_buff), "%s, %02d %s",
-           week_days[timeinfo.tm_wday], timeinfo.tm_mday,
-           months[timeinfo.tm_mon]);
+  // Keeps the placeholder until the first measurement
+  if (battery_get(&battery))
+    ui_battery_update(ui, battery.percent, battery.charging);
+}
 
-  ui_date_update(ui, date_buff);
+// Runs in the sensor bus task; the copy is left to the dashboard task
+static void on_samples(sample_mask_t updated, void *ctx) {
+  atomic_fetch_or(&changed_channels, updated);
+  dashboard_notify(DASHBOARD_EVT_SENSOR);
 }
 
-static void update_battery(ui_state_t *ui) {
-  // TODO: Read real ADC value here
-  // float voltage = adc_read_voltage();
+static void update_sensors(ui_state_t *ui) {
+  sample_mask_t changed = atomic_exchange(&changed_channels, 0);
 
-  // Placeholder
-  int percent = 100;
-  bool charging = false;
+  // All from one publish, so the cards never mix two measurements. Keeps
+  // the placeholders until the first sample.
+  if (changed && sample_bus_read_set(changed, samples, NULL))
+    ui_sensors_update(ui, samples);
+}
+
+static void on_battery_change(void) { dashboard_notify(DASHBOARD_EVT_BATTERY); }
 
-  ui_battery_update(ui, percent, charging);
+// Ticks until just past the next minute boundary of the wall clock
+static TickType_t ticks_to_next_minute(time_t now) {
+  return pdMS_TO_TICKS((60 - now % 60) * 1000);
 }
 
 static void dashboard_task_loop(void *param) {
@@ -65,7 +85,20 @@ static void dashboard_task_loop(void *param) {
   lv_display_t *disp_handle = NULL;
   esp_lcd_touch_handle_t touch_handle;
 
-  lcd_init(&disp_handle, &touch_handle);
+  if (lcd_display_init(&disp_handle) != ESP_OK) {
+    ESP_LOGE(TAG, "Display init failed, task stopped");
+    vTaskDelete(NULL);
+    return;
+  }
+
+#if CONFIG_LCD_BENCHMARK
+  lcd_bench_run(&disp_handle);
+  if (disp_handle == NULL) {
+    ESP_LOGE(TAG, "No display after benchmark, task stopped");
+    vTaskDelete(NULL);
+    return;
+  }
+#endif
 
   ui_state_t ui_state;
 
@@ -76,26 +109,71 @@ static void dashboard_task_loop(void *param) {
     ESP_LOGE(TAG, "Failed to lock LVGL for setup");
   }
 
-  bme680_state_t sensor_data;
+  // Keeps running dark: the boot report will show the missing phase
+  if (lcd_display_on(disp_handle) != ESP_OK)
+    ESP_LOGE(TAG, "Display did not turn on");
+
+  // Touch is only needed once something is on screen
+  if (lcd_touch_init(disp_handle, &touch_handle) != ESP_OK)
+    ESP_LOGE(TAG, "Touch init failed, continuing without touch");
+
+  sample_bus_subscribe("dashboard", DASHBOARD_CHANNELS, on_samples, NULL);
+  battery_set_change_callback(on_battery_change);
+
+  // Draw everything once, then only what the events say has changed
+  EventBits_t pending = DASHBOARD_EVT_ALL;
+  int last_minute = -1;
+  int last_yday = -1;
 
   while (true) {
-    bme680_get_data(&sensor_data);
+    time_t now;
+    struct tm timeinfo;
+
+    time(&now);
+    localtime_r(&now, &timeinfo);
 
     if (lvgl_port_lock(0)) {
-      ui_sensors_update(&ui_state, &sensor_data);
+      if (pending & DASHBOARD_EVT_SENSOR)
+        update_sensors(&ui_state);
+
+      if (pending & (DASHBOARD_EVT_SENSOR | DASHBOARD_EVT_MODE))
+        ui_sampling_mode_update(&ui_state, bme680_get_mode());
 
-      update_time(&ui_state);
-      update_date(&ui_state);
+      if (timeinfo.tm_min != last_minute) {
+        update_time(&ui_state, &timeinfo);
+        last_minute = timeinfo.tm_min;
+      }
+
+      if (timeinfo.tm_yday != last_yday) {
+        update_date(&ui_state, &timeinfo);
+        last_yday = timeinfo.tm_yday;
+      }
+
+      if (pending & DASHBOARD_EVT_BATTERY)
+        update_battery(&ui_state);
 
-      update_battery(&ui_state);
       lvgl_port_unlock();
+      pending = 0;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    pending |= xEventGroupWaitBits(dashboard_events, DASHBOARD_EVT_ALL, pdTRUE,
+                                   pdFALSE, ticks_to_next_minute(now)) &
+               DASHBOARD_EVT_ALL;
   }
 }
 
+void dashboard_notify(EventBits_t events) {
+  if (dashboard_events)
+    xEventGroupSetBits(dashboard_events, events);
+}
+
 bool dashboard_app_start(void) {
+  dashboard_events = xEventGroupCreate();
+  if (dashboard_events == NULL) {
+    ESP_LOGE(TAG, "Failed to create dashboard events");
+    return false;
+  }
+
   BaseType_t res = xTaskCreate(dashboard_task_loop, "dashboard", 4096, NULL,
                                tskIDLE_PRIORITY + 1, NULL);
 
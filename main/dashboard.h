@@ -3,6 +3,22 @@
 
 #include <stdbool.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+// Events that wake the dashboard task. Clock and date are refreshed on the
+// minute boundary, which the task derives from its wait timeout; the battery
+// label only when the battery module reports a new displayed state. The
+// sampling mode label follows a tap on the air quality card, and every
+// sample in case BSEC turned the new mode down.
+#define DASHBOARD_EVT_SENSOR (1 << 0)
+#define DASHBOARD_EVT_BATTERY (1 << 1)
+#define DASHBOARD_EVT_MODE (1 << 2)
+#define DASHBOARD_EVT_ALL                                                      \
+  (DASHBOARD_EVT_SENSOR | DASHBOARD_EVT_BATTERY | DASHBOARD_EVT_MODE)
+
 bool dashboard_app_start(void);
 
+void dashboard_notify(EventBits_t events);
+
 #endif
@@ -0,0 +1,212 @@
+#include "diagnostics.h"
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "i2c_trace.h"
+#include "log_defer.h"
+#include "lcd_touch.h"
+#include "power_policy.h"
+#include "sdkconfig.h"
+#include "sensors_bme680.h"
+#include "telemetry.h"
+#include <stdio.h>
+
+static const char *TAG = "DIAG";
+
+// Run-time counters of the previous sample, matched by task number
+typedef struct {
+  UBaseType_t number;
+  uint32_t counter;
+} prev_counter_t;
+
+static diag_snapshot_t snapshot;
+static bool have_snapshot;
+static SemaphoreHandle_t snapshot_mutex;
+
+static prev_counter_t prev[DIAG_MAX_TASKS];
+static size_t prev_count;
+static uint32_t prev_total;
+
+static uint32_t prev_counter(UBaseType_t number) {
+  for (size_t i = 0; i < prev_count; i++)
+    if (prev[i].number == number)
+      return prev[i].counter;
+  return 0;
+}
+
+static void sample_tasks(diag_snapshot_t *s) {
+  static TaskStatus_t status[DIAG_MAX_TASKS];
+  uint32_t total = 0;
+
+  // Fills nothing when there are more tasks than slots
+  UBaseType_t n = uxTaskGetSystemState(status, DIAG_MAX_TASKS, &total);
+  if (n == 0)
+    ESP_LOGW(TAG, "More than %d tasks, CPU stats skipped", DIAG_MAX_TASKS);
+  // Unsigned deltas stay correct across one counter wrap
+  const uint32_t elapsed = total - prev_total;
+
+  s->task_count = n;
+  for (UBaseType_t i = 0; i < n; i++) {
+    const TaskStatus_t *t = &status[i];
+    diag_task_t *out = &s->tasks[i];
+    uint32_t delta = t->ulRunTimeCounter - prev_counter(t->xTaskNumber);
+
+    snprintf(out->name, sizeof(out->name), "%s", t->pcTaskName);
+    out->priority = t->uxCurrentPriority;
+    out->cpu_pct = elapsed ? (uint8_t)((uint64_t)delta * 100 / elapsed) : 0;
+    out->stack_free = t->usStackHighWaterMark;
+  }
+
+  for (UBaseType_t i = 0; i < n; i++) {
+    prev[i].number = status[i].xTaskNumber;
+    prev[i].counter = status[i].ulRunTimeCounter;
+  }
+  prev_count = n;
+  prev_total = total;
+}
+
+static void sample_heap(diag_heap_t *h) {
+  const uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+
+  h->free = heap_caps_get_free_size(caps);
+  h->min_free = heap_caps_get_minimum_free_size(caps);
+  h->largest = heap_caps_get_largest_free_block(caps);
+  if (h->min_largest == 0 || h->largest < h->min_largest)
+    h->min_largest = h->largest;
+  h->frag_pct = h->free ? 100 - (uint8_t)((uint64_t)h->largest * 100 / h->free)
+                        : 0;
+}
+
+static void sample_lvgl(diag_snapshot_t *s) {
+  // Skipped, keeping the previous values, while LVGL is busy
+  if (!lvgl_port_lock(100))
+    return;
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  lvgl_port_unlock();
+
+  s->lvgl_total = mon.total_size;
+  s->lvgl_used = mon.total_size - mon.free_size;
+  s->lvgl_largest = mon.free_biggest_size;
+  s->lvgl_frag_pct = mon.frag_pct;
+}
+
+static void diagnostics_task(void *param) {
+  const int64_t report_period_us =
+      (int64_t)CONFIG_DIAG_REPORT_PERIOD_S * 1000000;
+  int64_t last_report_us = esp_timer_get_time();
+  diag_snapshot_t s = {0};
+
+  while (true) {
+    vTaskDelay(pdMS_TO_TICKS(DIAG_SAMPLE_PERIOD_MS));
+
+    s.uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    sample_tasks(&s);
+    sample_heap(&s.heap);
+    sample_lvgl(&s);
+
+    xSemaphoreTake(snapshot_mutex, portMAX_DELAY);
+    snapshot = s;
+    have_snapshot = true;
+    xSemaphoreGive(snapshot_mutex);
+
+    if (report_period_us > 0 &&
+        esp_timer_get_time() - last_report_us >= report_period_us) {
+      last_report_us = esp_timer_get_time();
+      diagnostics_log_report();
+      power_policy_log_report();
+      i2c_trace_log_report();
+    }
+  }
+}
+
+bool diagnostics_get(diag_snapshot_t *out) {
+  if (out == NULL || snapshot_mutex == NULL)
+    return false;
+
+  xSemaphoreTake(snapshot_mutex, portMAX_DELAY);
+  bool ok = have_snapshot;
+  if (ok)
+    *out = snapshot;
+  xSemaphoreGive(snapshot_mutex);
+
+  return ok;
+}
+
+void diagnostics_log_report(void) {
+  static diag_snapshot_t s;
+  if (!diagnostics_get(&s))
+    return;
+
+  ESP_LOGI(TAG, "uptime %lu s", (unsigned long)s.uptime_s);
+  ESP_LOGI(TAG, "heap: %lu free (min %lu), largest %lu (min %lu), frag %u%%",
+           (unsigned long)s.heap.free, (unsigned long)s.heap.min_free,
+           (unsigned long)s.heap.largest, (unsigned long)s.heap.min_largest,
+           s.heap.frag_pct);
+  ESP_LOGI(TAG, "lvgl: %lu/%lu used, largest %lu, frag %u%%",
+           (unsigned long)s.lvgl_used, (unsigned long)s.lvgl_total,
+           (unsigned long)s.lvgl_largest, s.lvgl_frag_pct);
+  lcd_touch_stats_t touch;
+  lcd_touch_get_stats(&touch);
+  ESP_LOGI(TAG, "touch: %lu SPI transactions/h, %lu reads, %lu wakeups",
+           (unsigned long)lcd_touch_transactions_per_hour(&touch),
+           (unsigned long)touch.reads, (unsigned long)touch.wakeups);
+  bme680_stats_t bsec;
+  bme680_get_stats(&bsec);
+  if (bsec.bsec_runs > 0)
+    ESP_LOGI(TAG, "bsec2_run: %lu measuring calls, avg %lu us (max %lu), "
+                  "%lu%% on the wire",
+             (unsigned long)bsec.bsec_runs,
+             (unsigned long)(bsec.bsec_run_us / bsec.bsec_runs),
+             (unsigned long)bsec.bsec_run_us_max,
+             (unsigned long)(bsec.bsec_wire_us * 100 / bsec.bsec_run_us));
+  for (int m = 0; m < BME680_MODE_COUNT; m++) {
+    const bme680_mode_stats_t *ms = &bsec.modes[m];
+    if (ms->time_us == 0)
+      continue;
+    ESP_LOGI(TAG, "bme680 %s%s: %lu s, %lu measurements, duty %.3f%%, "
+                  "budget %lu uA",
+             bme680_mode_name(m), m == (int)bsec.mode ? " (now)" : "",
+             (unsigned long)(ms->time_us / 1000000), (unsigned long)ms->runs,
+             (double)ms->run_us * 100.0 / (double)ms->time_us,
+             (unsigned long)bme680_mode_budget_ua(m, ms));
+  }
+  log_defer_stats_t dlog;
+  log_defer_get_stats(&dlog);
+  ESP_LOGI(TAG, "deferred log: %lu records, %lu dropped, peak %lu of %lu",
+           (unsigned long)dlog.written, (unsigned long)dlog.dropped,
+           (unsigned long)dlog.peak, (unsigned long)dlog.capacity);
+  telemetry_stats_t tel;
+  telemetry_get_stats(&tel);
+  if (tel.frames + tel.dropped > 0)
+    ESP_LOGI(TAG, "telemetry: %lu frames, %llu bytes, %lu dropped",
+             (unsigned long)tel.frames, (unsigned long long)tel.bytes,
+             (unsigned long)tel.dropped);
+  ESP_LOGI(TAG, "%-16s %4s %4s %10s", "task", "prio", "cpu", "stack free");
+  for (size_t i = 0; i < s.task_count; i++) {
+    const diag_task_t *t = &s.tasks[i];
+    ESP_LOGI(TAG, "%-16s %4u %3u%% %10lu", t->name, t->priority, t->cpu_pct,
+             (unsigned long)t->stack_free);
+  }
+}
+
+bool diagnostics_start(void) {
+  snapshot_mutex = xSemaphoreCreateMutex();
+  if (snapshot_mutex == NULL) {
+    ESP_LOGE(TAG, "Failed to create mutex");
+    return false;
+  }
+
+  if (xTaskCreate(diagnostics_task, "diag", 3072, NULL, tskIDLE_PRIORITY + 1,
+                  NULL) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start task");
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,51 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+// Periodic system health sampling: CPU share and stack high-water mark per
+// task, internal heap and its fragmentation, and the LVGL heap. The latest
+// sample is available to the UI; a summary is logged every
+// CONFIG_DIAG_REPORT_PERIOD_S.
+
+#define DIAG_MAX_TASKS 16
+#define DIAG_SAMPLE_PERIOD_MS 5000
+
+typedef struct {
+  char name[configMAX_TASK_NAME_LEN];
+  uint8_t priority;
+  uint8_t cpu_pct;     // share of the last sample period
+  uint32_t stack_free; // bytes never used since the task started
+} diag_task_t;
+
+typedef struct {
+  uint32_t free;
+  uint32_t min_free;    // lowest free since boot
+  uint32_t largest;     // largest allocatable block
+  uint32_t min_largest; // lowest largest block seen by the sampler
+  uint8_t frag_pct;     // 100 - largest / free
+} diag_heap_t;
+
+typedef struct {
+  uint32_t uptime_s;
+  diag_task_t tasks[DIAG_MAX_TASKS];
+  size_t task_count;
+  diag_heap_t heap; // internal RAM
+  uint32_t lvgl_used;
+  uint32_t lvgl_total;
+  uint32_t lvgl_largest;
+  uint8_t lvgl_frag_pct;
+} diag_snapshot_t;
+
+bool diagnostics_start(void);
+
+// Copies the latest sample; false until the first one is taken
+bool diagnostics_get(diag_snapshot_t *out);
+
+void diagnostics_log_report(void);
+
+#endif
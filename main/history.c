@@ -0,0 +1,257 @@
+#include "history.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "log_defer.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "HISTORY";
+
+#define HISTORY_BUDGET_BYTES (40 * 1024)
+
+// Writer waits at most this long for a reader copying a ring
+#define HISTORY_LOCK_TIMEOUT_MS 20
+
+typedef struct {
+  int32_t sum[HISTORY_CH_COUNT];
+  int16_t min[HISTORY_CH_COUNT];
+  int16_t max[HISTORY_CH_COUNT];
+  uint32_t start_s;
+  uint16_t count;
+  uint8_t accuracy;
+} history_acc_t;
+
+typedef struct {
+  history_agg_t *ring;
+  size_t len;
+  size_t head; // next slot to write
+  size_t count;
+  uint32_t period_s;
+  history_acc_t acc;
+} history_tier_state_t;
+
+static history_raw_t raw_ring[HISTORY_RAW_LEN];
+static size_t raw_head;
+static size_t raw_count;
+static uint32_t raw_newest_s;
+
+static history_agg_t ring_5min[HISTORY_5MIN_LEN];
+static history_agg_t ring_1h[HISTORY_1H_LEN];
+
+static history_tier_state_t tiers[HISTORY_TIER_COUNT] = {
+    [HISTORY_TIER_5MIN] = {.ring = ring_5min,
+                           .len = HISTORY_5MIN_LEN,
+                           .period_s = HISTORY_5MIN_PERIOD_S},
+    [HISTORY_TIER_1H] = {.ring = ring_1h,
+                         .len = HISTORY_1H_LEN,
+                         .period_s = HISTORY_1H_PERIOD_S},
+};
+
+static SemaphoreHandle_t history_mutex;
+
+static_assert(sizeof(raw_ring) + sizeof(ring_5min) + sizeof(ring_1h) <=
+                  HISTORY_BUDGET_BYTES,
+              "sensor history exceeds its RAM budget");
+
+// Units per stored LSB, indexed by history_channel_t
+static const float channel_scale[HISTORY_CH_COUNT] = {
+    [HISTORY_CH_IAQ] = 10.0f,       [HISTORY_CH_TEMP] = 100.0f,
+    [HISTORY_CH_PRESSURE] = 0.1f,   [HISTORY_CH_HUMIDITY] = 100.0f,
+    [HISTORY_CH_GAS] = 100.0f,      [HISTORY_CH_CO2] = 1.0f,
+};
+
+// Sample bus channel each history channel is recorded from
+static const sample_channel_t channel_source[HISTORY_CH_COUNT] = {
+    [HISTORY_CH_IAQ] = SAMPLE_CH_IAQ,
+    [HISTORY_CH_TEMP] = SAMPLE_CH_TEMP,
+    [HISTORY_CH_PRESSURE] = SAMPLE_CH_PRESSURE,
+    [HISTORY_CH_HUMIDITY] = SAMPLE_CH_HUMIDITY,
+    [HISTORY_CH_GAS] = SAMPLE_CH_GAS,
+    [HISTORY_CH_CO2] = SAMPLE_CH_CO2_EQ,
+};
+
+int16_t history_scale(history_channel_t ch, float value) {
+  float scaled = roundf(value * channel_scale[ch]);
+
+  if (scaled > INT16_MAX)
+    return INT16_MAX;
+  if (scaled < INT16_MIN)
+    return INT16_MIN;
+  return (int16_t)scaled;
+}
+
+float history_unscale(history_channel_t ch, int16_t value) {
+  return (float)value / channel_scale[ch];
+}
+
+static void acc_reset(history_acc_t *acc, uint32_t start_s) {
+  memset(acc, 0, sizeof(*acc));
+  acc->start_s = start_s;
+}
+
+static void acc_add(history_acc_t *acc, const int16_t *min,
+                    const int16_t *avg, const int16_t *max, uint16_t count,
+                    uint8_t accuracy) {
+  for (int ch = 0; ch < HISTORY_CH_COUNT; ch++) {
+    if (acc->count == 0 || min[ch] < acc->min[ch])
+      acc->min[ch] = min[ch];
+    if (acc->count == 0 || max[ch] > acc->max[ch])
+      acc->max[ch] = max[ch];
+    acc->sum[ch] += (int32_t)avg[ch] * count;
+  }
+
+  if (acc->count == 0 || accuracy < acc->accuracy)
+    acc->accuracy = accuracy;
+  acc->count += count;
+}
+
+static void acc_finish(const history_acc_t *acc, history_agg_t *out) {
+  out->start_s = acc->start_s;
+  out->count = acc->count;
+  out->accuracy = acc->accuracy;
+
+  for (int ch = 0; ch < HISTORY_CH_COUNT; ch++) {
+    out->min[ch] = acc->min[ch];
+    out->max[ch] = acc->max[ch];
+    out->avg[ch] = (int16_t)(acc->sum[ch] / acc->count);
+  }
+}
+
+static void tier_add(history_tier_t tier, uint32_t time_s, const int16_t *min,
+                     const int16_t *avg, const int16_t *max, uint16_t count,
+                     uint8_t accuracy) {
+  history_tier_state_t *t = &tiers[tier];
+  uint32_t bucket_s = time_s - time_s % t->period_s;
+
+  if (t->acc.count > 0 && bucket_s != t->acc.start_s) {
+    history_agg_t *slot = &t->ring[t->head];
+    acc_finish(&t->acc, slot);
+
+    t->head = (t->head + 1) % t->len;
+    if (t->count < t->len)
+      t->count++;
+
+    // Cascade the finished bucket into the next coarser tier
+    if (tier + 1 < HISTORY_TIER_COUNT)
+      tier_add(tier + 1, slot->start_s, slot->min, slot->avg, slot->max,
+               slot->count, slot->accuracy);
+  }
+
+  if (t->acc.count == 0 || bucket_s != t->acc.start_s)
+    acc_reset(&t->acc, bucket_s);
+
+  acc_add(&t->acc, min, avg, max, count, accuracy);
+}
+
+void history_row_from_bus(sample_mask_t updated, history_row_t *out) {
+  sample_t copies[SAMPLE_CH_COUNT];
+  const sample_mask_t others = HISTORY_SAMPLE_CHANNELS & ~updated;
+
+  if (others)
+    sample_bus_read_set(others, copies, NULL);
+  out->timestamp_us = 0;
+
+  for (int ch = 0; ch < HISTORY_CH_COUNT; ch++) {
+    const sample_channel_t src = channel_source[ch];
+    const sample_t *sample = updated & SAMPLE_MASK(src)
+                                 ? sample_bus_peek(src)
+                                 : &copies[src];
+
+    out->v[ch] = history_scale(ch, sample->value);
+    if (ch == HISTORY_CH_IAQ)
+      out->accuracy = sample->accuracy;
+    if (sample->timestamp_us > out->timestamp_us)
+      out->timestamp_us = sample->timestamp_us;
+  }
+}
+
+static void on_samples(sample_mask_t updated, void *ctx) {
+  history_row_t row;
+  history_row_from_bus(updated, &row);
+
+  const uint32_t time_s = (uint32_t)(row.timestamp_us / 1000000);
+
+  history_raw_t raw = {
+      .time_s = (uint16_t)time_s,
+      .accuracy = row.accuracy,
+  };
+  memcpy(raw.v, row.v, sizeof(raw.v));
+
+  if (xSemaphoreTake(history_mutex,
+                     pdMS_TO_TICKS(HISTORY_LOCK_TIMEOUT_MS)) != pdTRUE) {
+    LOG_DEFER_W(TAG, "Sample dropped, history busy");
+    return;
+  }
+
+  raw_ring[raw_head] = raw;
+  raw_head = (raw_head + 1) % HISTORY_RAW_LEN;
+  if (raw_count < HISTORY_RAW_LEN)
+    raw_count++;
+  raw_newest_s = time_s;
+
+  tier_add(HISTORY_TIER_5MIN, time_s, raw.v, raw.v, raw.v, 1, raw.accuracy);
+
+  xSemaphoreGive(history_mutex);
+}
+
+bool history_init(void) {
+  history_mutex = xSemaphoreCreateMutex();
+  if (history_mutex == NULL)
+    return false;
+
+  if (!sample_bus_subscribe("history", HISTORY_SAMPLE_CHANNELS, on_samples,
+                            NULL))
+    return false;
+
+  ESP_LOGI(TAG, "%u bytes reserved", (unsigned)history_memory_bytes());
+  return true;
+}
+
+// Copies the newest `n` entries of a ring ending at `head` in order
+static void copy_ring(void *out, const void *ring, size_t elem, size_t len,
+                      size_t head, size_t n) {
+  size_t start = (head + len - n) % len;
+  size_t first = n < len - start ? n : len - start;
+
+  memcpy(out, (const uint8_t *)ring + start * elem, first * elem);
+  memcpy((uint8_t *)out + first * elem, ring, (n - first) * elem);
+}
+
+size_t history_read_raw(history_raw_t *out, size_t max_count,
+                        uint32_t *out_newest_s) {
+  if (out == NULL || history_mutex == NULL)
+    return 0;
+
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+  size_t n = raw_count < max_count ? raw_count : max_count;
+  copy_ring(out, raw_ring, sizeof(*out), HISTORY_RAW_LEN, raw_head, n);
+  if (out_newest_s)
+    *out_newest_s = raw_newest_s;
+
+  xSemaphoreGive(history_mutex);
+  return n;
+}
+
+size_t history_read_agg(history_tier_t tier, history_agg_t *out,
+                        size_t max_count) {
+  if (out == NULL || tier >= HISTORY_TIER_COUNT || history_mutex == NULL)
+    return 0;
+
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+  const history_tier_state_t *t = &tiers[tier];
+  size_t n = t->count < max_count ? t->count : max_count;
+  copy_ring(out, t->ring, sizeof(*out), t->len, t->head, n);
+
+  xSemaphoreGive(history_mutex);
+  return n;
+}
+
+size_t history_memory_bytes(void) {
+  return sizeof(raw_ring) + sizeof(ring_5min) + sizeof(ring_1h) +
+         sizeof(tiers);
+}
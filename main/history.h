@@ -0,0 +1,93 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sample_bus.h"
+
+// In-RAM history of the BME680 channels in three tiers, all fixed-size
+// rings allocated statically:
+//
+//   raw      every sample (3 s in LP mode) for 1 hour   1200 x 16 B = 19.2 KB
+//   5 min    min/avg/max buckets for 24 hours            288 x 44 B = 12.7 KB
+//   1 hour   min/avg/max buckets for 7 days              168 x 44 B =  7.4 KB
+//
+// Values are stored as scaled int16 (see history_scale). Buckets are folded
+// incrementally: each sample updates a running accumulator and a finished
+// 5 min bucket is folded into the hourly accumulator, so recording a row (on
+// every sample bus publish, see history_init) is O(1) and never scans a ring.
+
+#define HISTORY_RAW_LEN 1200
+#define HISTORY_5MIN_LEN 288
+#define HISTORY_1H_LEN 168
+
+#define HISTORY_5MIN_PERIOD_S (5 * 60)
+#define HISTORY_1H_PERIOD_S (60 * 60)
+
+typedef enum {
+  HISTORY_CH_IAQ,      // 0.1 IAQ
+  HISTORY_CH_TEMP,     // 0.01 °C
+  HISTORY_CH_PRESSURE, // 10 Pa (0.1 hPa)
+  HISTORY_CH_HUMIDITY, // 0.01 %RH
+  HISTORY_CH_GAS,      // 0.01 %
+  HISTORY_CH_CO2,      // 1 ppm
+  HISTORY_CH_COUNT,
+} history_channel_t;
+
+// Sample bus channels recorded, one per history_channel_t
+#define HISTORY_SAMPLE_CHANNELS                                                \
+  (SAMPLE_MASK(SAMPLE_CH_IAQ) | SAMPLE_MASK(SAMPLE_CH_TEMP) |                  \
+   SAMPLE_MASK(SAMPLE_CH_PRESSURE) | SAMPLE_MASK(SAMPLE_CH_HUMIDITY) |         \
+   SAMPLE_MASK(SAMPLE_CH_GAS) | SAMPLE_MASK(SAMPLE_CH_CO2_EQ))
+
+// The history channels as last published, scaled
+typedef struct {
+  int16_t v[HISTORY_CH_COUNT];
+  uint8_t accuracy;     // of the IAQ channel
+  int64_t timestamp_us; // newest of the channels
+} history_row_t;
+
+typedef struct {
+  int16_t v[HISTORY_CH_COUNT];
+  uint16_t time_s; // uptime seconds, modulo 2^16
+  uint8_t accuracy;
+} history_raw_t;
+
+typedef struct {
+  uint32_t start_s; // uptime seconds at the start of the bucket
+  int16_t min[HISTORY_CH_COUNT];
+  int16_t avg[HISTORY_CH_COUNT];
+  int16_t max[HISTORY_CH_COUNT];
+  uint16_t count;   // samples folded into the bucket
+  uint8_t accuracy; // lowest accuracy seen in the bucket
+} history_agg_t;
+
+typedef enum {
+  HISTORY_TIER_5MIN,
+  HISTORY_TIER_1H,
+  HISTORY_TIER_COUNT,
+} history_tier_t;
+
+// Subscribes to the sample bus; a row is recorded whenever one of the
+// history channels is published
+bool history_init(void);
+
+// Builds a row inside a sample bus callback: channels in `updated` are read
+// in place, the others copied
+void history_row_from_bus(sample_mask_t updated, history_row_t *out);
+
+// Copy the newest `max_count` entries in chronological order. Raw entries
+// carry a truncated timestamp; `out_newest_s` receives the full uptime of the
+// newest one so callers can rebuild the rest.
+size_t history_read_raw(history_raw_t *out, size_t max_count,
+                        uint32_t *out_newest_s);
+size_t history_read_agg(history_tier_t tier, history_agg_t *out,
+                        size_t max_count);
+
+int16_t history_scale(history_channel_t ch, float value);
+float history_unscale(history_channel_t ch, int16_t value);
+
+size_t history_memory_bytes(void);
+
+#endif
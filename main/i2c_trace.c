@@ -0,0 +1,86 @@
+#include "i2c_trace.h"
+
+#include "esp_log.h"
+#include <stdio.h>
+
+static const char *TAG = "I2C";
+
+static i2c_trace_stats_t stats[I2C_TRACE_PORTS];
+
+static int us_bucket(uint32_t us) {
+  int i = 0;
+  while (i < I2C_TRACE_US_BUCKETS - 1 && us >= (32u << i))
+    i++;
+  return i;
+}
+
+static int bytes_bucket(uint32_t bytes) {
+  int i = 0;
+  while (i < I2C_TRACE_BYTES_BUCKETS - 1 && bytes > (1u << i))
+    i++;
+  return i;
+}
+
+void i2c_trace_record(i2c_port_t port, uint32_t bytes, uint32_t us,
+                      esp_err_t result) {
+  if (port < 0 || port >= I2C_TRACE_PORTS)
+    return;
+
+  i2c_trace_stats_t *s = &stats[port];
+  s->transactions++;
+  s->bytes += bytes;
+  s->bus_us += us;
+  if (us > s->max_us)
+    s->max_us = us;
+  s->us_hist[us_bucket(us)]++;
+  s->bytes_hist[bytes_bucket(bytes)]++;
+
+  if (result == ESP_FAIL)
+    s->nacks++;
+  else if (result != ESP_OK)
+    s->errors++;
+}
+
+int64_t i2c_trace_bus_us(i2c_port_t port) {
+  return port >= 0 && port < I2C_TRACE_PORTS ? stats[port].bus_us : 0;
+}
+
+void i2c_trace_get_stats(i2c_port_t port, i2c_trace_stats_t *out) {
+  if (out && port >= 0 && port < I2C_TRACE_PORTS)
+    *out = stats[port];
+}
+
+void i2c_trace_log_report(void) {
+  for (int port = 0; port < I2C_TRACE_PORTS; port++) {
+    const i2c_trace_stats_t *s = &stats[port];
+    if (s->transactions == 0)
+      continue;
+
+    ESP_LOGI(TAG, "port %d: %lu transactions, %llu bytes, %.1f ms on the bus, "
+                  "max %lu us; %lu NACKs, %lu errors",
+             port, (unsigned long)s->transactions,
+             (unsigned long long)s->bytes, (double)s->bus_us / 1e3,
+             (unsigned long)s->max_us, (unsigned long)s->nacks,
+             (unsigned long)s->errors);
+
+    char line[160];
+    int len = snprintf(line, sizeof(line), "  us:");
+    for (int i = 0; i < I2C_TRACE_US_BUCKETS && len < (int)sizeof(line); i++) {
+      const bool last = i == I2C_TRACE_US_BUCKETS - 1;
+      len += snprintf(line + len, sizeof(line) - len, " %s%lu:%lu",
+                      last ? ">=" : "<", 32ul << (last ? i - 1 : i),
+                      (unsigned long)s->us_hist[i]);
+    }
+    ESP_LOGI(TAG, "%s", line);
+
+    len = snprintf(line, sizeof(line), "  bytes:");
+    for (int i = 0; i < I2C_TRACE_BYTES_BUCKETS && len < (int)sizeof(line);
+         i++) {
+      const bool last = i == I2C_TRACE_BYTES_BUCKETS - 1;
+      len += snprintf(line + len, sizeof(line) - len, " %s%lu:%lu",
+                      last ? ">" : "<=", 1ul << (last ? i - 1 : i),
+                      (unsigned long)s->bytes_hist[i]);
+    }
+    ESP_LOGI(TAG, "%s", line);
+  }
+}
@@ -0,0 +1,45 @@
+#ifndef I2C_TRACE_H
+#define I2C_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/i2c.h"
+#include "esp_err.h"
+
+// Per-port accounting of I2C master transactions: duration and payload
+// histograms, NACKs and other failures. On the device every
+// transaction of the legacy driver passes through the wrappers in
+// i2c_trace_wrap.c, so components that talk to the bus directly, such as
+// bme68x, are covered without changes.
+
+#define I2C_TRACE_PORTS 2
+
+// Duration bucket i holds transactions shorter than 32 << i us; the last
+// one holds everything longer
+#define I2C_TRACE_US_BUCKETS 10
+// Payload bucket i holds transactions of up to 1 << i bytes
+#define I2C_TRACE_BYTES_BUCKETS 7
+
+typedef struct {
+  uint32_t transactions;
+  uint32_t nacks;
+  uint32_t errors;  // timeouts, arbitration loss, bus busy
+  uint64_t bytes;   // clocked bytes, address bytes included
+  int64_t bus_us;   // time in transactions
+  uint32_t max_us;
+  uint32_t us_hist[I2C_TRACE_US_BUCKETS];
+  uint32_t bytes_hist[I2C_TRACE_BYTES_BUCKETS];
+} i2c_trace_stats_t;
+
+// Accounts one transaction. Task context only.
+void i2c_trace_record(i2c_port_t port, uint32_t bytes, uint32_t us,
+                      esp_err_t result);
+
+// Running total of time spent in transactions on `port`, for deltas
+int64_t i2c_trace_bus_us(i2c_port_t port);
+
+void i2c_trace_get_stats(i2c_port_t port, i2c_trace_stats_t *out);
+void i2c_trace_log_report(void);
+
+#endif
@@ -0,0 +1,159 @@
+// Linker wrappers (-Wl,--wrap, see CMakeLists.txt) around the legacy I2C
+// master driver. Bytes queued on a command link are remembered per handle
+// and accounted when the link is executed. Calls the driver makes to itself,
+// such as i2c_master_write_read_device building its own link, are not
+// wrapped, so nothing is counted twice.
+
+#include "driver/i2c.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "i2c_trace.h"
+
+// Command links being built at the same time, one per bus task is plenty
+#define LINK_SLOTS 4
+
+typedef struct {
+  i2c_cmd_handle_t handle;
+  uint32_t bytes;
+} link_slot_t;
+
+static link_slot_t links[LINK_SLOTS];
+static portMUX_TYPE links_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t __real_i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data,
+                                       bool ack_en);
+esp_err_t __real_i2c_master_write(i2c_cmd_handle_t cmd, const uint8_t *data,
+                                  size_t len, bool ack_en);
+esp_err_t __real_i2c_master_read_byte(i2c_cmd_handle_t cmd, uint8_t *data,
+                                      i2c_ack_type_t ack);
+esp_err_t __real_i2c_master_read(i2c_cmd_handle_t cmd, uint8_t *data,
+                                 size_t len, i2c_ack_type_t ack);
+esp_err_t __real_i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t cmd,
+                                      TickType_t ticks);
+esp_err_t __real_i2c_master_write_to_device(i2c_port_t port, uint8_t addr,
+                                            const uint8_t *wr, size_t wr_len,
+                                            TickType_t ticks);
+esp_err_t __real_i2c_master_read_from_device(i2c_port_t port, uint8_t addr,
+                                             uint8_t *rd, size_t rd_len,
+                                             TickType_t ticks);
+esp_err_t __real_i2c_master_write_read_device(i2c_port_t port, uint8_t addr,
+                                              const uint8_t *wr, size_t wr_len,
+                                              uint8_t *rd, size_t rd_len,
+                                              TickType_t ticks);
+
+static void link_add(i2c_cmd_handle_t cmd, size_t bytes) {
+  link_slot_t *slot = NULL;
+  link_slot_t *free_slot = NULL;
+
+  taskENTER_CRITICAL(&links_lock);
+  for (int i = 0; i < LINK_SLOTS && slot == NULL; i++) {
+    if (links[i].handle == cmd)
+      slot = &links[i];
+    else if (links[i].handle == NULL && free_slot == NULL)
+      free_slot = &links[i];
+  }
+  if (slot == NULL && free_slot != NULL) {
+    slot = free_slot;
+    *slot = (link_slot_t){.handle = cmd};
+  }
+  // With no slot left the bytes of this link go uncounted
+  if (slot)
+    slot->bytes += bytes;
+  taskEXIT_CRITICAL(&links_lock);
+}
+
+static uint32_t link_take(i2c_cmd_handle_t cmd) {
+  uint32_t bytes = 0;
+
+  taskENTER_CRITICAL(&links_lock);
+  for (int i = 0; i < LINK_SLOTS; i++) {
+    if (links[i].handle == cmd) {
+      bytes = links[i].bytes;
+      links[i] = (link_slot_t){0};
+      break;
+    }
+  }
+  taskEXIT_CRITICAL(&links_lock);
+
+  return bytes;
+}
+
+esp_err_t __wrap_i2c_master_write_byte(i2c_cmd_handle_t cmd, uint8_t data,
+                                       bool ack_en) {
+  link_add(cmd, 1);
+  return __real_i2c_master_write_byte(cmd, data, ack_en);
+}
+
+esp_err_t __wrap_i2c_master_write(i2c_cmd_handle_t cmd, const uint8_t *data,
+                                  size_t len, bool ack_en) {
+  link_add(cmd, len);
+  return __real_i2c_master_write(cmd, data, len, ack_en);
+}
+
+esp_err_t __wrap_i2c_master_read_byte(i2c_cmd_handle_t cmd, uint8_t *data,
+                                      i2c_ack_type_t ack) {
+  link_add(cmd, 1);
+  return __real_i2c_master_read_byte(cmd, data, ack);
+}
+
+esp_err_t __wrap_i2c_master_read(i2c_cmd_handle_t cmd, uint8_t *data,
+                                 size_t len, i2c_ack_type_t ack) {
+  link_add(cmd, len);
+  return __real_i2c_master_read(cmd, data, len, ack);
+}
+
+// Times `attempt` into `err` and accounts it. Only observes: whatever the
+// driver returns is passed back unchanged.
+#define TRACED(err, port, bytes, attempt)                                      \
+  do {                                                                         \
+    const int64_t start = esp_timer_get_time();                                \
+    err = (attempt);                                                           \
+    i2c_trace_record((port), (bytes),                                          \
+                     (uint32_t)(esp_timer_get_time() - start), err);           \
+  } while (0)
+
+esp_err_t __wrap_i2c_master_cmd_begin(i2c_port_t port, i2c_cmd_handle_t cmd,
+                                      TickType_t ticks) {
+  const uint32_t bytes = link_take(cmd);
+  esp_err_t err;
+
+  TRACED(err, port, bytes, __real_i2c_master_cmd_begin(port, cmd, ticks));
+  return err;
+}
+
+// The helpers below count the address byte of each START as well, like a
+// link built by hand does
+
+esp_err_t __wrap_i2c_master_write_to_device(i2c_port_t port, uint8_t addr,
+                                            const uint8_t *wr, size_t wr_len,
+                                            TickType_t ticks) {
+  esp_err_t err;
+
+  TRACED(err, port, 1 + wr_len,
+         __real_i2c_master_write_to_device(port, addr, wr, wr_len, ticks));
+  return err;
+}
+
+esp_err_t __wrap_i2c_master_read_from_device(i2c_port_t port, uint8_t addr,
+                                             uint8_t *rd, size_t rd_len,
+                                             TickType_t ticks) {
+  esp_err_t err;
+
+  TRACED(err, port, 1 + rd_len,
+         __real_i2c_master_read_from_device(port, addr, rd, rd_len, ticks));
+  return err;
+}
+
+esp_err_t __wrap_i2c_master_write_read_device(i2c_port_t port, uint8_t addr,
+                                              const uint8_t *wr, size_t wr_len,
+                                              uint8_t *rd, size_t rd_len,
+                                              TickType_t ticks) {
+  esp_err_t err;
+
+  TRACED(err, port, 2 + wr_len + rd_len,
+         __real_i2c_master_write_read_device(port, addr, wr, wr_len, rd,
+                                             rd_len, ticks));
+  return err;
+}
@@ -1,290 +0,0 @@
-/*
- * Asset: Cat Animation (Free Pack)
- * Author: ToffeeCraft (https://toffeecraft.itch.io/)
- * Source: https://toffeecraft.itch.io/cat-pack
- * The copyright belongs to ToffeeCraft. Do not extract or resell this asset.
- */
-
-#include "lvgl.h"
-
-const uint8_t kitty_gif_map[] = {
-  0x47, 0x49, 0x46, 0x38, 0x39, 0x61, 0x20, 0x00, 0x20, 0x00, 0xf5, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x21, 0x21, 0x21, 0x2c, 0x22, 0x27, 0xd7, 0x8c,
-  0x77, 0xeb, 0x94, 0x86, 0xed, 0xaf, 0x97, 0xf1, 0xb2, 0x9e, 0xdb, 0xb1,
-  0xa6, 0xdc, 0xb2, 0xaa, 0xde, 0xb5, 0xa8, 0xe6, 0xb4, 0xa0, 0xe1, 0xb5,
-  0xad, 0xe1, 0xb8, 0xaa, 0xe2, 0xb8, 0xaf, 0xfb, 0xd2, 0xb3, 0xfd, 0xd5,
-  0xb5, 0xfe, 0xd8, 0xb7, 0xea, 0xc6, 0xc2, 0xfa, 0xf3, 0xe5, 0xfd, 0xf3,
-  0xe6, 0xf9, 0xf5, 0xe6, 0xfe, 0xf5, 0xe6, 0xff, 0xf8, 0xe4, 0xf9, 0xf4,
-  0xea, 0xfe, 0xf4, 0xe8, 0xfa, 0xf5, 0xec, 0xfc, 0xf6, 0xed, 0xfd, 0xf8,
-  0xea, 0xfe, 0xf9, 0xef, 0xfb, 0xf8, 0xf0, 0xfe, 0xf8, 0xf3, 0xff, 0xff,
-  0xff, 0xdf, 0xb2, 0xad, 0xe3, 0xba, 0xad, 0xfe, 0xf8, 0xe6, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x21, 0xff, 0x0b, 0x4e, 0x45, 0x54, 0x53, 0x43, 0x41, 0x50, 0x45,
-  0x32, 0x2e, 0x30, 0x03, 0x01, 0x00, 0x00, 0x00, 0x21, 0xf9, 0x04, 0x09,
-  0x0f, 0x00, 0x20, 0x00, 0x21, 0xfe, 0x28, 0x47, 0x49, 0x46, 0x20, 0x63,
-  0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x20, 0x77, 0x69, 0x74, 0x68, 0x20,
-  0x68, 0x74, 0x74, 0x70, 0x73, 0x3a, 0x2f, 0x2f, 0x65, 0x7a, 0x67, 0x69,
-  0x66, 0x2e, 0x63, 0x6f, 0x6d, 0x2f, 0x6d, 0x61, 0x6b, 0x65, 0x72, 0x00,
-  0x2c, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00, 0x06, 0xff,
-  0x40, 0x90, 0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c,
-  0x3a, 0x9f, 0xcc, 0x40, 0x40, 0x29, 0x85, 0x82, 0x02, 0x0f, 0xa9, 0x76,
-  0x2b, 0xcd, 0x5a, 0x03, 0x83, 0xec, 0xe3, 0xa1, 0x20, 0x8f, 0xb1, 0x83,
-  0xc1, 0xf4, 0x09, 0x16, 0x9b, 0xcb, 0xe2, 0xf4, 0xda, 0xd9, 0x1e, 0xbf,
-  0xed, 0x63, 0x35, 0x14, 0x8b, 0x1f, 0xc3, 0xed, 0x7a, 0x6c, 0x78, 0x0e,
-  0x0e, 0x7d, 0x76, 0x73, 0x51, 0x86, 0x8a, 0x67, 0x82, 0x63, 0x1f, 0x00,
-  0x7d, 0x8f, 0x87, 0x4f, 0x02, 0x76, 0x00, 0x90, 0x0f, 0x98, 0x97, 0x0f,
-  0x10, 0x5e, 0x74, 0x0f, 0x04, 0x04, 0x15, 0xa3, 0x00, 0x15, 0xa5, 0xa3,
-  0xa1, 0x0e, 0x88, 0x51, 0xa1, 0xa3, 0xae, 0xaf, 0xad, 0xab, 0x4b, 0x01,
-  0xaf, 0xb5, 0xaf, 0xb2, 0x51, 0x15, 0x18, 0xb6, 0xae, 0xb8, 0x4d, 0x01,
-  0x11, 0xbc, 0x0d, 0xbe, 0xbf, 0x15, 0x0d, 0x0b, 0x08, 0x08, 0x07, 0x09,
-  0x0c, 0x15, 0x6b, 0x55, 0x7b, 0xbc, 0xa3, 0x06, 0x52, 0x0a, 0x0a, 0xc4,
-  0x46, 0xb4, 0xbc, 0x1a, 0x15, 0x05, 0xd7, 0xd6, 0xd7, 0x74, 0xae, 0x18,
-  0xe4, 0xbb, 0xae, 0xd7, 0x01, 0xd6, 0xd8, 0x44, 0xda, 0xd2, 0x15, 0xe1,
-  0x01, 0x16, 0xe1, 0xb9, 0xa3, 0x12, 0xed, 0xef, 0xa3, 0x55, 0x01, 0x1b,
-  0xf3, 0x54, 0xae, 0x14, 0xed, 0x2e, 0x28, 0x18, 0xb5, 0x61, 0x83, 0x14,
-  0x7e, 0xc4, 0xb6, 0x0c, 0xac, 0x70, 0x81, 0xd6, 0x06, 0x0c, 0x0a, 0x0d,
-  0x6e, 0x90, 0xe7, 0x2b, 0xc0, 0x05, 0x0a, 0x18, 0xb5, 0x65, 0xa0, 0xd5,
-  0x50, 0x42, 0x07, 0x0e, 0x1c, 0x14, 0x48, 0x54, 0x87, 0x24, 0x1d, 0x86,
-  0x8c, 0xa3, 0x34, 0x38, 0x4c, 0x57, 0xa1, 0xa0, 0x35, 0x7e, 0xfd, 0xb2,
-  0x59, 0xcb, 0xe8, 0x21, 0x5f, 0xcb, 0x74, 0x0a, 0x26, 0x68, 0x00, 0x17,
-  0xf3, 0x08, 0x4e, 0x0f, 0x80, 0xe0, 0x68, 0x41, 0xe4, 0x89, 0x6e, 0x9d,
-  0x10, 0x2e, 0x48, 0xb9, 0x38, 0x09, 0x02, 0x00, 0x21, 0xf9, 0x04, 0x09,
-  0x0f, 0x00, 0x20, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x20,
-  0x00, 0x00, 0x06, 0xff, 0x40, 0x90, 0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8,
-  0xa4, 0x72, 0xc9, 0x6c, 0x3a, 0x9f, 0xcc, 0x40, 0x40, 0x29, 0x85, 0x82,
-  0x02, 0x0f, 0xa9, 0x76, 0x2b, 0xcd, 0x5a, 0x03, 0x83, 0xec, 0xe3, 0xa1,
-  0x20, 0x8f, 0xb1, 0x83, 0xc1, 0xf4, 0x09, 0x16, 0x9b, 0xcb, 0xe2, 0xf4,
-  0xda, 0xd9, 0x1e, 0xbf, 0xed, 0x63, 0x35, 0x14, 0x8b, 0x1f, 0xc3, 0xed,
-  0x7a, 0x6c, 0x78, 0x0e, 0x0e, 0x7d, 0x76, 0x73, 0x51, 0x86, 0x8a, 0x67,
-  0x82, 0x63, 0x1f, 0x00, 0x7d, 0x8f, 0x87, 0x4f, 0x02, 0x76, 0x00, 0x90,
-  0x0f, 0x98, 0x97, 0x0f, 0x10, 0x5e, 0x74, 0x0f, 0x04, 0x04, 0x15, 0xa3,
-  0x00, 0x15, 0xa5, 0xa3, 0xa1, 0x0e, 0x88, 0x51, 0xa1, 0xa3, 0xae, 0xaf,
-  0xad, 0xab, 0x4b, 0x01, 0xaf, 0xb5, 0xaf, 0xb2, 0x51, 0x15, 0x18, 0xb6,
-  0xae, 0xb8, 0x4d, 0x01, 0x11, 0xbc, 0x0d, 0x88, 0x5a, 0x74, 0x15, 0x0d,
-  0x0b, 0x08, 0x08, 0x07, 0x09, 0x0c, 0x15, 0x73, 0x01, 0x0a, 0xd2, 0xbe,
-  0x45, 0xb4, 0xbc, 0x15, 0x06, 0xd0, 0xd3, 0xb9, 0xbc, 0x1a, 0x15, 0x05,
-  0x0a, 0x6b, 0xd1, 0xe1, 0xdc, 0xba, 0x18, 0xe7, 0xaf, 0xe4, 0x57, 0x16,
-  0xea, 0x54, 0xd7, 0xae, 0xea, 0x01, 0x1b, 0xed, 0x49, 0xd6, 0x15, 0x12,
-  0xf6, 0x15, 0x0a, 0xa3, 0x55, 0xf2, 0xf4, 0x48, 0xf6, 0x28, 0xd8, 0xbb,
-  0xb0, 0xaf, 0xc2, 0x86, 0x0d, 0x52, 0xe6, 0x51, 0xdb, 0x52, 0xf0, 0x02,
-  0xad, 0x0d, 0x18, 0x18, 0x22, 0xdc, 0xc0, 0xce, 0x57, 0x80, 0x0b, 0x14,
-  0x32, 0x5a, 0xcb, 0x40, 0xcb, 0xa1, 0x84, 0x0e, 0x1c, 0x38, 0x28, 0x98,
-  0xb8, 0xed, 0x48, 0x34, 0x0c, 0x1a, 0x47, 0x69, 0x78, 0x18, 0xcd, 0xe0,
-  0xbc, 0x91, 0x25, 0x4d, 0x4a, 0xd3, 0xe8, 0x81, 0x9f, 0xc1, 0x71, 0x13,
-  0x34, 0x48, 0x8b, 0x09, 0x70, 0xe6, 0xb8, 0x0d, 0x70, 0xba, 0x7e, 0x4e,
-  0xab, 0x12, 0x85, 0x8b, 0xd1, 0x2d, 0x4e, 0x82, 0x00, 0x00, 0x21, 0xf9,
-  0x04, 0x09, 0x0f, 0x00, 0x20, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x20,
-  0x00, 0x20, 0x00, 0x00, 0x06, 0xff, 0x40, 0x90, 0x70, 0x48, 0x2c, 0x1a,
-  0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c, 0x3a, 0x9f, 0xcc, 0x40, 0x40, 0x29,
-  0x85, 0x82, 0x02, 0x0f, 0xa9, 0x76, 0x2b, 0xcd, 0x5a, 0x03, 0x83, 0xec,
-  0xe3, 0xa1, 0x20, 0x8f, 0xb1, 0x83, 0xc1, 0xf4, 0x09, 0x16, 0x9b, 0xcb,
-  0xe2, 0xf4, 0xda, 0xd9, 0x1e, 0xbf, 0xed, 0x63, 0x35, 0x14, 0x8b, 0x1f,
-  0xc3, 0xed, 0x7a, 0x6c, 0x78, 0x0e, 0x0e, 0x7d, 0x76, 0x73, 0x51, 0x86,
-  0x8a, 0x67, 0x82, 0x63, 0x1f, 0x00, 0x7d, 0x8f, 0x87, 0x4f, 0x02, 0x76,
-  0x00, 0x90, 0x0f, 0x98, 0x97, 0x0f, 0x10, 0x5e, 0x74, 0x0f, 0x04, 0x04,
-  0x15, 0xa3, 0x00, 0x15, 0xa5, 0xa3, 0xa1, 0x0e, 0x88, 0x51, 0xa1, 0xa3,
-  0xae, 0xaf, 0xad, 0xab, 0x4b, 0x01, 0xaf, 0xb5, 0xaf, 0xb2, 0x51, 0x15,
-  0x18, 0xb6, 0xae, 0xb8, 0x4d, 0x01, 0x11, 0xbc, 0x0d, 0xb8, 0x55, 0xb3,
-  0x15, 0x0d, 0x0b, 0x08, 0x08, 0x07, 0x09, 0x0c, 0x15, 0xb2, 0x01, 0x0a,
-  0x0a, 0xbe, 0x43, 0xb4, 0xbc, 0x15, 0x06, 0xab, 0xd1, 0xd3, 0x54, 0xd7,
-  0x1a, 0x15, 0x05, 0xdc, 0xd5, 0xd2, 0xd4, 0x57, 0xae, 0x18, 0xe8, 0xbb,
-  0xae, 0xe2, 0x42, 0x01, 0x16, 0xe5, 0xe6, 0xd7, 0xa3, 0xec, 0xee, 0xec,
-  0x48, 0xd6, 0x15, 0x12, 0xf8, 0x15, 0x0a, 0xa3, 0xc5, 0x01, 0x1b, 0xec,
-  0x1d, 0xc1, 0x47, 0x01, 0xdf, 0x85, 0x7e, 0x15, 0x36, 0x6c, 0x90, 0x12,
-  0x90, 0xda, 0x16, 0x84, 0x17, 0x68, 0x6d, 0xc0, 0xf0, 0x70, 0xe1, 0x06,
-  0x0b, 0x02, 0xab, 0x5d, 0xa0, 0xc0, 0xd1, 0x5a, 0x06, 0x5a, 0x11, 0x25,
-  0x74, 0xe0, 0xc0, 0x41, 0x81, 0x45, 0x72, 0xf7, 0x14, 0x60, 0xe8, 0x38,
-  0x4a, 0x83, 0xc4, 0x68, 0x09, 0x03, 0x9a, 0x44, 0x99, 0x52, 0x41, 0x47,
-  0x0f, 0xfe, 0x12, 0x6e, 0x9b, 0xa0, 0x41, 0x1a, 0xcd, 0x11, 0x24, 0xdb,
-  0x0a, 0xfa, 0xa4, 0x45, 0xd1, 0x27, 0xb9, 0x62, 0xb3, 0xb8, 0x28, 0xdd,
-  0xe2, 0x24, 0x08, 0x00, 0x21, 0xf9, 0x04, 0x09, 0x0f, 0x00, 0x07, 0x00,
-  0x2c, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00, 0x06, 0xff,
-  0xc0, 0x83, 0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c,
-  0x3a, 0x9f, 0xd0, 0xe8, 0x32, 0x10, 0x50, 0x52, 0xa3, 0x81, 0x07, 0x75,
-  0xcb, 0xa5, 0x6a, 0xb1, 0x03, 0xed, 0xe3, 0xa1, 0x20, 0x8f, 0xb3, 0x83,
-  0x41, 0xf5, 0x19, 0x08, 0x67, 0xcd, 0x65, 0x71, 0x7a, 0xed, 0x6c, 0x8f,
-  0xc7, 0xe5, 0xf8, 0x5d, 0x0d, 0x7d, 0xdf, 0xf1, 0x7f, 0x0f, 0x7c, 0x6c,
-  0x7f, 0x0e, 0x0e, 0x81, 0x77, 0x74, 0x4c, 0x7e, 0x88, 0x88, 0x8a, 0x53,
-  0x77, 0x1f, 0x00, 0x81, 0x92, 0x89, 0x4f, 0x02, 0x77, 0x00, 0x93, 0x0f,
-  0x9b, 0x9a, 0x0f, 0x10, 0x5f, 0x75, 0x0f, 0x04, 0x04, 0x15, 0xa6, 0x00,
-  0x15, 0xa8, 0xa6, 0xa4, 0x0e, 0x8f, 0x53, 0xa4, 0xa6, 0xb1, 0xb2, 0xb0,
-  0xae, 0x56, 0xb2, 0xb7, 0xb2, 0xb5, 0x53, 0x15, 0x18, 0xb8, 0xb1, 0xba,
-  0x8b, 0x11, 0xbe, 0x21, 0xc0, 0x8b, 0x15, 0x20, 0xc8, 0xc9, 0x20, 0x15,
-  0x06, 0xc0, 0x57, 0x47, 0x01, 0xbe, 0x15, 0x1a, 0x15, 0x05, 0x0a, 0xb5,
-  0x01, 0xd7, 0x48, 0xd1, 0xa6, 0x18, 0xde, 0xbd, 0xb1, 0xda, 0x45, 0xd9,
-  0xe2, 0x46, 0xdc, 0xd2, 0x15, 0xe5, 0x43, 0x01, 0x22, 0xcf, 0xe6, 0xb1,
-  0x12, 0xe7, 0xe9, 0xa6, 0xee, 0x07, 0xec, 0xea, 0xe3, 0xb1, 0x14, 0xe7,
-  0x17, 0x0a, 0xa6, 0x1b, 0x1b, 0xd6, 0x04, 0xd8, 0x80, 0x4f, 0x08, 0x17,
-  0x7f, 0x15, 0x2e, 0x44, 0xdb, 0x80, 0xe1, 0x60, 0x40, 0x2a, 0x22, 0x0a,
-  0xda, 0xbb, 0x40, 0xa1, 0x22, 0xb7, 0x0c, 0xd1, 0x14, 0x4a, 0xe8, 0xc0,
-  0x81, 0x83, 0x82, 0x80, 0x04, 0x15, 0x48, 0xcc, 0x86, 0xc1, 0xa2, 0x29,
-  0x0d, 0x0b, 0xb3, 0x55, 0x00, 0x28, 0x32, 0xa4, 0x44, 0x7b, 0x22, 0x2d,
-  0x7a, 0xa0, 0xb7, 0x92, 0xdc, 0x04, 0x0d, 0x22, 0x45, 0xd6, 0x33, 0x17,
-  0x93, 0xdc, 0x35, 0x0c, 0x5e, 0x3e, 0x75, 0xee, 0xdc, 0xd6, 0xa5, 0x28,
-  0x17, 0x27, 0x41, 0x00, 0x00, 0x21, 0xf9, 0x04, 0x09, 0x0f, 0x00, 0x07,
-  0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00, 0x06,
-  0xff, 0xc0, 0x83, 0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9,
-  0x6c, 0x3a, 0x9f, 0xd0, 0xe8, 0x32, 0x10, 0x50, 0x52, 0xa3, 0x81, 0x07,
-  0x75, 0xcb, 0xa5, 0x6a, 0xb1, 0x03, 0xed, 0xe3, 0xa1, 0x20, 0x8f, 0xb3,
-  0x83, 0x41, 0xf5, 0x19, 0x08, 0x67, 0xcd, 0x65, 0x71, 0x7a, 0xed, 0x6c,
-  0x8f, 0xc7, 0xe5, 0xf8, 0x5d, 0x0d, 0x7d, 0xdf, 0xf1, 0x7f, 0x0f, 0x7c,
-  0x6c, 0x7f, 0x0e, 0x0e, 0x81, 0x77, 0x74, 0x4c, 0x7e, 0x88, 0x88, 0x8a,
-  0x53, 0x77, 0x1f, 0x00, 0x81, 0x92, 0x89, 0x4f, 0x02, 0x77, 0x00, 0x93,
-  0x0f, 0x9b, 0x9a, 0x0f, 0x10, 0x5f, 0x75, 0x0f, 0x04, 0x04, 0x15, 0xa6,
-  0x00, 0x15, 0xa8, 0xa6, 0xa4, 0x0e, 0x8f, 0x53, 0xa4, 0xa6, 0xb1, 0xb2,
-  0xb0, 0xae, 0x56, 0xb2, 0xb7, 0xb2, 0xb5, 0x53, 0x15, 0x18, 0xb8, 0xb1,
-  0xba, 0x8b, 0x11, 0xbe, 0x21, 0xc0, 0x8b, 0x15, 0x20, 0xc8, 0xc9, 0x20,
-  0x15, 0x06, 0xc5, 0x49, 0x01, 0xbe, 0x15, 0x1a, 0x15, 0x05, 0x0a, 0xce,
-  0x47, 0xd0, 0xa6, 0x18, 0xdb, 0xbd, 0xb1, 0xd6, 0x52, 0xd9, 0xd1, 0x15,
-  0xdf, 0xcf, 0xd8, 0xb1, 0x12, 0xe1, 0xe3, 0xa6, 0x57, 0x46, 0x54, 0xe4,
-  0x44, 0xe1, 0x14, 0xe1, 0x17, 0x0a, 0xa6, 0x1b, 0x1b, 0x8f, 0x01, 0x22,
-  0x0a, 0xef, 0x5c, 0xf5, 0x15, 0x17, 0xa0, 0x6d, 0xc0, 0xe0, 0x0f, 0x5f,
-  0x97, 0x7d, 0xfd, 0x2e, 0x50, 0x58, 0x98, 0x2d, 0x03, 0xb4, 0x80, 0x12,
-  0x3a, 0x70, 0xe0, 0xa0, 0x00, 0xdf, 0x06, 0x11, 0x18, 0xf7, 0xb1, 0x13,
-  0x12, 0x40, 0x01, 0x06, 0x86, 0xa6, 0x34, 0x08, 0xec, 0x58, 0xe1, 0x1e,
-  0xbf, 0x0d, 0xfc, 0x52, 0xba, 0xea, 0xa8, 0x80, 0xa1, 0x87, 0x75, 0x25,
-  0x59, 0x4e, 0xd0, 0x90, 0xd2, 0xda, 0x16, 0x24, 0x2c, 0xe5, 0xa9, 0xe4,
-  0xc5, 0x52, 0xe5, 0x46, 0x07, 0x2b, 0x5d, 0x82, 0x72, 0x71, 0x12, 0x04,
-  0x00, 0x21, 0xf9, 0x04, 0x09, 0x0f, 0x00, 0x07, 0x00, 0x2c, 0x00, 0x00,
-  0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00, 0x06, 0xff, 0xc0, 0x83, 0x70,
-  0x48, 0x2c, 0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c, 0x3a, 0x9f, 0xd0,
-  0xe8, 0x32, 0x10, 0x50, 0x52, 0xa3, 0x81, 0x07, 0x75, 0xcb, 0xa5, 0x6a,
-  0xb1, 0x03, 0xed, 0xe3, 0xa1, 0x20, 0x8f, 0xb3, 0x83, 0x41, 0xf5, 0x19,
-  0x08, 0x67, 0xcd, 0x65, 0x71, 0x7a, 0xed, 0x6c, 0x8f, 0xc7, 0xe5, 0xf8,
-  0x5d, 0x0d, 0x7d, 0xdf, 0xf1, 0x7f, 0x0f, 0x7c, 0x6c, 0x7f, 0x0e, 0x0e,
-  0x81, 0x77, 0x74, 0x4c, 0x7e, 0x88, 0x88, 0x8a, 0x53, 0x77, 0x1f, 0x00,
-  0x81, 0x92, 0x89, 0x4f, 0x02, 0x77, 0x00, 0x93, 0x0f, 0x9b, 0x9a, 0x0f,
-  0x10, 0x5f, 0x75, 0x0f, 0x04, 0x04, 0x15, 0xa6, 0x00, 0x15, 0xa8, 0xa6,
-  0xa4, 0x0e, 0x8f, 0x53, 0xa4, 0xa6, 0xb1, 0xb2, 0xb0, 0xae, 0x56, 0xb2,
-  0xb7, 0xb2, 0xb5, 0x53, 0x15, 0x18, 0xb8, 0xb1, 0xba, 0x8b, 0x11, 0xbe,
-  0x21, 0xc0, 0x8b, 0x15, 0x20, 0xc8, 0xc9, 0x20, 0x15, 0x06, 0xc5, 0x49,
-  0x01, 0xbe, 0x15, 0x1a, 0x15, 0x05, 0x0a, 0xce, 0x47, 0xd0, 0xa6, 0x18,
-  0xdb, 0xbd, 0xb1, 0xd6, 0x52, 0xd9, 0xd1, 0x15, 0xdf, 0x58, 0xb1, 0x12,
-  0xe1, 0xe3, 0xa6, 0x57, 0x7d, 0xb1, 0x14, 0xe1, 0x17, 0x0a, 0xa6, 0x1b,
-  0x1b, 0xd7, 0x07, 0x5c, 0xf1, 0x15, 0x17, 0xd0, 0x1b, 0x18, 0xf7, 0xf4,
-  0x5d, 0x00, 0xed, 0x5d, 0xa0, 0x40, 0x30, 0x5b, 0x06, 0x68, 0xfa, 0x24,
-  0x74, 0xe0, 0xc0, 0x41, 0x01, 0xbd, 0x0d, 0x22, 0x22, 0x4a, 0x14, 0xa1,
-  0xa0, 0x22, 0x15, 0x05, 0x18, 0x0a, 0x9a, 0xd2, 0xb0, 0x2f, 0x40, 0xbc,
-  0x79, 0x15, 0x37, 0x54, 0x1c, 0x49, 0xf2, 0x9b, 0x47, 0x05, 0x05, 0x3d,
-  0xa8, 0xab, 0x40, 0xaf, 0xe2, 0x04, 0x0d, 0x24, 0x01, 0x6e, 0x19, 0x72,
-  0xd2, 0xdd, 0x48, 0x68, 0xfd, 0x4a, 0xce, 0x5c, 0x24, 0xb3, 0xa7, 0x93,
-  0x01, 0x20, 0x00, 0x21, 0xf9, 0x04, 0x09, 0x0f, 0x00, 0x07, 0x00, 0x2c,
-  0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00, 0x06, 0xff, 0xc0,
-  0x83, 0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c, 0x3a,
-  0x9f, 0xd0, 0xe8, 0x32, 0x10, 0x50, 0x52, 0xa3, 0x81, 0x07, 0x75, 0xcb,
-  0xa5, 0x6a, 0xb1, 0x03, 0xed, 0xe3, 0xa1, 0x20, 0x8f, 0xb3, 0x83, 0x41,
-  0xf5, 0x19, 0x08, 0x67, 0xcd, 0x65, 0x71, 0x7a, 0xed, 0x6c, 0x8f, 0xc7,
-  0xe5, 0xf8, 0x5d, 0x0d, 0x7d, 0xdf, 0xf1, 0x7f, 0x0f, 0x7c, 0x6c, 0x7f,
-  0x0e, 0x0e, 0x81, 0x77, 0x74, 0x4c, 0x7e, 0x88, 0x88, 0x8a, 0x53, 0x77,
-  0x1f, 0x00, 0x81, 0x92, 0x89, 0x4f, 0x02, 0x77, 0x00, 0x93, 0x0f, 0x9b,
-  0x9a, 0x0f, 0x10, 0x5f, 0x75, 0x0f, 0x04, 0x04, 0x15, 0xa6, 0x00, 0x15,
-  0xa8, 0xa6, 0xa4, 0x0e, 0x8f, 0x53, 0xa4, 0xa6, 0xb1, 0xb2, 0xb0, 0xae,
-  0x56, 0xb2, 0xb7, 0xb2, 0xb5, 0x53, 0x15, 0x18, 0xb8, 0xb1, 0xba, 0x8b,
-  0x11, 0xbe, 0x21, 0xc0, 0x8b, 0x15, 0x20, 0xc8, 0xc9, 0x20, 0x15, 0x06,
-  0xc5, 0x49, 0x01, 0xbe, 0x15, 0x1a, 0x15, 0x05, 0x0a, 0xce, 0x47, 0xd0,
-  0xa6, 0x18, 0xdb, 0xbd, 0xb1, 0xd6, 0x52, 0xd9, 0xd1, 0x15, 0xdf, 0xcf,
-  0xd8, 0xb1, 0x12, 0xe1, 0xe3, 0xa6, 0x57, 0x46, 0x54, 0xe4, 0x44, 0xe1,
-  0x14, 0xe1, 0x17, 0x0a, 0xa6, 0x1b, 0x1b, 0x8f, 0x01, 0x22, 0x0a, 0xef,
-  0x5c, 0xf5, 0x15, 0x17, 0xa0, 0x6d, 0xc0, 0xe0, 0x0f, 0x5f, 0x97, 0x7d,
-  0xfd, 0x2e, 0x50, 0x58, 0x98, 0x2d, 0x03, 0xb4, 0x80, 0x12, 0x3a, 0x70,
-  0xe0, 0xa0, 0x00, 0xdf, 0x06, 0x11, 0x18, 0xf7, 0xb1, 0x13, 0x12, 0x40,
-  0x01, 0x06, 0x86, 0xa6, 0x34, 0x08, 0xec, 0x58, 0xe1, 0x1e, 0xbf, 0x0d,
-  0xfc, 0x52, 0xba, 0xea, 0xa8, 0x80, 0xa1, 0x87, 0x75, 0x25, 0x59, 0x4e,
-  0xd0, 0x90, 0xd2, 0xda, 0x16, 0x24, 0x2c, 0xe5, 0xa9, 0xe4, 0xc5, 0x52,
-  0xe5, 0x46, 0x07, 0x2b, 0x5d, 0x82, 0x72, 0x71, 0x12, 0x04, 0x00, 0x21,
-  0xf9, 0x04, 0x09, 0x0f, 0x00, 0x16, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00,
-  0x20, 0x00, 0x20, 0x00, 0x00, 0x06, 0xff, 0x40, 0x8b, 0x70, 0x48, 0x2c,
-  0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c, 0x3a, 0x9f, 0xcc, 0x40, 0x40,
-  0x29, 0x85, 0x5a, 0x02, 0x0f, 0xa9, 0x76, 0x2b, 0xcd, 0x5a, 0x03, 0x83,
-  0xec, 0xe3, 0xa1, 0x20, 0x8f, 0xb1, 0x83, 0xc1, 0xf4, 0x09, 0x16, 0x9b,
-  0xcb, 0xe2, 0xf4, 0xda, 0xd9, 0x1e, 0xbf, 0xed, 0x63, 0x35, 0x14, 0x8b,
-  0x1f, 0xc3, 0xed, 0x7a, 0x6c, 0x78, 0x0e, 0x0e, 0x7d, 0x76, 0x73, 0x51,
-  0x86, 0x8a, 0x67, 0x82, 0x63, 0x1f, 0x00, 0x7d, 0x8f, 0x87, 0x4f, 0x02,
-  0x76, 0x00, 0x90, 0x0f, 0x98, 0x97, 0x0f, 0x10, 0x5e, 0x74, 0x0f, 0x04,
-  0x04, 0x15, 0xa3, 0x00, 0x15, 0xa5, 0xa3, 0xa1, 0x0e, 0x88, 0x51, 0xa1,
-  0xa3, 0xae, 0xaf, 0xad, 0xab, 0x4b, 0x01, 0xaf, 0xb5, 0xaf, 0xb2, 0x51,
-  0x15, 0x18, 0xb6, 0xae, 0xb8, 0x4d, 0x01, 0x11, 0xbc, 0x0d, 0xbe, 0xbf,
-  0x15, 0x0d, 0x0b, 0x08, 0x08, 0x07, 0x09, 0x0c, 0x15, 0xc4, 0xb9, 0xbc,
-  0x15, 0x06, 0xc4, 0x55, 0x47, 0xb4, 0xbc, 0x1a, 0x15, 0x05, 0x0a, 0xb8,
-  0x01, 0xdc, 0x48, 0xd7, 0xba, 0x18, 0xe3, 0xaf, 0xdf, 0x45, 0xde, 0xe6,
-  0x46, 0xe1, 0xd1, 0xe9, 0x43, 0x01, 0x22, 0xd5, 0xea, 0xae, 0x12, 0xeb,
-  0x0a, 0xa3, 0xf1, 0x57, 0x22, 0xed, 0xe7, 0xae, 0x14, 0xe1, 0x17, 0xf6,
-  0x2a, 0x6c, 0xd8, 0xb0, 0x26, 0xc0, 0x86, 0x7d, 0x42, 0xb6, 0x04, 0xbc,
-  0x40, 0x6b, 0x03, 0x06, 0x85, 0x04, 0xa5, 0xe8, 0xeb, 0x76, 0x81, 0x82,
-  0xc5, 0x6b, 0x19, 0x68, 0x31, 0x94, 0xd0, 0x81, 0x03, 0x07, 0x05, 0x04,
-  0x0f, 0x2a, 0x40, 0x78, 0x45, 0x01, 0x86, 0x8b, 0xa3, 0x34, 0x34, 0xf4,
-  0x26, 0x50, 0xa4, 0x48, 0x92, 0x25, 0x15, 0x5c, 0xf4, 0x70, 0x4f, 0x20,
-  0xba, 0x09, 0x1a, 0x46, 0x8e, 0xc4, 0xa7, 0x6e, 0xa4, 0x3f, 0x0e, 0x9d,
-  0xb4, 0x1e, 0xea, 0xdc, 0xc9, 0x13, 0x1c, 0x97, 0xa3, 0x5b, 0x9c, 0x04,
-  0x01, 0x00, 0x21, 0xf9, 0x04, 0x09, 0x0f, 0x00, 0x20, 0x00, 0x2c, 0x00,
-  0x00, 0x00, 0x00, 0x20, 0x00, 0x20, 0x00, 0x00, 0x06, 0xff, 0x40, 0x90,
-  0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8, 0xa4, 0x72, 0xc9, 0x6c, 0x3a, 0x9f,
-  0xcc, 0x40, 0x40, 0x29, 0x85, 0x82, 0x02, 0x0f, 0xa9, 0x76, 0x2b, 0xcd,
-  0x5a, 0x03, 0x83, 0xec, 0xe3, 0xa1, 0x20, 0x8f, 0xb1, 0x83, 0xc1, 0xf4,
-  0x09, 0x16, 0x9b, 0xcb, 0xe2, 0xf4, 0xda, 0xd9, 0x1e, 0xbf, 0xed, 0x63,
-  0x35, 0x14, 0x8b, 0x1f, 0xc3, 0xed, 0x7a, 0x6c, 0x78, 0x0e, 0x0e, 0x7d,
-  0x76, 0x73, 0x51, 0x86, 0x8a, 0x67, 0x82, 0x63, 0x1f, 0x00, 0x7d, 0x8f,
-  0x87, 0x4f, 0x02, 0x76, 0x00, 0x90, 0x0f, 0x98, 0x97, 0x0f, 0x10, 0x5e,
-  0x74, 0x0f, 0x04, 0x04, 0x15, 0xa3, 0x00, 0x15, 0xa5, 0xa3, 0xa1, 0x0e,
-  0x88, 0x51, 0xa1, 0xa3, 0xae, 0xaf, 0xad, 0xab, 0x4b, 0x01, 0xaf, 0xb5,
-  0xaf, 0xb2, 0x51, 0x15, 0x18, 0xb6, 0xae, 0xb8, 0x4d, 0x01, 0x11, 0xbc,
-  0x0d, 0xb8, 0x55, 0xb3, 0x15, 0x0d, 0x0b, 0x08, 0x08, 0x07, 0x09, 0x0c,
-  0x15, 0xb2, 0x01, 0x0a, 0x0a, 0xbe, 0x43, 0xb4, 0xbc, 0x15, 0x06, 0xab,
-  0xd1, 0xd3, 0x54, 0xd7, 0x1a, 0x15, 0x05, 0xdc, 0xd5, 0xd2, 0xd4, 0x57,
-  0xae, 0x18, 0xe8, 0xbb, 0xae, 0xe2, 0x42, 0x01, 0x16, 0xe5, 0xe6, 0xd7,
-  0xa3, 0xec, 0xee, 0xec, 0x48, 0xd6, 0x15, 0x12, 0xf8, 0x15, 0x0a, 0xa3,
-  0xc5, 0x01, 0x1b, 0xec, 0x1d, 0xc1, 0x47, 0x01, 0xdf, 0x85, 0x7e, 0x15,
-  0x36, 0x6c, 0x90, 0x12, 0x90, 0xda, 0x16, 0x84, 0x17, 0x68, 0x6d, 0xc0,
-  0xf0, 0x70, 0xe1, 0x06, 0x0b, 0x02, 0xab, 0x5d, 0xa0, 0xc0, 0xd1, 0x5a,
-  0x06, 0x5a, 0x11, 0x25, 0x74, 0xe0, 0xc0, 0x41, 0x81, 0x45, 0x72, 0xf7,
-  0x14, 0x60, 0xe8, 0x38, 0x4a, 0x83, 0xc4, 0x68, 0x09, 0x03, 0x9a, 0x44,
-  0x99, 0x52, 0x41, 0x47, 0x0f, 0xfe, 0x12, 0x6e, 0x9b, 0xa0, 0x41, 0x1a,
-  0xcd, 0x11, 0x24, 0xdb, 0x0a, 0xfa, 0xa4, 0x45, 0xd1, 0x27, 0xb9, 0x62,
-  0xb3, 0xb8, 0x28, 0xdd, 0xe2, 0x24, 0x08, 0x00, 0x21, 0xf9, 0x04, 0x09,
-  0x0f, 0x00, 0x20, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x20,
-  0x00, 0x00, 0x06, 0xff, 0x40, 0x90, 0x70, 0x48, 0x2c, 0x1a, 0x8f, 0xc8,
-  0xa4, 0x72, 0xc9, 0x6c, 0x3a, 0x9f, 0xcc, 0x40, 0x40, 0x29, 0x85, 0x82,
-  0x02, 0x0f, 0xa9, 0x76, 0x2b, 0xcd, 0x5a, 0x03, 0x83, 0xec, 0xe3, 0xa1,
-  0x20, 0x8f, 0xb1, 0x83, 0xc1, 0xf4, 0x09, 0x16, 0x9b, 0xcb, 0xe2, 0xf4,
-  0xda, 0xd9, 0x1e, 0xbf, 0xed, 0x63, 0x35, 0x14, 0x8b, 0x1f, 0xc3, 0xed,
-  0x7a, 0x6c, 0x78, 0x0e, 0x0e, 0x7d, 0x76, 0x73, 0x51, 0x86, 0x8a, 0x67,
-  0x82, 0x63, 0x1f, 0x00, 0x7d, 0x8f, 0x87, 0x4f, 0x02, 0x76, 0x00, 0x90,
-  0x0f, 0x98, 0x97, 0x0f, 0x10, 0x5e, 0x74, 0x0f, 0x04, 0x04, 0x15, 0xa3,
-  0x00, 0x15, 0xa5, 0xa3, 0xa1, 0x0e, 0x88, 0x51, 0xa1, 0xa3, 0xae, 0xaf,
-  0xad, 0xab, 0x4b, 0x01, 0xaf, 0xb5, 0xaf, 0xb2, 0x51, 0x15, 0x18, 0xb6,
-  0xae, 0xb8, 0x4d, 0x01, 0x11, 0xbc, 0x0d, 0x88, 0x5a, 0x74, 0x15, 0x0d,
-  0x0b, 0x08, 0x08, 0x07, 0x09, 0x0c, 0x15, 0x73, 0x01, 0x0a, 0xd2, 0xbe,
-  0x45, 0xb4, 0xbc, 0x15, 0x06, 0xd0, 0xd3, 0xb9, 0xbc, 0x1a, 0x15, 0x05,
-  0x0a, 0x6b, 0xd1, 0xe1, 0xdc, 0xba, 0x18, 0xe7, 0xaf, 0xe4, 0x57, 0x16,
-  0xea, 0x54, 0xd7, 0xae, 0xea, 0x01, 0x1b, 0xed, 0x49, 0xd6, 0x15, 0x12,
-  0xf6, 0x15, 0x0a, 0xa3, 0x55, 0xf2, 0xf4, 0x48, 0xf6, 0x28, 0xd8, 0xbb,
-  0xb0, 0xaf, 0xc2, 0x86, 0x0d, 0x52, 0xe6, 0x51, 0xdb, 0x52, 0xf0, 0x02,
-  0xad, 0x0d, 0x18, 0x18, 0x22, 0xdc, 0xc0, 0xce, 0x57, 0x80, 0x0b, 0x14,
-  0x32, 0x5a, 0xcb, 0x40, 0xcb, 0xa1, 0x84, 0x0e, 0x1c, 0x38, 0x28, 0x98,
-  0xb8, 0xed, 0x48, 0x34, 0x0c, 0x1a, 0x47, 0x69, 0x78, 0x18, 0xcd, 0xe0,
-  0xbc, 0x91, 0x25, 0x4d, 0x4a, 0xd3, 0xe8, 0x81, 0x9f, 0xc1, 0x71, 0x13,
-  0x34, 0x48, 0x8b, 0x09, 0x70, 0xe6, 0xb8, 0x0d, 0x70, 0xba, 0x7e, 0x4e,
-  0xab, 0x12, 0x85, 0x8b, 0xd1, 0x2d, 0x4e, 0x82, 0x00, 0x00, 0x3b
-};
-unsigned int kitty_gif_gif_len = 3155;
-
-// 2. Правильна структура для LVGL v9
-const lv_image_dsc_t kitty_gif = {
-  .header.cf = LV_COLOR_FORMAT_RAW,  // <--- ОСЬ ВОНО! RAW!
-  .header.magic = LV_IMAGE_HEADER_MAGIC,
-  .header.w = 0,    // Для RAW розміри тут ігноруються, декодер сам їх знайде у файлі
-  .header.h = 0, 
-  .header.flags = 0,
-  
-  // 3. Вкажіть точний розмір (sizeof)
-  .data_size = sizeof(kitty_gif_map), 
-  
-  // 4. Посилання на масив
-  .data = kitty_gif_map, 
-};
@@ -1,7 +1,9 @@
 #include "driver/spi_common.h"
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "sdkconfig.h"
 
 #include "esp_lcd_ili9341.h"
 #include "esp_lcd_panel_io.h"
@@ -12,6 +14,12 @@
 
 #include "esp_lvgl_port.h"
 
+#include "boot_report.h"
+#include "lcd.h"
+#include "lcd_flush.h"
+#include "lcd_touch.h"
+#include "power_policy.h"
+
 #define TAG "LCD"
 
 #define LCD_HRES 320
@@ -23,9 +31,15 @@
 
 #define SPI_PORT SPI2_HOST
 
+// Height of the internal bounce buffer used with PSRAM frame buffers
+#define LCD_TRANS_LINES 20
+
 #define DC_PIN 9
 #define RESET_PIN 7
 
+// XPT2046 PENIRQ, active low
+#define TOUCH_IRQ_PIN 17
+
 esp_err_t panel_init(esp_lcd_panel_io_handle_t *io_handle,
                      esp_lcd_panel_handle_t *panel_handle) {
   ESP_LOGI(TAG, "Initialize SPI bus");
@@ -34,6 +48,7 @@ esp_err_t panel_init(esp_lcd_panel_io_handle_t *io_handle,
   ESP_RETURN_ON_ERROR(
       spi_bus_initialize(SPI_PORT, &bus_config, SPI_DMA_CH_AUTO), TAG,
       "SPI bus was not initialized");
+  boot_mark(BOOT_PHASE_SPI_BUS);
 
   ESP_LOGI(TAG, "Install panel IO");
   const esp_lcd_panel_io_spi_config_t io_config =
@@ -53,6 +68,7 @@ esp_err_t panel_init(esp_lcd_panel_io_handle_t *io_handle,
 
   ret = esp_lcd_panel_reset(*panel_handle);
   ESP_GOTO_ON_ERROR(ret, err, TAG, "Panel was not reset");
+  boot_mark(BOOT_PHASE_PANEL_RESET);
 
   ret = esp_lcd_panel_init(*panel_handle);
   ESP_GOTO_ON_ERROR(ret, err, TAG, "Panel was not initialized");
@@ -63,9 +79,8 @@ esp_err_t panel_init(esp_lcd_panel_io_handle_t *io_handle,
   ret = esp_lcd_panel_swap_xy(*panel_handle, true);
   ESP_GOTO_ON_ERROR(ret, err, TAG, "Panel axis ware not swapped");
 
-  ret = esp_lcd_panel_disp_on_off(*panel_handle, true);
-  ESP_GOTO_ON_ERROR(ret, err, TAG, "Panel was not turned on");
-
+  // The panel stays off until the first frame is flushed, so the power-on
+  // content of the panel RAM is never shown
   return ESP_OK;
 
 err:
@@ -74,20 +89,39 @@ err:
   return ret;
 }
 
-esp_err_t lvgl_init(esp_lcd_panel_io_handle_t *io_handle,
-                    esp_lcd_panel_handle_t *panel_handle,
-                    lv_display_t **disp_handle,
-                    esp_lcd_touch_handle_t *touch_handle) {
-  const lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
-  ESP_RETURN_ON_ERROR(lvgl_port_init(&lvgl_cfg), TAG,
-                      "LGVL port was not initialized");
+static esp_lcd_panel_io_handle_t panel_io;
+static esp_lcd_panel_handle_t panel;
+static size_t buffer_internal_bytes;
 
-  /* Add LCD screen */
-  const lvgl_port_display_cfg_t disp_cfg = {
-      .io_handle = *io_handle,
-      .panel_handle = *panel_handle,
-      .buffer_size = 320 * 40 * sizeof(uint16_t),
-      .double_buffer = true,
+static bool render_locked;
+
+static void on_refr_ready(lv_event_t *e) { boot_mark(BOOT_PHASE_FIRST_FLUSH); }
+
+// Full CPU clock only while LVGL has something to draw
+static void on_render_start(lv_event_t *e) {
+  if (!render_locked) {
+    power_policy_acquire(POWER_ACT_LVGL);
+    render_locked = true;
+  }
+}
+
+static void on_render_ready(lv_event_t *e) {
+  if (render_locked) {
+    power_policy_release(POWER_ACT_LVGL);
+    render_locked = false;
+  }
+}
+
+static esp_err_t add_display(const lcd_buffer_strategy_t *strategy,
+                             lv_display_t **disp_handle) {
+  const bool full_frame = strategy->mode != LCD_BUFFER_PARTIAL;
+
+  // buffer_size and trans_size are in pixels
+  lvgl_port_display_cfg_t disp_cfg = {
+      .io_handle = panel_io,
+      .panel_handle = panel,
+      .buffer_size = LCD_HRES * (full_frame ? LCD_VRES : strategy->lines),
+      .double_buffer = strategy->double_buffer,
       .hres = LCD_HRES,
       .vres = LCD_VRES,
       .monochrome = false,
@@ -99,18 +133,51 @@ esp_err_t lvgl_init(esp_lcd_panel_io_handle_t *io_handle,
           },
       .flags =
           {
-              .buff_dma = true,
-              .swap_bytes = true,
+              .buff_dma = !full_frame,
+              .buff_spiram = full_frame,
+              .swap_bytes = full_frame,
+              .full_refresh = strategy->mode == LCD_BUFFER_FULL_PSRAM,
+              .direct_mode = strategy->mode == LCD_BUFFER_DIRECT,
           },
   };
+
+  // PSRAM is not DMA capable; flushes are copied through an internal
+  // buffer of this many pixels
+  if (full_frame)
+    disp_cfg.trans_size = LCD_HRES * LCD_TRANS_LINES;
+
+  size_t free_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
   *disp_handle = lvgl_port_add_disp(&disp_cfg);
+  ESP_RETURN_ON_FALSE(*disp_handle, ESP_ERR_NO_MEM, TAG,
+                      "Display was not added");
+  buffer_internal_bytes =
+      free_before - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
+  // Bands go through the pipelined flush, which also swaps the bytes
+  if (!full_frame)
+    ESP_RETURN_ON_ERROR(
+        lcd_flush_attach(*disp_handle, panel_io, LCD_HRES, LCD_VRES), TAG,
+        "Flush pipeline was not attached");
+
+  lv_display_add_event_cb(*disp_handle, on_refr_ready, LV_EVENT_REFR_READY,
+                          NULL);
+  lv_display_add_event_cb(*disp_handle, on_render_start,
+                          LV_EVENT_RENDER_START, NULL);
+  lv_display_add_event_cb(*disp_handle, on_render_ready,
+                          LV_EVENT_RENDER_READY, NULL);
+  return ESP_OK;
+}
 
-  const lvgl_port_touch_cfg_t touch_cfg = {
-      .disp = *disp_handle,
-      .handle = *touch_handle,
-  };
+esp_err_t lvgl_init(const lcd_buffer_strategy_t *strategy,
+                    lv_display_t **disp_handle) {
+  const lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+  ESP_RETURN_ON_ERROR(lvgl_port_init(&lvgl_cfg), TAG,
+                      "LGVL port was not initialized");
 
-  lvgl_port_add_touch(&touch_cfg);
+  /* Add LCD screen */
+  ESP_RETURN_ON_ERROR(add_display(strategy, disp_handle), TAG,
+                      "LCD screen was not added");
+  boot_mark(BOOT_PHASE_LVGL_READY);
 
   return ESP_OK;
 }
@@ -134,38 +201,102 @@ esp_err_t touch_init(esp_lcd_touch_handle_t *tp) {
       ESP_LCD_TOUCH_IO_SPI_XPT2046_CONFIG(16);
   ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)SPI3_HOST,
                                            &tp_io_config, &tp_io_handle));
+  lcd_touch_track_io(tp_io_handle);
 
   esp_lcd_touch_config_t tp_cfg = {
       .x_max = LCD_VRES,
       .y_max = LCD_HRES,
       .rst_gpio_num = -1,
-      .int_gpio_num = -1,
+      .int_gpio_num = TOUCH_IRQ_PIN,
+      .levels =
+          {
+              .interrupt = 0,
+          },
       .flags =
           {
               .swap_xy = true,
               .mirror_x = true,
               .mirror_y = true,
           },
+      .interrupt_callback = lcd_touch_on_penirq,
   };
 
   ESP_LOGI(TAG, "Initialize touch controller XPT2046");
   return esp_lcd_touch_new_spi_xpt2046(tp_io_handle, &tp_cfg, tp);
 }
 
-esp_err_t lcd_init(lv_display_t **disp_handle,
-                   esp_lcd_touch_handle_t *touch_handle) {
-  esp_lcd_panel_io_handle_t io_handle = NULL;
-  esp_lcd_panel_handle_t panel_handle = NULL;
+void lcd_default_buffer_strategy(lcd_buffer_strategy_t *out) {
+  *out = (lcd_buffer_strategy_t){
+#if CONFIG_LCD_DRAW_BUFFER_FULL_PSRAM
+      .mode = LCD_BUFFER_FULL_PSRAM,
+#elif CONFIG_LCD_DRAW_BUFFER_DIRECT
+      .mode = LCD_BUFFER_DIRECT,
+#else
+      .mode = LCD_BUFFER_PARTIAL,
+      .lines = CONFIG_LCD_DRAW_BUFFER_LINES,
+#endif
+#if CONFIG_LCD_DRAW_BUFFER_DOUBLE
+      .double_buffer = true,
+#endif
+  };
+}
+
+esp_err_t lcd_display_init(lv_display_t **disp_handle) {
+  lcd_buffer_strategy_t strategy;
+  lcd_default_buffer_strategy(&strategy);
 
-  ESP_RETURN_ON_ERROR(panel_init(&io_handle, &panel_handle), TAG,
+  ESP_RETURN_ON_ERROR(panel_init(&panel_io, &panel), TAG,
                       "Panel was not initialized");
 
+  ESP_RETURN_ON_ERROR(lvgl_init(&strategy, disp_handle), TAG,
+                      "LVGL was not initialized");
+
+  ESP_LOGI(TAG, "Draw buffers: %zu bytes of internal RAM",
+           buffer_internal_bytes);
+  return ESP_OK;
+}
+
+esp_err_t lcd_set_buffer_strategy(const lcd_buffer_strategy_t *strategy,
+                                  lv_display_t **disp_handle) {
+  if (*disp_handle) {
+    ESP_RETURN_ON_ERROR(lvgl_port_remove_disp(*disp_handle), TAG,
+                        "Display was not removed");
+    *disp_handle = NULL;
+  }
+
+  return add_display(strategy, disp_handle);
+}
+
+size_t lcd_buffer_internal_bytes(void) { return buffer_internal_bytes; }
+
+esp_err_t lcd_display_on(lv_display_t *disp_handle) {
+  // Render and flush the first frame now instead of on the next LVGL timer
+  // tick, then light the panel
+  if (lvgl_port_lock(0)) {
+    lv_refr_now(disp_handle);
+    lvgl_port_unlock();
+  }
+
+  ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(panel, true), TAG,
+                      "Panel was not turned on");
+  boot_mark(BOOT_PHASE_DISPLAY_ON);
+
+  return ESP_OK;
+}
+
+esp_err_t lcd_touch_init(lv_display_t *disp_handle,
+                         esp_lcd_touch_handle_t *touch_handle) {
   ESP_RETURN_ON_ERROR(touch_init(touch_handle), TAG,
                       "Touch was not initialized");
 
-  ESP_RETURN_ON_ERROR(
-      lvgl_init(&io_handle, &panel_handle, disp_handle, touch_handle), TAG,
-      "LVGL was not initialized");
+  // Polled only while the pen is down, not on every LVGL input period
+  esp_err_t err = ESP_ERR_TIMEOUT;
+  if (lvgl_port_lock(0)) {
+    err = lcd_touch_attach(disp_handle, *touch_handle, TOUCH_IRQ_PIN);
+    lvgl_port_unlock();
+  }
+  ESP_RETURN_ON_ERROR(err, TAG, "Touch was not added to LVGL");
+  boot_mark(BOOT_PHASE_TOUCH_READY);
 
   return ESP_OK;
 }
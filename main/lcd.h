@@ -1,5 +1,44 @@
+#ifndef LCD_H
+#define LCD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "esp_lcd_touch.h"
 #include "misc/lv_types.h"
 
-esp_err_t lcd_init(lv_display_t **disp_handle, esp_lcd_touch_handle_t *tp);
+typedef enum {
+  LCD_BUFFER_PARTIAL,    // bands of `lines` rows in internal DMA RAM
+  LCD_BUFFER_FULL_PSRAM, // full frame in PSRAM, redrawn whole every refresh
+  LCD_BUFFER_DIRECT,     // full frame in PSRAM, only dirty areas redrawn
+} lcd_buffer_mode_t;
+
+typedef struct {
+  lcd_buffer_mode_t mode;
+  uint16_t lines; // band height, LCD_BUFFER_PARTIAL only
+  bool double_buffer;
+} lcd_buffer_strategy_t;
+
+// Strategy selected in menuconfig
+void lcd_default_buffer_strategy(lcd_buffer_strategy_t *out);
+
+// Brings up the SPI bus, the panel (left dark) and the LVGL display
+esp_err_t lcd_display_init(lv_display_t **disp_handle);
+
+// Replaces the LVGL display with one drawing through `strategy`. Screens of
+// the old display are deleted with it.
+esp_err_t lcd_set_buffer_strategy(const lcd_buffer_strategy_t *strategy,
+                                  lv_display_t **disp_handle);
+
+// Internal RAM taken by the draw buffers of the current display
+size_t lcd_buffer_internal_bytes(void);
+
+// Flushes the first frame and turns the panel on
+esp_err_t lcd_display_on(lv_display_t *disp_handle);
+
+esp_err_t lcd_touch_init(lv_display_t *disp_handle,
+                         esp_lcd_touch_handle_t *touch_handle);
+
+#endif
@@ -0,0 +1,109 @@
+#include "lcd_bench.h"
+
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+#include "lcd.h"
+#include "ui.h"
+
+static const char *TAG = "LCD_BENCH";
+
+#define BENCH_FULL_FRAMES 20
+#define BENCH_CLOCK_FRAMES 50
+
+static const lcd_buffer_strategy_t strategies[] = {
+    {.mode = LCD_BUFFER_PARTIAL, .lines = 10, .double_buffer = false},
+    {.mode = LCD_BUFFER_PARTIAL, .lines = 20, .double_buffer = true},
+    {.mode = LCD_BUFFER_PARTIAL, .lines = 40, .double_buffer = true},
+    {.mode = LCD_BUFFER_PARTIAL, .lines = 80, .double_buffer = false},
+    {.mode = LCD_BUFFER_PARTIAL, .lines = 80, .double_buffer = true},
+    {.mode = LCD_BUFFER_FULL_PSRAM, .double_buffer = false},
+    {.mode = LCD_BUFFER_DIRECT, .double_buffer = true},
+};
+
+typedef struct {
+  float fps;
+  float flushes_per_frame;
+} bench_result_t;
+
+static uint32_t flushes;
+
+static void on_flush_start(lv_event_t *e) { flushes++; }
+
+static void describe(const lcd_buffer_strategy_t *s, char *buf, size_t len) {
+  const char *copies = s->double_buffer ? "x2" : "x1";
+
+  switch (s->mode) {
+  case LCD_BUFFER_PARTIAL:
+    snprintf(buf, len, "partial %u %s", s->lines, copies);
+    break;
+  case LCD_BUFFER_FULL_PSRAM:
+    snprintf(buf, len, "full psram %s", copies);
+    break;
+  case LCD_BUFFER_DIRECT:
+    snprintf(buf, len, "direct %s", copies);
+    break;
+  }
+}
+
+// Redraws the whole screen, or only the clock label, `frames` times
+static void run_scene(lv_display_t *disp, ui_state_t *ui, bool full,
+                      int frames, bench_result_t *out) {
+  flushes = 0;
+  int64_t start = esp_timer_get_time();
+
+  for (int i = 0; i < frames; i++) {
+    if (full)
+      lv_obj_invalidate(ui->screen);
+    else
+      ui_clock_update(ui, i & 1 ? "12:35" : "12:34");
+    lv_refr_now(disp);
+  }
+
+  int64_t elapsed_us = esp_timer_get_time() - start;
+  out->fps = elapsed_us > 0 ? frames * 1e6f / elapsed_us : 0;
+  out->flushes_per_frame = (float)flushes / frames;
+}
+
+void lcd_bench_run(lv_display_t **disp_handle) {
+  if (!lvgl_port_lock(0)) {
+    ESP_LOGE(TAG, "Failed to lock LVGL");
+    return;
+  }
+
+  ESP_LOGI(TAG, "%-16s %8s %9s %8s %9s %8s", "strategy", "int RAM",
+           "full fps", "flushes", "clock fps", "flushes");
+
+  for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); i++) {
+    char name[24];
+    describe(&strategies[i], name, sizeof(name));
+
+    if (lcd_set_buffer_strategy(&strategies[i], disp_handle) != ESP_OK) {
+      ESP_LOGW(TAG, "%-16s unavailable", name);
+      continue;
+    }
+    lv_display_add_event_cb(*disp_handle, on_flush_start,
+                            LV_EVENT_FLUSH_START, NULL);
+
+    // The first frame also lays out the screen; keep it out of the numbers
+    ui_state_t ui = ui_setup(*disp_handle);
+    lv_refr_now(*disp_handle);
+
+    bench_result_t full, clock;
+    run_scene(*disp_handle, &ui, true, BENCH_FULL_FRAMES, &full);
+    run_scene(*disp_handle, &ui, false, BENCH_CLOCK_FRAMES, &clock);
+
+    ESP_LOGI(TAG, "%-16s %8zu %9.1f %8.1f %9.1f %8.1f", name,
+             lcd_buffer_internal_bytes(), full.fps, full.flushes_per_frame,
+             clock.fps, clock.flushes_per_frame);
+  }
+
+  lcd_buffer_strategy_t strategy;
+  lcd_default_buffer_strategy(&strategy);
+  if (lcd_set_buffer_strategy(&strategy, disp_handle) != ESP_OK)
+    ESP_LOGE(TAG, "Failed to restore the configured draw buffers");
+
+  lvgl_port_unlock();
+}
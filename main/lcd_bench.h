@@ -0,0 +1,11 @@
+#ifndef LCD_BENCH_H
+#define LCD_BENCH_H
+
+#include "misc/lv_types.h"
+
+// Renders the dashboard with every draw buffer strategy and logs frames per
+// second, flushes per frame and internal RAM used by the buffers. Leaves
+// `disp_handle` on the menuconfig strategy with no screen loaded.
+void lcd_bench_run(lv_display_t **disp_handle);
+
+#endif
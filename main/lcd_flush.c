@@ -0,0 +1,215 @@
+#include "lcd_flush.h"
+
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lvgl.h"
+#include "power_policy.h"
+#include <stdbool.h>
+
+#define TAG "LCD_FLUSH"
+
+// Opening a window costs two parameter writes and a command, each a polling
+// transaction that first drains the DMA queue: roughly the time of sending
+// this many pixels at 40 MHz. Areas are merged while the padding is cheaper.
+#define WINDOW_COST_PX 128
+
+// Areas remembered per refresh for merging; more are left to LVGL
+#define MAX_TRACKED_AREAS 16
+
+typedef struct {
+  int x1, x2; // columns of the open window
+  int next_y; // row the panel writes next
+  bool open;
+} window_t;
+
+static esp_lcd_panel_io_handle_t panel_io;
+static int screen_vres;
+static window_t window;
+
+static TaskHandle_t render_task;
+static volatile bool dma_busy;
+static bool spi_locked; // PM lock held from the first flush until drained
+
+static lv_area_t tracked[MAX_TRACKED_AREAS];
+static int tracked_count;
+
+static lcd_flush_stats_t stats;
+
+static bool IRAM_ATTR on_color_trans_done(esp_lcd_panel_io_handle_t io,
+                                          esp_lcd_panel_io_event_data_t *edata,
+                                          void *user_ctx) {
+  BaseType_t woken = pdFALSE;
+
+  dma_busy = false;
+  lv_display_flush_ready(user_ctx);
+  if (render_task)
+    vTaskNotifyGiveFromISR(render_task, &woken);
+
+  return woken == pdTRUE;
+}
+
+static esp_err_t open_window(int x1, int y1, int x2) {
+  // The window runs to the bottom of the screen so later bands of the same
+  // area can continue it
+  const uint8_t caset[] = {x1 >> 8, x1 & 0xff, x2 >> 8, x2 & 0xff};
+  const uint8_t raset[] = {y1 >> 8, y1 & 0xff, (screen_vres - 1) >> 8,
+                           (screen_vres - 1) & 0xff};
+
+  ESP_RETURN_ON_ERROR(
+      esp_lcd_panel_io_tx_param(panel_io, LCD_CMD_CASET, caset, 4), TAG,
+      "CASET failed");
+  ESP_RETURN_ON_ERROR(
+      esp_lcd_panel_io_tx_param(panel_io, LCD_CMD_RASET, raset, 4), TAG,
+      "RASET failed");
+
+  window = (window_t){.x1 = x1, .x2 = x2, .next_y = y1, .open = true};
+  stats.windows++;
+  return ESP_OK;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area,
+                     uint8_t *px_map) {
+  const uint32_t pixels = lv_area_get_size(area);
+
+  lv_draw_sw_rgb565_swap(px_map, pixels);
+  render_task = xTaskGetCurrentTaskHandle();
+
+  // From here the task waits on the bus; the swap above is CPU time
+  const int64_t start = esp_timer_get_time();
+
+  if (!spi_locked) {
+    power_policy_acquire(POWER_ACT_SPI);
+    spi_locked = true;
+  }
+
+  int cmd = LCD_CMD_RAMWRC;
+  if (!window.open || area->x1 != window.x1 || area->x2 != window.x2 ||
+      area->y1 != window.next_y) {
+    if (open_window(area->x1, area->y1, area->x2) != ESP_OK) {
+      window.open = false;
+      lv_display_flush_ready(disp);
+      stats.dma_wait_us += esp_timer_get_time() - start;
+      return;
+    }
+    cmd = LCD_CMD_RAMWR;
+  } else {
+    stats.continued++;
+  }
+  window.next_y = area->y2 + 1;
+
+  dma_busy = true;
+  const esp_err_t err =
+      esp_lcd_panel_io_tx_color(panel_io, cmd, px_map, pixels * 2);
+  stats.dma_wait_us += esp_timer_get_time() - start;
+
+  if (err != ESP_OK) {
+    dma_busy = false;
+    window.open = false;
+    lv_display_flush_ready(disp);
+    return;
+  }
+
+  stats.flushes++;
+  stats.bytes += pixels * 2;
+}
+
+static void release_spi(void) {
+  if (spi_locked) {
+    power_policy_release(POWER_ACT_SPI);
+    spi_locked = false;
+  }
+}
+
+// Called by LVGL before it reuses a buffer that is still being sent
+static void flush_wait_cb(lv_display_t *disp) {
+  const int64_t start = esp_timer_get_time();
+
+  while (dma_busy)
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+  release_spi();
+
+  stats.dma_wait_us += esp_timer_get_time() - start;
+}
+
+static int32_t gap(int32_t a1, int32_t a2, int32_t b1, int32_t b2) {
+  if (b1 > a2)
+    return b1 - a2 - 1;
+  if (a1 > b2)
+    return a1 - b2 - 1;
+  return 0;
+}
+
+static void on_invalidate_area(lv_event_t *e) {
+  lv_area_t *area = lv_event_get_param(e);
+
+  for (int i = 0; i < tracked_count; i++) {
+    const lv_area_t *t = &tracked[i];
+
+    if (gap(area->x1, area->x2, t->x1, t->x2) > WINDOW_COST_PX ||
+        gap(area->y1, area->y2, t->y1, t->y2) > WINDOW_COST_PX)
+      continue;
+
+    const lv_area_t joined = {
+        .x1 = LV_MIN(area->x1, t->x1),
+        .y1 = LV_MIN(area->y1, t->y1),
+        .x2 = LV_MAX(area->x2, t->x2),
+        .y2 = LV_MAX(area->y2, t->y2),
+    };
+    if (lv_area_get_size(&joined) >
+        lv_area_get_size(area) + lv_area_get_size(t) + WINDOW_COST_PX)
+      continue;
+
+    // LVGL drops the tracked area as it lies inside the grown one
+    *area = joined;
+    tracked[i] = joined;
+    stats.merged_areas++;
+    return;
+  }
+
+  if (tracked_count < MAX_TRACKED_AREAS)
+    tracked[tracked_count++] = *area;
+}
+
+// Other commands (e.g. DISPON) may reach the panel between refreshes and
+// end the memory write, so every refresh starts with a fresh window
+static void on_refr_ready(lv_event_t *e) {
+  tracked_count = 0;
+  window.open = false;
+
+  // The last band may still be in flight; the SPI driver keeps the bus
+  // clock for it on its own
+  release_spi();
+}
+
+esp_err_t lcd_flush_attach(lv_display_t *disp, esp_lcd_panel_io_handle_t io,
+                           int hres, int vres) {
+  const esp_lcd_panel_io_callbacks_t cbs = {
+      .on_color_trans_done = on_color_trans_done,
+  };
+  ESP_RETURN_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(io, &cbs, disp),
+                      TAG, "DMA callback was not registered");
+
+  panel_io = io;
+  screen_vres = vres;
+  window.open = false;
+  tracked_count = 0;
+
+  lv_display_set_flush_cb(disp, flush_cb);
+  lv_display_set_flush_wait_cb(disp, flush_wait_cb);
+  lv_display_add_event_cb(disp, on_invalidate_area, LV_EVENT_INVALIDATE_AREA,
+                          NULL);
+  lv_display_add_event_cb(disp, on_refr_ready, LV_EVENT_REFR_READY, NULL);
+
+  ESP_LOGI(TAG, "Async flush attached (%dx%d)", hres, vres);
+  return ESP_OK;
+}
+
+void lcd_flush_get_stats(lcd_flush_stats_t *out) {
+  if (out)
+    *out = stats;
+}
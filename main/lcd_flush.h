@@ -0,0 +1,34 @@
+#ifndef LCD_FLUSH_H
+#define LCD_FLUSH_H
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "misc/lv_types.h"
+
+// Flush path for partial rendering that replaces the one of esp_lvgl_port.
+//
+// - The flush callback only queues the DMA and returns, so with two draw
+//   buffers LVGL renders the next band while the previous one is on the bus.
+//   The render task then sleeps on the DMA completion instead of spinning.
+// - A band that continues the previous one (same columns, next row) is sent
+//   with RAMWRC inside the already open window, skipping CASET/RASET.
+// - Invalidated areas that are close enough for the padding to cost less
+//   than a new window are merged before LVGL stores them.
+
+typedef struct {
+  uint32_t flushes;      // bands queued for DMA
+  uint32_t windows;      // CASET/RASET windows opened
+  uint32_t continued;    // bands appended to the open window with RAMWRC
+  uint32_t merged_areas; // invalidated areas grown to absorb a neighbour
+  uint64_t bytes;        // pixel data sent
+  int64_t dma_wait_us;   // render task blocked on the bus
+} lcd_flush_stats_t;
+
+esp_err_t lcd_flush_attach(lv_display_t *disp, esp_lcd_panel_io_handle_t io,
+                           int hres, int vres);
+
+void lcd_flush_get_stats(lcd_flush_stats_t *out);
+
+#endif
@@ -0,0 +1,157 @@
+#include "lcd_touch.h"
+
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include "lvgl.h"
+
+#define TAG "LCD_TOUCH"
+
+// Released reads before polling stops, so LVGL sees the release and the
+// click it completes
+#define RELEASE_READS 2
+
+static esp_err_t (*io_rx_param)(esp_lcd_panel_io_t *io, int lcd_cmd,
+                                void *param, size_t param_size);
+static esp_err_t (*io_tx_param)(esp_lcd_panel_io_t *io, int lcd_cmd,
+                                const void *param, size_t param_size);
+
+static lv_indev_t *indev;
+static int penirq_pin = -1;
+static int idle_reads;
+static volatile bool resume_pending;
+
+static lcd_touch_stats_t stats;
+
+static esp_err_t counted_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd,
+                                  void *param, size_t param_size) {
+  const int64_t start = esp_timer_get_time();
+  esp_err_t err = io_rx_param(io, lcd_cmd, param, param_size);
+
+  stats.transactions++;
+  stats.bus_us += esp_timer_get_time() - start;
+  return err;
+}
+
+static esp_err_t counted_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd,
+                                  const void *param, size_t param_size) {
+  const int64_t start = esp_timer_get_time();
+  esp_err_t err = io_tx_param(io, lcd_cmd, param, param_size);
+
+  stats.transactions++;
+  stats.bus_us += esp_timer_get_time() - start;
+  return err;
+}
+
+void lcd_touch_track_io(esp_lcd_panel_io_handle_t io) {
+  io_rx_param = io->rx_param;
+  io_tx_param = io->tx_param;
+  io->rx_param = counted_rx_param;
+  io->tx_param = counted_tx_param;
+}
+
+static bool pen_down(void) {
+  return penirq_pin < 0 || gpio_get_level(penirq_pin) == 0;
+}
+
+static void read_cb(lv_indev_t *dev, lv_indev_data_t *data) {
+  esp_lcd_touch_handle_t tp = lv_indev_get_user_data(dev);
+  uint16_t x, y;
+  uint8_t count = 0;
+
+  esp_lcd_touch_read_data(tp);
+  stats.reads++;
+
+  if (esp_lcd_touch_get_coordinates(tp, &x, &y, NULL, &count, 1) &&
+      count > 0) {
+    data->point.x = x;
+    data->point.y = y;
+    data->state = LV_INDEV_STATE_PRESSED;
+    idle_reads = 0;
+    return;
+  }
+
+  data->state = LV_INDEV_STATE_RELEASED;
+
+  // An edge that arrives after this check resumes the timer again
+  if (++idle_reads >= RELEASE_READS && !pen_down()) {
+    lv_timer_pause(lv_indev_get_read_timer(dev));
+    stats.suspends++;
+  }
+}
+
+// Runs in the timer service task, where the LVGL lock may be taken
+static void resume_polling(void *arg1, uint32_t arg2) {
+  if (!lvgl_port_lock(0))
+    return;
+
+  resume_pending = false;
+  // Conversions also pull PENIRQ low; only a pen that is still down counts
+  if (indev && pen_down()) {
+    lv_timer_t *timer = lv_indev_get_read_timer(indev);
+    idle_reads = 0;
+    lv_timer_resume(timer);
+    lv_timer_ready(timer);
+    stats.wakeups++;
+  }
+
+  lvgl_port_unlock();
+}
+
+void IRAM_ATTR lcd_touch_on_penirq(esp_lcd_touch_handle_t tp) {
+  BaseType_t woken = pdFALSE;
+
+  if (resume_pending)
+    return;
+
+  resume_pending = true;
+  if (xTimerPendFunctionCallFromISR(resume_polling, NULL, 0, &woken) !=
+      pdPASS)
+    resume_pending = false;
+
+  if (woken == pdTRUE)
+    portYIELD_FROM_ISR();
+}
+
+esp_err_t lcd_touch_attach(lv_display_t *disp, esp_lcd_touch_handle_t tp,
+                           int irq_pin) {
+  indev = lv_indev_create();
+  ESP_RETURN_ON_FALSE(indev, ESP_ERR_NO_MEM, TAG, "Input device not created");
+
+  lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+  lv_indev_set_read_cb(indev, read_cb);
+  lv_indev_set_display(indev, disp);
+  lv_indev_set_user_data(indev, tp);
+
+  penirq_pin = irq_pin;
+  stats.since_us = esp_timer_get_time();
+
+  // Without PENIRQ keep the usual polling
+  if (irq_pin >= 0) {
+    gpio_set_pull_mode(irq_pin, GPIO_PULLUP_ONLY);
+    lv_timer_pause(lv_indev_get_read_timer(indev));
+  }
+
+  ESP_LOGI(TAG, "Touch %s", irq_pin >= 0 ? "on PENIRQ" : "polled");
+  return ESP_OK;
+}
+
+void lcd_touch_get_stats(lcd_touch_stats_t *out) {
+  if (out)
+    *out = stats;
+}
+
+uint32_t lcd_touch_transactions_per_hour(const lcd_touch_stats_t *s) {
+  const int64_t elapsed_us = esp_timer_get_time() - s->since_us;
+
+  if (s->since_us == 0 || elapsed_us <= 0)
+    return 0;
+  return (uint32_t)((uint64_t)s->transactions * 3600000000ULL /
+                    (uint64_t)elapsed_us);
+}
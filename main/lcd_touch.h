@@ -0,0 +1,41 @@
+#ifndef LCD_TOUCH_H
+#define LCD_TOUCH_H
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_touch.h"
+#include "misc/lv_types.h"
+
+// PENIRQ-driven LVGL input device for the XPT2046, replacing the one of
+// esp_lvgl_port. The indev read timer is paused while the pen is up, so the
+// controller is only polled over SPI between a PENIRQ falling edge and the
+// release that follows it. SPI transactions on the touch bus are counted.
+
+typedef struct {
+  uint32_t reads;        // indev reads, each one driver read_data
+  uint32_t transactions; // SPI transactions issued by the touch driver
+  int64_t bus_us;        // time spent in those transactions
+  uint32_t wakeups;      // PENIRQ edges that resumed polling
+  uint32_t suspends;     // times polling was paused after a release
+  int64_t since_us;      // counting started
+} lcd_touch_stats_t;
+
+// Counts the SPI transactions made through `io`; call before the touch
+// driver is created on it
+void lcd_touch_track_io(esp_lcd_panel_io_handle_t io);
+
+// PENIRQ callback for esp_lcd_touch_config_t.interrupt_callback (ISR)
+void lcd_touch_on_penirq(esp_lcd_touch_handle_t tp);
+
+// Creates the input device, initially paused. Call with the LVGL lock held.
+esp_err_t lcd_touch_attach(lv_display_t *disp, esp_lcd_touch_handle_t tp,
+                           int irq_pin);
+
+void lcd_touch_get_stats(lcd_touch_stats_t *out);
+
+// SPI transactions per hour of device time since attach
+uint32_t lcd_touch_transactions_per_hour(const lcd_touch_stats_t *stats);
+
+#endif
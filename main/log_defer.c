@@ -0,0 +1,285 @@
+#include "log_defer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "LOG_DEFER";
+
+// 72 bytes each on the device; a power of two
+#define LOG_DEFER_SLOTS 64
+#define LOG_DEFER_LINE_MAX 160
+
+// What ESP_LOGx prints, with the time of the call
+#define LOG_DEFER_LINE_FORMAT "%s%c (%lu) %s: %s" LOG_RESET_COLOR "\n"
+
+// Bounded multi-producer queue after Dmitry Vyukov. `state` is the slot's
+// sequence number minus its index, so the zeroed ring is empty before
+// log_defer_start: a producer at position pos finds pos - index when the
+// slot is free and leaves pos - index + 1; the writer hands it back for the
+// next lap with pos - index + LOG_DEFER_SLOTS.
+typedef struct {
+  atomic_uint state;
+  uint8_t n_args;
+  uint32_t time_ms;
+  const char *tag;
+  const log_defer_fmt_t *fmt;
+  log_defer_arg_t args[LOG_DEFER_MAX_ARGS];
+} log_defer_slot_t;
+
+static log_defer_slot_t slots[LOG_DEFER_SLOTS];
+static atomic_uint enqueue_pos;
+static atomic_uint dequeue_pos;
+static atomic_uint dropped;
+static TaskHandle_t writer_task;
+static log_defer_stats_t stats = {.capacity = LOG_DEFER_SLOTS};
+
+void log_defer_write(const log_defer_fmt_t *fmt, const char *tag,
+                     const log_defer_arg_t *args, uint8_t n_args) {
+  // Filtered out records would only take a slot, or count as dropped
+  if (fmt->level > esp_log_level_get(tag))
+    return;
+
+  unsigned pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+  log_defer_slot_t *slot;
+  unsigned free_state;
+
+  for (;;) {
+    slot = &slots[pos % LOG_DEFER_SLOTS];
+    free_state = pos - pos % LOG_DEFER_SLOTS;
+    const int diff =
+        (int)(atomic_load_explicit(&slot->state, memory_order_acquire) -
+              free_state);
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // Still holds the record of the previous lap
+      atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+      return;
+    } else {
+      pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+    }
+  }
+
+  if (n_args > LOG_DEFER_MAX_ARGS)
+    n_args = LOG_DEFER_MAX_ARGS;
+  slot->fmt = fmt;
+  slot->tag = tag;
+  slot->time_ms = esp_log_timestamp();
+  slot->n_args = n_args;
+  memcpy(slot->args, args, n_args * sizeof(args[0]));
+  atomic_store_explicit(&slot->state, free_state + 1, memory_order_release);
+
+  if (writer_task)
+    xTaskNotifyGive(writer_task);
+}
+
+// Writer side: copies out the oldest record, if it is complete
+static bool take(log_defer_slot_t *out) {
+  const unsigned pos =
+      atomic_load_explicit(&dequeue_pos, memory_order_relaxed);
+  log_defer_slot_t *slot = &slots[pos % LOG_DEFER_SLOTS];
+  const unsigned base = pos - pos % LOG_DEFER_SLOTS;
+
+  if (atomic_load_explicit(&slot->state, memory_order_acquire) != base + 1)
+    return false;
+
+  out->fmt = slot->fmt;
+  out->tag = slot->tag;
+  out->time_ms = slot->time_ms;
+  out->n_args = slot->n_args;
+  memcpy(out->args, slot->args, sizeof(out->args));
+  atomic_store_explicit(&slot->state, base + LOG_DEFER_SLOTS,
+                        memory_order_release);
+  atomic_store_explicit(&dequeue_pos, pos + 1, memory_order_relaxed);
+  return true;
+}
+
+// Bytes an integer of printf length modifier `len` (n chars) had
+static unsigned int_bytes(const char *len, size_t n) {
+  if (n == 0)
+    return sizeof(int);
+  switch (len[0]) {
+  case 'h':
+    return n == 2 ? 1 : 2;
+  case 'l':
+    return n == 2 ? 8 : sizeof(long);
+  case 'z':
+    return sizeof(size_t);
+  default:
+    return 8;
+  }
+}
+
+// printf with the stored arguments, one conversion at a time. Integers are
+// printed through "ll", as they were stored as 64 bits; unsigned ones are
+// cut back to their size first, so %x of -1 still shows ffffffff.
+static void format(char *out, size_t size, const char *fmt,
+                   const log_defer_arg_t *args, uint8_t n_args) {
+  size_t len = 0;
+  uint8_t next = 0;
+
+  while (*fmt && len + 1 < size) {
+    if (*fmt != '%' || fmt[1] == '%') {
+      out[len++] = *fmt;
+      fmt += *fmt == '%' ? 2 : 1;
+      continue;
+    }
+
+    const char *start = fmt++;
+    fmt += strspn(fmt, "-+ #0");
+    fmt += strspn(fmt, "0123456789");
+    if (*fmt == '.') {
+      fmt++;
+      fmt += strspn(fmt, "0123456789");
+    }
+    const char *length = fmt;
+    const size_t length_len = strspn(fmt, "hljztL");
+    const size_t prefix = (size_t)(length - start);
+    fmt += length_len;
+
+    char spec[16];
+    const char conv = *fmt++;
+    if (conv == '\0' || next >= n_args || prefix + 4 > sizeof(spec))
+      break;
+    memcpy(spec, start, prefix);
+
+    const log_defer_arg_t a = args[next++];
+    char *dst = out + len;
+    const size_t room = size - len;
+    int n;
+
+    switch (conv) {
+    case 'd':
+    case 'i':
+      memcpy(spec + prefix, "ll", 2);
+      spec[prefix + 2] = conv;
+      spec[prefix + 3] = '\0';
+      n = snprintf(dst, room, spec, (long long)a.i);
+      break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X': {
+      const unsigned bytes = int_bytes(length, length_len);
+      uint64_t v = (uint64_t)a.i;
+      if (bytes < 8)
+        v &= ((uint64_t)1 << (8 * bytes)) - 1;
+      memcpy(spec + prefix, "ll", 2);
+      spec[prefix + 2] = conv;
+      spec[prefix + 3] = '\0';
+      n = snprintf(dst, room, spec, (unsigned long long)v);
+      break;
+    }
+    case 'c':
+      spec[prefix] = conv;
+      spec[prefix + 1] = '\0';
+      n = snprintf(dst, room, spec, (int)a.i);
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+      spec[prefix] = conv;
+      spec[prefix + 1] = '\0';
+      n = snprintf(dst, room, spec, a.f);
+      break;
+    case 's':
+      spec[prefix] = conv;
+      spec[prefix + 1] = '\0';
+      n = snprintf(dst, room, spec, a.p ? (const char *)a.p : "(null)");
+      break;
+    case 'p':
+      spec[prefix] = conv;
+      spec[prefix + 1] = '\0';
+      n = snprintf(dst, room, spec, a.p);
+      break;
+    default:
+      n = -1;
+      break;
+    }
+    if (n < 0)
+      break;
+    len += (size_t)n < room ? (size_t)n : room - 1;
+  }
+  out[len] = '\0';
+}
+
+// LOG_COLOR_x expand to nothing with CONFIG_LOG_COLORS off
+static const char *level_color(esp_log_level_t level) {
+#if CONFIG_LOG_COLORS
+  switch (level) {
+  case ESP_LOG_ERROR:
+    return LOG_COLOR_E;
+  case ESP_LOG_WARN:
+    return LOG_COLOR_W;
+  case ESP_LOG_INFO:
+    return LOG_COLOR_I;
+  default:
+    return "";
+  }
+#else
+  return "";
+#endif
+}
+
+static void writer_loop(void *param) {
+  static const char letters[] = "NEWIDV";
+  static log_defer_slot_t rec;
+  char line[LOG_DEFER_LINE_MAX];
+  unsigned reported = 0;
+
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    for (;;) {
+      const unsigned waiting =
+          atomic_load_explicit(&enqueue_pos, memory_order_relaxed) -
+          atomic_load_explicit(&dequeue_pos, memory_order_relaxed);
+      if (waiting > stats.peak)
+        stats.peak = waiting;
+
+      const unsigned lost =
+          atomic_load_explicit(&dropped, memory_order_relaxed);
+      if (lost != reported) {
+        ESP_LOGW(TAG, "%u records dropped, ring full", lost - reported);
+        reported = lost;
+      }
+
+      if (!take(&rec))
+        break;
+
+      const esp_log_level_t level = rec.fmt->level;
+      format(line, sizeof(line), rec.fmt->fmt, rec.args, rec.n_args);
+      esp_log_write(level, rec.tag, LOG_DEFER_LINE_FORMAT, level_color(level),
+                    letters[level], (unsigned long)rec.time_ms, rec.tag, line);
+      stats.written++;
+    }
+  }
+}
+
+bool log_defer_start(void) {
+  if (xTaskCreate(writer_loop, "log_defer", 3072, NULL, tskIDLE_PRIORITY + 1,
+                  &writer_task) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start task");
+    return false;
+  }
+  // Records from before the task existed
+  xTaskNotifyGive(writer_task);
+  return true;
+}
+
+void log_defer_get_stats(log_defer_stats_t *out) {
+  if (out == NULL)
+    return;
+  *out = stats;
+  out->dropped = atomic_load_explicit(&dropped, memory_order_relaxed);
+}
@@ -0,0 +1,130 @@
+#ifndef LOG_DEFER_H
+#define LOG_DEFER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_log.h"
+
+// Deferred console logging for paths whose timing matters, such as the
+// sensor bus tasks. LOG_DEFER_I and friends take the same arguments as
+// ESP_LOGI but only store a pointer to their format, which lives in flash,
+// the capture time, the tag and the raw argument values in a lock-free
+// ring. A low priority task formats the records and hands them to
+// esp_log_write, so a USB console that is slow, or has no host reading it,
+// stalls that task and nobody else. Records that find the ring full are
+// dropped and counted; the writer reports the count.
+//
+// At most LOG_DEFER_MAX_ARGS arguments, of integer, floating or char or
+// void pointer type; cast other pointers to (void *). A %s argument is
+// stored as the pointer: it must be a literal or other string that is never
+// freed or changed, like esp_err_to_name() or a task name. Records below
+// the tag's esp_log_level_get level are not stored. Task context only.
+
+#define LOG_DEFER_MAX_ARGS 6
+
+// A call site: the id of its records
+typedef struct {
+  esp_log_level_t level;
+  const char *fmt;
+} log_defer_fmt_t;
+
+typedef union {
+  int64_t i;
+  double f;
+  const void *p;
+} log_defer_arg_t;
+
+typedef struct {
+  uint32_t written;  // records formatted and written
+  uint32_t dropped;  // the ring was full
+  uint32_t peak;     // most records waiting at once
+  uint32_t capacity;
+} log_defer_stats_t;
+
+// Starts the writer task. Records logged before it runs wait in the ring.
+bool log_defer_start(void);
+
+// `tag` is kept as the pointer, like %s arguments. Records the tag's level
+// filters out are discarded here, before they take a slot.
+void log_defer_write(const log_defer_fmt_t *fmt, const char *tag,
+                     const log_defer_arg_t *args, uint8_t n_args);
+
+void log_defer_get_stats(log_defer_stats_t *out);
+
+#define LOG_DEFER_E(tag, fmt, ...)                                             \
+  LOG_DEFER_LEVEL(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define LOG_DEFER_W(tag, fmt, ...)                                             \
+  LOG_DEFER_LEVEL(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define LOG_DEFER_I(tag, fmt, ...)                                             \
+  LOG_DEFER_LEVEL(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+
+// The format is checked like printf's, in a call that is never made. The
+// leading element keeps the array non-empty for a call without arguments.
+#define LOG_DEFER_LEVEL(level, tag, fmt, ...)                                  \
+  do {                                                                         \
+    static const log_defer_fmt_t log_defer_site = {level, fmt};               \
+    const log_defer_arg_t log_defer_args[] = {{0},                            \
+                                              LOG_DEFER_ARGS(__VA_ARGS__)};   \
+    if (0)                                                                     \
+      log_defer_check(fmt, ##__VA_ARGS__);                                     \
+    log_defer_write(&log_defer_site, tag, log_defer_args + 1,                  \
+                    LOG_DEFER_NARGS(__VA_ARGS__));                             \
+  } while (0)
+
+static inline __attribute__((format(printf, 1, 2))) void
+log_defer_check(const char *fmt, ...) {}
+
+static inline log_defer_arg_t log_defer_int(int64_t v) {
+  return (log_defer_arg_t){.i = v};
+}
+static inline log_defer_arg_t log_defer_double(double v) {
+  return (log_defer_arg_t){.f = v};
+}
+static inline log_defer_arg_t log_defer_ptr(const void *v) {
+  return (log_defer_arg_t){.p = v};
+}
+// Any other argument type fails the build, rather than a pointer being
+// converted to an integer
+log_defer_arg_t log_defer_unsupported(const void *v) __attribute__((
+    error("LOG_DEFER argument type not supported, cast pointers to void *")));
+
+#define LOG_DEFER_ARG(x)                                                       \
+  _Generic((x),                                                                \
+      _Bool: log_defer_int,                                                    \
+      char: log_defer_int,                                                     \
+      signed char: log_defer_int,                                              \
+      unsigned char: log_defer_int,                                            \
+      short: log_defer_int,                                                    \
+      unsigned short: log_defer_int,                                           \
+      int: log_defer_int,                                                      \
+      unsigned: log_defer_int,                                                 \
+      long: log_defer_int,                                                     \
+      unsigned long: log_defer_int,                                            \
+      long long: log_defer_int,                                                \
+      unsigned long long: log_defer_int,                                       \
+      float: log_defer_double,                                                 \
+      double: log_defer_double,                                                \
+      char *: log_defer_ptr,                                                   \
+      const char *: log_defer_ptr,                                             \
+      void *: log_defer_ptr,                                                   \
+      const void *: log_defer_ptr,                                             \
+      default: log_defer_unsupported)(x)
+
+#define LOG_DEFER_NARGS(...)                                                   \
+  LOG_DEFER_NARGS_(_, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_DEFER_NARGS_(_, a, b, c, d, e, f, n, ...) n
+
+#define LOG_DEFER_CAT(a, b) LOG_DEFER_CAT_(a, b)
+#define LOG_DEFER_CAT_(a, b) a##b
+#define LOG_DEFER_ARGS(...)                                                    \
+  LOG_DEFER_CAT(LOG_DEFER_ARGS_, LOG_DEFER_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_DEFER_ARGS_0(...)
+#define LOG_DEFER_ARGS_1(a) LOG_DEFER_ARG(a)
+#define LOG_DEFER_ARGS_2(a, ...) LOG_DEFER_ARG(a), LOG_DEFER_ARGS_1(__VA_ARGS__)
+#define LOG_DEFER_ARGS_3(a, ...) LOG_DEFER_ARG(a), LOG_DEFER_ARGS_2(__VA_ARGS__)
+#define LOG_DEFER_ARGS_4(a, ...) LOG_DEFER_ARG(a), LOG_DEFER_ARGS_3(__VA_ARGS__)
+#define LOG_DEFER_ARGS_5(a, ...) LOG_DEFER_ARG(a), LOG_DEFER_ARGS_4(__VA_ARGS__)
+#define LOG_DEFER_ARGS_6(a, ...) LOG_DEFER_ARG(a), LOG_DEFER_ARGS_5(__VA_ARGS__)
+
+#endif
@@ -1,25 +1,91 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "nvs_flash.h"
+#include "sdkconfig.h"
+#if CONFIG_TELEMETRY_STREAM
+#include "esp_vfs_cdcacm.h"
+#endif
 
+#include "battery.h"
+#include "boot_report.h"
+#include "log_defer.h"
+#include "history.h"
+#include "sample_log.h"
+#include "bsec_record.h"
+#include "telemetry.h"
+#include "sensor_registry.h"
 #include "sensors_bme680.h"
 #include "lcd.h"
 #include "dashboard.h"
+#include "diagnostics.h"
+#include "power_policy.h"
 
-// Timeout for starting up USB CDC driver
-#define START_TIMEOUT_MS 5000
-
+// The display and the sensor bus come up in their own tasks, concurrently. The
+// USB CDC console needs no settle delay: the boot report is printed once the
+// first sample arrives, long after the host has enumerated the port, or
+// when a phase is still missing after BOOT_REPORT_TIMEOUT_MS.
 void app_main(void) {
-    vTaskDelay(pdMS_TO_TICKS(START_TIMEOUT_MS));
+    boot_mark(BOOT_PHASE_APP_MAIN);
+    if (!boot_report_start()) {
+        ESP_LOGE("MAIN", "Boot Report Timeout Failed!");
+    }
     ESP_LOGI("MAIN", "System Starting...");
 
-    if (!bme680_start()) {
-        ESP_LOGE("MAIN", "Sensors Init Failed!");
+    // First, so sensor task logging never waits on the console
+    if (!log_defer_start()) {
+        ESP_LOGE("MAIN", "Deferred Log Init Failed!");
+    }
+
+    if (!power_policy_init()) {
+        ESP_LOGE("MAIN", "Power Policy Init Failed!");
     }
 
     if (!dashboard_app_start()) {
         ESP_LOGE("MAIN", "Dashboard Init Failed!");
     }
-    
+
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES ||
+        err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(err);
+
+    // Subscribers first, so they see the first sample. Without the
+    // partition the log stays disabled; not fatal.
+    if (!history_init()) {
+        ESP_LOGE("MAIN", "History Init Failed!");
+    }
+    sample_log_init();
+
+#if CONFIG_BSEC_RECORD
+    // Not fatal either: the clock runs the same without a recording
+    bsec_record_start_partition();
+#endif
+
+#if CONFIG_TELEMETRY_STREAM
+    // A CR inserted before a 0x0a would break the frame it falls in
+    esp_vfs_dev_cdcacm_set_tx_line_endings(ESP_LINE_ENDINGS_LF);
+    if (!telemetry_start(stdout)) {
+        ESP_LOGE("MAIN", "Telemetry Init Failed!");
+    }
+#endif
+
+    if (!sensor_registry_add(&bme680_driver) || !sensor_registry_start()) {
+        ESP_LOGE("MAIN", "Sensors Init Failed!");
+    }
+
+#if CONFIG_BATTERY_MONITOR
+    if (!battery_start()) {
+        ESP_LOGE("MAIN", "Battery Init Failed!");
+    }
+#endif
+
+    if (!diagnostics_start()) {
+        ESP_LOGE("MAIN", "Diagnostics Init Failed!");
+    }
+
     ESP_LOGI("MAIN", "All systems running.");
 }
@@ -0,0 +1,166 @@
+#include "power_core.h"
+
+#include <string.h>
+
+// Activities a replay may hold at the same time
+#define REPLAY_MAX_PENDING 16
+
+static const char *const state_names[POWER_STATE_COUNT] = {
+    [POWER_STATE_MAX] = "max",
+    [POWER_STATE_BUS] = "bus",
+    [POWER_STATE_MIN] = "min",
+    [POWER_STATE_SLEEP] = "sleep",
+};
+
+static bool is_idle(const power_core_t *core) {
+  for (int i = 0; i < POWER_ACT_COUNT; i++)
+    if (core->held[i])
+      return false;
+  return true;
+}
+
+power_state_t power_core_state(const power_core_t *core) {
+  if (core->held[POWER_ACT_LVGL])
+    return POWER_STATE_MAX;
+  if (core->held[POWER_ACT_SPI] || core->held[POWER_ACT_I2C])
+    return POWER_STATE_BUS;
+  return POWER_STATE_MIN;
+}
+
+void power_core_update(power_core_t *core, int64_t now_us) {
+  if (now_us <= core->since_us)
+    return;
+
+  power_state_t state = power_core_state(core);
+
+  if (state == POWER_STATE_MIN) {
+    const uint32_t threshold = core->config.sleep_threshold_us;
+
+    if (threshold > 0 && now_us - core->idle_start_us >= threshold) {
+      state = POWER_STATE_SLEEP;
+      if (!core->sleep_counted) {
+        core->stats.sleeps++;
+        core->sleep_counted = true;
+      }
+    } else if (threshold > 0) {
+      // Not known yet whether this stretch will be long enough to sleep
+      return;
+    }
+  }
+
+  core->stats.time_us[state] += now_us - core->since_us;
+  core->since_us = now_us;
+}
+
+void power_core_init(power_core_t *core, const power_core_config_t *config,
+                     int64_t now_us) {
+  memset(core, 0, sizeof(*core));
+  core->config = *config;
+  core->since_us = now_us;
+  core->idle_start_us = now_us;
+}
+
+void power_core_acquire(power_core_t *core, power_activity_t act,
+                        int64_t now_us) {
+  if (act >= POWER_ACT_COUNT)
+    return;
+
+  if (is_idle(core)) {
+    // A stretch shorter than the threshold ends up at the minimum clock
+    power_core_update(core, now_us);
+    if (core->since_us < now_us) {
+      core->stats.time_us[POWER_STATE_MIN] += now_us - core->since_us;
+      core->since_us = now_us;
+    }
+  } else {
+    power_core_update(core, now_us);
+  }
+
+  core->held[act]++;
+  core->stats.acquired[act]++;
+}
+
+void power_core_release(power_core_t *core, power_activity_t act,
+                        int64_t now_us) {
+  if (act >= POWER_ACT_COUNT || core->held[act] == 0)
+    return;
+
+  power_core_update(core, now_us);
+  core->held[act]--;
+
+  if (is_idle(core)) {
+    core->idle_start_us = now_us;
+    core->sleep_counted = false;
+  }
+}
+
+static uint32_t weighted_average(const power_core_t *core,
+                                 const uint32_t *state_ua, bool baseline) {
+  uint64_t total_us = 0;
+  uint64_t charge = 0; // uA * us
+
+  for (int s = 0; s < POWER_STATE_COUNT; s++) {
+    const uint64_t t = (uint64_t)core->stats.time_us[s];
+    // Without power management only rendering runs above the idle current
+    const uint32_t ua = baseline && s != POWER_STATE_MAX
+                            ? core->config.baseline_ua
+                            : state_ua[s];
+    total_us += t;
+    charge += t * ua;
+  }
+
+  return total_us ? (uint32_t)(charge / total_us) : 0;
+}
+
+uint32_t power_core_average_ua(const power_core_t *core) {
+  return weighted_average(core, core->config.state_ua, false);
+}
+
+uint32_t power_core_baseline_ua(const power_core_t *core) {
+  return weighted_average(core, core->config.state_ua, true);
+}
+
+void power_core_replay(power_core_t *core, const power_event_t *events,
+                       size_t count, int64_t end_us) {
+  struct {
+    int64_t end_us;
+    power_activity_t activity;
+  } pending[REPLAY_MAX_PENDING];
+  size_t pending_count = 0;
+
+  for (size_t i = 0; i <= count; i++) {
+    const int64_t next_us = i < count ? events[i].at_us : end_us;
+
+    // Release everything that ends before the next event, in time order
+    while (pending_count > 0) {
+      size_t first = 0;
+      for (size_t p = 1; p < pending_count; p++)
+        if (pending[p].end_us < pending[first].end_us)
+          first = p;
+      if (pending[first].end_us > next_us)
+        break;
+
+      power_core_release(core, pending[first].activity, pending[first].end_us);
+      pending[first] = pending[--pending_count];
+    }
+
+    if (i == count)
+      break;
+
+    power_core_acquire(core, events[i].activity, events[i].at_us);
+    if (pending_count < REPLAY_MAX_PENDING) {
+      pending[pending_count].end_us = events[i].at_us + events[i].duration_us;
+      pending[pending_count].activity = events[i].activity;
+      pending_count++;
+    } else {
+      // Too many overlapping: end it at once rather than hold it forever
+      power_core_release(core, events[i].activity, events[i].at_us);
+    }
+  }
+
+  power_core_update(core, end_us);
+}
+
+const char *power_state_name(power_state_t state) {
+  return state < POWER_STATE_COUNT ? state_names[state] : "?";
+}
@@ -0,0 +1,99 @@
+#ifndef POWER_CORE_H
+#define POWER_CORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Power policy core: turns the activities that currently hold a PM lock into
+// a CPU power state and accounts the time spent in each. It depends on
+// nothing but the C library so the same code runs on the device (fed by
+// power_policy.c) and on host, where power_core_replay drives it from a
+// timeline of activities.
+//
+//   LVGL rendering         -> MAX    CPU at full clock
+//   SPI flush, I2C         -> BUS    APB at 80 MHz, no light sleep
+//   nothing held           -> MIN    CPU at the minimum clock, idling
+//   idle for >= threshold  -> SLEEP  light sleep
+//
+// An idle stretch is classified as a whole by its length, as the idle task
+// only enters light sleep when the next wake-up is far enough away.
+
+typedef enum {
+  POWER_ACT_LVGL,
+  POWER_ACT_SPI,
+  POWER_ACT_I2C,
+  POWER_ACT_COUNT,
+} power_activity_t;
+
+typedef enum {
+  POWER_STATE_MAX,
+  POWER_STATE_BUS,
+  POWER_STATE_MIN,
+  POWER_STATE_SLEEP,
+  POWER_STATE_COUNT,
+} power_state_t;
+
+typedef struct {
+  uint32_t sleep_threshold_us; // 0 = light sleep disabled
+  uint32_t state_ua[POWER_STATE_COUNT];
+  uint32_t baseline_ua; // no power management: full clock, idling in WAITI
+} power_core_config_t;
+
+typedef struct {
+  int64_t time_us[POWER_STATE_COUNT];
+  uint32_t acquired[POWER_ACT_COUNT];
+  uint32_t sleeps; // idle stretches long enough for light sleep
+} power_core_stats_t;
+
+typedef struct {
+  power_core_config_t config;
+  uint16_t held[POWER_ACT_COUNT];
+  int64_t since_us;      // accounted up to here
+  int64_t idle_start_us; // start of the current idle stretch
+  bool sleep_counted;
+  power_core_stats_t stats;
+} power_core_t;
+
+// One activity on a timeline, holding its lock for `duration_us`
+typedef struct {
+  int64_t at_us;
+  uint32_t duration_us;
+  power_activity_t activity;
+} power_event_t;
+
+// Rough ESP32-S2 figures (CPU and digital domain only, no display)
+#define POWER_CORE_DEFAULT_CONFIG                                              \
+  {                                                                            \
+      .sleep_threshold_us = 0,                                                 \
+      .state_ua = {[POWER_STATE_MAX] = 28000,                                  \
+                   [POWER_STATE_BUS] = 16000,                                  \
+                   [POWER_STATE_MIN] = 11000,                                  \
+                   [POWER_STATE_SLEEP] = 750},                                 \
+      .baseline_ua = 20000,                                                    \
+  }
+
+void power_core_init(power_core_t *core, const power_core_config_t *config,
+                     int64_t now_us);
+
+void power_core_acquire(power_core_t *core, power_activity_t act,
+                        int64_t now_us);
+void power_core_release(power_core_t *core, power_activity_t act,
+                        int64_t now_us);
+
+// Accounts time up to `now_us` without changing state, e.g. before a report
+void power_core_update(power_core_t *core, int64_t now_us);
+
+power_state_t power_core_state(const power_core_t *core);
+
+// Average current over the accounted time, with the policy and without it
+uint32_t power_core_average_ua(const power_core_t *core);
+uint32_t power_core_baseline_ua(const power_core_t *core);
+
+// Feeds `events`, sorted by start time, and accounts up to `end_us`
+void power_core_replay(power_core_t *core, const power_event_t *events,
+                       size_t count, int64_t end_us);
+
+const char *power_state_name(power_state_t state);
+
+#endif
@@ -0,0 +1,138 @@
+#include "power_policy.h"
+
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "POWER";
+
+static const esp_pm_lock_type_t lock_types[POWER_ACT_COUNT] = {
+    [POWER_ACT_LVGL] = ESP_PM_CPU_FREQ_MAX,
+    [POWER_ACT_SPI] = ESP_PM_APB_FREQ_MAX,
+    [POWER_ACT_I2C] = ESP_PM_APB_FREQ_MAX,
+};
+
+static const char *const lock_names[POWER_ACT_COUNT] = {
+    [POWER_ACT_LVGL] = "lvgl",
+    [POWER_ACT_SPI] = "lcd_spi",
+    [POWER_ACT_I2C] = "bme_i2c",
+};
+
+static esp_pm_lock_handle_t locks[POWER_ACT_COUNT];
+static power_core_t core;
+static bool core_ready;
+static portMUX_TYPE core_mux = portMUX_INITIALIZER_UNLOCKED;
+
+bool power_policy_init(void) {
+  power_core_config_t config = POWER_CORE_DEFAULT_CONFIG;
+
+#if CONFIG_PM_ENABLE
+  esp_pm_config_t pm = {
+      .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+      .min_freq_mhz = CONFIG_POWER_MIN_CPU_FREQ_MHZ,
+#if CONFIG_POWER_LIGHT_SLEEP
+      .light_sleep_enable = true,
+#endif
+  };
+  esp_err_t err = esp_pm_configure(&pm);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "PM configure failed: %s", esp_err_to_name(err));
+    return false;
+  }
+
+  for (int i = 0; i < POWER_ACT_COUNT; i++) {
+    err = esp_pm_lock_create(lock_types[i], 0, lock_names[i], &locks[i]);
+    if (err != ESP_OK) {
+      ESP_LOGE(TAG, "Lock %s failed: %s", lock_names[i], esp_err_to_name(err));
+      return false;
+    }
+  }
+
+#if CONFIG_POWER_LIGHT_SLEEP
+  config.sleep_threshold_us =
+      CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP * portTICK_PERIOD_MS * 1000;
+#endif
+  ESP_LOGI(TAG, "DFS %d-%d MHz, light sleep %s",
+           CONFIG_POWER_MIN_CPU_FREQ_MHZ, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+           config.sleep_threshold_us ? "on" : "off");
+#else
+  ESP_LOGW(TAG, "CONFIG_PM_ENABLE is off, accounting only");
+#endif
+
+  taskENTER_CRITICAL(&core_mux);
+  power_core_init(&core, &config, esp_timer_get_time());
+  core_ready = true;
+  taskEXIT_CRITICAL(&core_mux);
+
+  return true;
+}
+
+void power_policy_acquire(power_activity_t act) {
+  if (!core_ready || act >= POWER_ACT_COUNT)
+    return;
+
+  // Raise the clock before the work starts
+  if (locks[act])
+    esp_pm_lock_acquire(locks[act]);
+
+  taskENTER_CRITICAL(&core_mux);
+  power_core_acquire(&core, act, esp_timer_get_time());
+  taskEXIT_CRITICAL(&core_mux);
+}
+
+void power_policy_release(power_activity_t act) {
+  if (!core_ready || act >= POWER_ACT_COUNT)
+    return;
+
+  taskENTER_CRITICAL(&core_mux);
+  power_core_release(&core, act, esp_timer_get_time());
+  taskEXIT_CRITICAL(&core_mux);
+
+  if (locks[act])
+    esp_pm_lock_release(locks[act]);
+}
+
+void power_policy_get_stats(power_core_stats_t *out, uint32_t *out_avg_ua,
+                            uint32_t *out_baseline_ua) {
+  taskENTER_CRITICAL(&core_mux);
+  power_core_update(&core, esp_timer_get_time());
+  if (out)
+    *out = core.stats;
+  if (out_avg_ua)
+    *out_avg_ua = power_core_average_ua(&core);
+  if (out_baseline_ua)
+    *out_baseline_ua = power_core_baseline_ua(&core);
+  taskEXIT_CRITICAL(&core_mux);
+}
+
+void power_policy_log_report(void) {
+  power_core_stats_t stats;
+  uint32_t avg_ua, baseline_ua;
+
+  if (!core_ready)
+    return;
+  power_policy_get_stats(&stats, &avg_ua, &baseline_ua);
+
+  int64_t total_us = 0;
+  for (int s = 0; s < POWER_STATE_COUNT; s++)
+    total_us += stats.time_us[s];
+  if (total_us == 0)
+    return;
+
+  for (int s = 0; s < POWER_STATE_COUNT; s++)
+    ESP_LOGI(TAG, "%-5s %8.2f s (%5.2f%%)", power_state_name(s),
+             (double)stats.time_us[s] / 1e6,
+             (double)stats.time_us[s] * 100.0 / (double)total_us);
+  ESP_LOGI(TAG, "locks: %lu lvgl, %lu spi, %lu i2c; %lu light sleeps",
+           (unsigned long)stats.acquired[POWER_ACT_LVGL],
+           (unsigned long)stats.acquired[POWER_ACT_SPI],
+           (unsigned long)stats.acquired[POWER_ACT_I2C],
+           (unsigned long)stats.sleeps);
+  const long saved_pct =
+      baseline_ua ? 100 - (long)((uint64_t)avg_ua * 100 / baseline_ua) : 0;
+  ESP_LOGI(TAG, "estimated %lu uA vs %lu uA without PM (%ld%% saved)",
+           (unsigned long)avg_ua, (unsigned long)baseline_ua, saved_pct);
+}
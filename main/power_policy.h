@@ -0,0 +1,24 @@
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+#include <stdbool.h>
+
+#include "power_core.h"
+
+// Dynamic frequency scaling and, optionally, light sleep between updates.
+// PM locks are only held while LVGL renders (CPU at full clock) and while a
+// panel flush or sensor I2C transfer is in flight (APB at 80 MHz, no light
+// sleep); the rest of the time the CPU runs at CONFIG_POWER_MIN_CPU_FREQ_MHZ.
+// Time per state is accounted by power_core.
+
+bool power_policy_init(void);
+
+// Counting: every acquire needs a matching release. Task context only.
+void power_policy_acquire(power_activity_t act);
+void power_policy_release(power_activity_t act);
+
+void power_policy_get_stats(power_core_stats_t *out, uint32_t *out_avg_ua,
+                            uint32_t *out_baseline_ua);
+void power_policy_log_report(void);
+
+#endif
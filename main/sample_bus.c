@@ -0,0 +1,290 @@
+#include "sample_bus.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "SAMPLE_BUS";
+
+// The slot of a channel alternates between two copies and `seq` names the
+// newest one (copy = seq & 1). The owning driver fills the other copy and
+// sample_bus_publish then advances seq, so a reader in another task copies a
+// stable sample and only retries if a newer one was published meanwhile.
+typedef struct {
+  sample_t copies[2];
+  atomic_uint_fast32_t seq;
+  bool pending; // the other copy was written, not yet published
+} channel_slot_t;
+
+typedef struct {
+  sample_bus_subscriber_stats_t stats;
+  sample_bus_cb_t cb;
+  void *ctx;
+} subscriber_t;
+
+static channel_slot_t slots[SAMPLE_CH_COUNT];
+
+// Entries below `n_subscribers` are complete and never change
+static subscriber_t subscribers[SAMPLE_BUS_MAX_SUBSCRIBERS];
+static atomic_uint n_subscribers;
+static portMUX_TYPE subscribe_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Twice the publish count, odd while a publish advances its slots: readers
+// of several channels check that it did not move during their copy
+static atomic_uint publish_seq;
+static portMUX_TYPE publish_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t waiters[SAMPLE_BUS_MAX_WAITERS];
+static portMUX_TYPE waiters_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static sample_bus_stats_t stats;
+
+static const char *const channel_names[SAMPLE_CH_COUNT] = {
+    [SAMPLE_CH_IAQ] = "iaq",           [SAMPLE_CH_TEMP] = "temp",
+    [SAMPLE_CH_PRESSURE] = "pressure", [SAMPLE_CH_HUMIDITY] = "humidity",
+    [SAMPLE_CH_GAS] = "gas",           [SAMPLE_CH_CO2_EQ] = "co2eq",
+    [SAMPLE_CH_CO2] = "co2",           [SAMPLE_CH_PM1] = "pm1",
+    [SAMPLE_CH_PM2_5] = "pm2.5",       [SAMPLE_CH_PM10] = "pm10",
+};
+
+bool sample_bus_subscribe(const char *name, sample_mask_t channels,
+                          sample_bus_cb_t cb, void *ctx) {
+  if (cb == NULL || channels == 0)
+    return false;
+
+  bool added = false;
+
+  taskENTER_CRITICAL(&subscribe_lock);
+  unsigned n = atomic_load_explicit(&n_subscribers, memory_order_relaxed);
+  if (n < SAMPLE_BUS_MAX_SUBSCRIBERS) {
+    subscribers[n] = (subscriber_t){
+        .stats = {.name = name, .channels = channels},
+        .cb = cb,
+        .ctx = ctx,
+    };
+    atomic_store_explicit(&n_subscribers, n + 1, memory_order_release);
+    added = true;
+  }
+  taskEXIT_CRITICAL(&subscribe_lock);
+
+  if (!added)
+    ESP_LOGE(TAG, "Too many subscribers, %s not added", name);
+  return added;
+}
+
+void sample_bus_write(sample_channel_t ch, float value, uint8_t accuracy,
+                      int64_t timestamp_us) {
+  if ((unsigned)ch >= SAMPLE_CH_COUNT)
+    return;
+
+  channel_slot_t *slot = &slots[ch];
+  uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed) + 1;
+
+  slot->copies[seq & 1] = (sample_t){
+      .value = value,
+      .accuracy = accuracy,
+      .seq = seq,
+      .timestamp_us = timestamp_us,
+  };
+  slot->pending = true;
+  stats.samples++;
+}
+
+// The critical section keeps publish_seq odd for a few stores only, so a
+// reader on the other core waits for it rather than for a preempted task
+static void commit(sample_mask_t updated) {
+  taskENTER_CRITICAL(&publish_lock);
+  const unsigned p = atomic_load_explicit(&publish_seq, memory_order_relaxed);
+  atomic_store_explicit(&publish_seq, p + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  for (int ch = 0; ch < SAMPLE_CH_COUNT; ch++) {
+    channel_slot_t *slot = &slots[ch];
+    if (!(updated & SAMPLE_MASK(ch)) || !slot->pending)
+      continue;
+    slot->pending = false;
+    atomic_store_explicit(
+        &slot->seq, atomic_load_explicit(&slot->seq, memory_order_relaxed) + 1,
+        memory_order_release);
+  }
+
+  atomic_store_explicit(&publish_seq, p + 2, memory_order_release);
+  taskEXIT_CRITICAL(&publish_lock);
+}
+
+// Notifies outside the critical section: no FreeRTOS calls under a spinlock
+static void wake_waiters(void) {
+  TaskHandle_t wake[SAMPLE_BUS_MAX_WAITERS];
+  int n = 0;
+
+  taskENTER_CRITICAL(&waiters_lock);
+  for (int i = 0; i < SAMPLE_BUS_MAX_WAITERS; i++)
+    if (waiters[i])
+      wake[n++] = waiters[i];
+  taskEXIT_CRITICAL(&waiters_lock);
+
+  for (int i = 0; i < n; i++)
+    xTaskNotifyGive(wake[i]);
+}
+
+void sample_bus_publish(sample_mask_t updated) {
+  commit(updated);
+
+  unsigned n = atomic_load_explicit(&n_subscribers, memory_order_acquire);
+
+  stats.publishes++;
+  for (unsigned i = 0; i < n; i++) {
+    subscriber_t *sub = &subscribers[i];
+    sample_mask_t mine = updated & sub->stats.channels;
+
+    if (mine) {
+      sub->stats.deliveries++;
+      sub->cb(mine, sub->ctx);
+    }
+  }
+
+  wake_waiters();
+}
+
+const sample_t *sample_bus_peek(sample_channel_t ch) {
+  if ((unsigned)ch >= SAMPLE_CH_COUNT)
+    return NULL;
+
+  const channel_slot_t *slot = &slots[ch];
+  return &slot->copies[atomic_load_explicit(&slot->seq, memory_order_acquire) &
+                       1];
+}
+
+bool sample_bus_read(sample_channel_t ch, sample_t *out) {
+  if (out == NULL)
+    return false;
+  if ((unsigned)ch >= SAMPLE_CH_COUNT) {
+    memset(out, 0, sizeof(*out));
+    return false;
+  }
+
+  channel_slot_t *slot = &slots[ch];
+  uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+  while (true) {
+    *out = slot->copies[seq & 1];
+    atomic_thread_fence(memory_order_acquire);
+
+    uint32_t now = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    if (now == seq)
+      break;
+    seq = now;
+  }
+
+  return seq != 0;
+}
+
+sample_mask_t sample_bus_read_set(sample_mask_t channels, sample_t *out,
+                                  uint32_t *out_seq) {
+  if (out == NULL)
+    return 0;
+
+  sample_mask_t published;
+  unsigned p;
+
+  while (true) {
+    p = atomic_load_explicit(&publish_seq, memory_order_acquire);
+    if (p & 1)
+      continue;
+
+    published = 0;
+    for (int ch = 0; ch < SAMPLE_CH_COUNT; ch++) {
+      if (!(channels & SAMPLE_MASK(ch)))
+        continue;
+      const channel_slot_t *slot = &slots[ch];
+      const uint32_t seq =
+          atomic_load_explicit(&slot->seq, memory_order_acquire);
+      out[ch] = slot->copies[seq & 1];
+      if (seq != 0)
+        published |= SAMPLE_MASK(ch);
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    if (atomic_load_explicit(&publish_seq, memory_order_relaxed) == p)
+      break;
+  }
+
+  if (out_seq)
+    *out_seq = p / 2;
+  return published;
+}
+
+static bool add_waiter(TaskHandle_t task) {
+  bool added = false;
+
+  taskENTER_CRITICAL(&waiters_lock);
+  for (int i = 0; i < SAMPLE_BUS_MAX_WAITERS && !added; i++) {
+    if (waiters[i] == NULL) {
+      waiters[i] = task;
+      added = true;
+    }
+  }
+  taskEXIT_CRITICAL(&waiters_lock);
+
+  return added;
+}
+
+static void remove_waiter(TaskHandle_t task) {
+  taskENTER_CRITICAL(&waiters_lock);
+  for (int i = 0; i < SAMPLE_BUS_MAX_WAITERS; i++)
+    if (waiters[i] == task)
+      waiters[i] = NULL;
+  taskEXIT_CRITICAL(&waiters_lock);
+}
+
+bool sample_bus_wait(uint32_t after_seq, TickType_t timeout) {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  if (!add_waiter(self)) {
+    ESP_LOGW(TAG, "Too many waiters");
+    return false;
+  }
+
+  // Registered before checking, so a publish in between still leaves a
+  // pending notification behind
+  const TickType_t start = xTaskGetTickCount();
+  bool fresh = false;
+
+  while (true) {
+    if (atomic_load_explicit(&publish_seq, memory_order_acquire) / 2 >
+        after_seq) {
+      fresh = true;
+      break;
+    }
+
+    const TickType_t elapsed = xTaskGetTickCount() - start;
+    if (elapsed >= timeout)
+      break;
+
+    ulTaskNotifyTake(pdTRUE, timeout == portMAX_DELAY ? portMAX_DELAY
+                                                      : timeout - elapsed);
+  }
+
+  remove_waiter(self);
+  return fresh;
+}
+
+const char *sample_channel_name(sample_channel_t ch) {
+  return (unsigned)ch < SAMPLE_CH_COUNT ? channel_names[ch] : "?";
+}
+
+void sample_bus_get_stats(sample_bus_stats_t *out) {
+  if (out)
+    *out = stats;
+}
+
+size_t sample_bus_get_subscriber_stats(sample_bus_subscriber_stats_t *out,
+                                       size_t max) {
+  unsigned n = atomic_load_explicit(&n_subscribers, memory_order_acquire);
+  size_t count = 0;
+
+  for (unsigned i = 0; i < n && count < max; i++)
+    out[count++] = subscribers[i].stats;
+  return count;
+}
@@ -0,0 +1,103 @@
+#ifndef SAMPLE_BUS_H
+#define SAMPLE_BUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+// Publish/subscribe bus for sensor samples. Every channel has one shared
+// slot, written only by the driver that owns the channel. A driver writes
+// the channels of a measurement, then publishes them together: they become
+// visible at once, and each subscriber whose mask intersects gets one
+// callback, in the driver's task, and reads the values in place with
+// sample_bus_peek. Other tasks copy a channel with sample_bus_read, or
+// several channels of the same publish with sample_bus_read_set. Neither
+// blocks the writer.
+//
+// Subscribers must be cheap: they delay the next transaction on the
+// driver's bus. Anything slow belongs in the subscriber's own task.
+
+#define SAMPLE_BUS_MAX_SUBSCRIBERS 8
+#define SAMPLE_BUS_MAX_WAITERS 4
+
+typedef enum {
+  SAMPLE_CH_IAQ,      // BSEC static IAQ index
+  SAMPLE_CH_TEMP,     // °C, heat compensated
+  SAMPLE_CH_PRESSURE, // Pa
+  SAMPLE_CH_HUMIDITY, // %RH, heat compensated
+  SAMPLE_CH_GAS,      // BSEC gas percentage
+  SAMPLE_CH_CO2_EQ,   // ppm, BSEC estimate from the gas resistance
+  SAMPLE_CH_CO2,      // ppm, NDIR
+  SAMPLE_CH_PM1,      // µg/m³
+  SAMPLE_CH_PM2_5,    // µg/m³
+  SAMPLE_CH_PM10,     // µg/m³
+  SAMPLE_CH_COUNT,
+} sample_channel_t;
+
+typedef uint32_t sample_mask_t;
+
+#define SAMPLE_MASK(ch) ((sample_mask_t)1 << (ch))
+
+typedef struct {
+  float value;
+  uint8_t accuracy;     // 0 (unreliable) to 3 (calibrated)
+  uint32_t seq;         // 0 until the first sample, then +1 per sample
+  int64_t timestamp_us; // esp_timer time the sample was captured
+} sample_t;
+
+typedef struct {
+  const char *name;
+  sample_mask_t channels;
+  uint32_t deliveries;
+} sample_bus_subscriber_stats_t;
+
+typedef struct {
+  uint32_t publishes;
+  uint32_t samples; // channel values written
+} sample_bus_stats_t;
+
+// `updated` holds the subscribed channels that were just published
+typedef void (*sample_bus_cb_t)(sample_mask_t updated, void *ctx);
+
+// May be called at any time, also while drivers are publishing
+bool sample_bus_subscribe(const char *name, sample_mask_t channels,
+                          sample_bus_cb_t cb, void *ctx);
+
+// Publisher side, from the task of the driver owning the channels. Written
+// values stay invisible until the channel is published; `updated` must hold
+// every channel written since.
+void sample_bus_write(sample_channel_t ch, float value, uint8_t accuracy,
+                      int64_t timestamp_us);
+void sample_bus_publish(sample_mask_t updated);
+
+// The slot of `ch`, without copying. Only valid inside a callback and only
+// for channels in its `updated` mask.
+const sample_t *sample_bus_peek(sample_channel_t ch);
+
+// Copies the latest sample of `ch` from any task. Returns false (and zeroes
+// `out`) until the channel has been published.
+bool sample_bus_read(sample_channel_t ch, sample_t *out);
+
+// Copies the latest sample of every channel in `channels` to out[ch], all
+// as of the same publish, so values of one measurement are never mixed with
+// the next. `out` has SAMPLE_CH_COUNT entries; others are left alone.
+// `out_seq` (may be NULL) receives the publish count the copy belongs to.
+// Returns the channels among `channels` that have been published.
+sample_mask_t sample_bus_read_set(sample_mask_t channels, sample_t *out,
+                                  uint32_t *out_seq);
+
+// Blocks until the publish count exceeds `after_seq` or `timeout` expires,
+// and returns whether it did. Uses the caller's task notification value.
+bool sample_bus_wait(uint32_t after_seq, TickType_t timeout);
+
+const char *sample_channel_name(sample_channel_t ch);
+
+void sample_bus_get_stats(sample_bus_stats_t *out);
+
+// Copies the stats of up to `max` subscribers, returns the count
+size_t sample_bus_get_subscriber_stats(sample_bus_subscriber_stats_t *out,
+                                       size_t max);
+
+#endif
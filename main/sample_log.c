@@ -0,0 +1,374 @@
+#include "sample_log.h"
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "log_defer.h"
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "SAMPLE_LOG";
+
+#define LOG_PARTITION_LABEL "samplelog"
+
+#define LOG_SECTOR_SIZE 4096
+#define LOG_SECTOR_MAGIC 0x534c4f47 // "SLOG"
+#define LOG_BLOCK_MAGIC 0x5a31
+#define LOG_BLOCK_VERSION 1
+#define LOG_BLOCK_SIZE 256
+#define LOG_BLANK_MAGIC 0xffff
+
+typedef struct {
+  uint32_t magic;
+  uint32_t sector_seq; // +1 every time a sector is (re)started
+  uint32_t first_seq;  // sample seq of the first block in the sector
+  uint32_t crc;
+} log_sector_hdr_t;
+
+typedef struct {
+  uint16_t dt_s; // seconds after the block's base time
+  int16_t v[HISTORY_CH_COUNT];
+  uint8_t accuracy;
+  uint8_t reserved;
+} log_record_t;
+
+typedef struct {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t count;
+  uint32_t first_seq;
+  uint32_t base_time_s;
+  uint32_t crc; // over the header fields above and `count` records
+  log_record_t records[SAMPLE_LOG_BATCH];
+} log_block_t;
+
+#define LOG_BLOCKS_PER_SECTOR                                                  \
+  ((LOG_SECTOR_SIZE - sizeof(log_sector_hdr_t)) / LOG_BLOCK_SIZE)
+
+static_assert(sizeof(log_sector_hdr_t) == 16, "sector header layout");
+static_assert(sizeof(log_record_t) == 16, "record layout");
+static_assert(sizeof(log_block_t) == LOG_BLOCK_SIZE, "block layout");
+
+static const esp_partition_t *partition;
+static uint32_t n_sectors;
+
+static bool have_head;
+static uint32_t head_sector;
+static uint32_t head_sector_seq;
+static uint32_t head_block; // next free block slot in the head sector
+static uint32_t next_seq = 1;
+
+static log_block_t pending;
+static sample_log_stats_t stats;
+static uint32_t flash_reads;
+
+static void on_samples(sample_mask_t updated, void *ctx);
+
+static size_t sector_offset(uint32_t sector) {
+  return (size_t)sector * LOG_SECTOR_SIZE;
+}
+
+static size_t block_offset(uint32_t sector, uint32_t block) {
+  return sector_offset(sector) + sizeof(log_sector_hdr_t) +
+         (size_t)block * LOG_BLOCK_SIZE;
+}
+
+static bool read_flash(size_t offset, void *dst, size_t len) {
+  flash_reads++;
+  return esp_partition_read(partition, offset, dst, len) == ESP_OK;
+}
+
+static uint32_t block_crc(const log_block_t *block) {
+  uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)block,
+                                  offsetof(log_block_t, crc));
+  return esp_rom_crc32_le(crc, (const uint8_t *)block->records,
+                          block->count * sizeof(log_record_t));
+}
+
+static bool read_sector_hdr(uint32_t sector, log_sector_hdr_t *hdr) {
+  if (!read_flash(sector_offset(sector), hdr, sizeof(*hdr)))
+    return false;
+
+  return hdr->magic == LOG_SECTOR_MAGIC &&
+         hdr->crc == esp_rom_crc32_le(0, (const uint8_t *)hdr,
+                                      offsetof(log_sector_hdr_t, crc));
+}
+
+static bool read_block(uint32_t sector, uint32_t slot, log_block_t *block) {
+  if (!read_flash(block_offset(sector, slot), block, sizeof(*block)))
+    return false;
+
+  return block->magic == LOG_BLOCK_MAGIC &&
+         block->version == LOG_BLOCK_VERSION && block->count > 0 &&
+         block->count <= SAMPLE_LOG_BATCH && block->crc == block_crc(block);
+}
+
+static bool block_is_blank(uint32_t sector, uint32_t slot) {
+  uint16_t magic;
+  return read_flash(block_offset(sector, slot), &magic, sizeof(magic)) &&
+         magic == LOG_BLANK_MAGIC;
+}
+
+static bool block_is_erased(uint32_t sector, uint32_t slot) {
+  uint8_t buf[LOG_BLOCK_SIZE];
+  if (!read_flash(block_offset(sector, slot), buf, sizeof(buf)))
+    return false;
+
+  for (size_t i = 0; i < sizeof(buf); i++) {
+    if (buf[i] != 0xff)
+      return false;
+  }
+  return true;
+}
+
+// Sectors are filled in ring order, so starting from sector 0 the sequence
+// numbers rise up to the head and then either stop (blank) or drop (older
+// wrapped data). Returns false if sector 0 cannot anchor the search.
+static bool find_head_binary(log_sector_hdr_t *out) {
+  log_sector_hdr_t first;
+  if (!read_sector_hdr(0, &first))
+    return false;
+
+  uint32_t lo = 0;
+  uint32_t hi = n_sectors;
+  *out = first;
+
+  while (hi - lo > 1) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    log_sector_hdr_t hdr;
+
+    if (read_sector_hdr(mid, &hdr) && hdr.sector_seq >= first.sector_seq) {
+      lo = mid;
+      *out = hdr;
+    } else {
+      hi = mid;
+    }
+  }
+
+  head_sector = lo;
+  return true;
+}
+
+// Fallback for an empty log or a power cut while sector 0 was recycled
+static bool find_head_linear(log_sector_hdr_t *out) {
+  bool found = false;
+
+  for (uint32_t s = 0; s < n_sectors; s++) {
+    log_sector_hdr_t hdr;
+    if (read_sector_hdr(s, &hdr) &&
+        (!found || hdr.sector_seq > out->sector_seq)) {
+      *out = hdr;
+      head_sector = s;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+static void recover_head_sector(const log_sector_hdr_t *hdr) {
+  head_sector_seq = hdr->sector_seq;
+  next_seq = hdr->first_seq;
+
+  // Blocks are appended in order: find the first blank slot
+  uint32_t lo = 0;
+  uint32_t hi = LOG_BLOCKS_PER_SECTOR;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (block_is_blank(head_sector, mid))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  head_block = lo;
+
+  // A write cut short before its magic landed may still have left bits
+  // programmed further into the slot; never program over those
+  if (head_block < LOG_BLOCKS_PER_SECTOR &&
+      !block_is_erased(head_sector, head_block)) {
+    head_block++;
+    stats.torn_blocks++;
+  }
+
+  // Continue numbering after the newest intact block
+  for (uint32_t slot = head_block; slot > 0; slot--) {
+    log_block_t block;
+    if (read_block(head_sector, slot - 1, &block)) {
+      next_seq = block.first_seq + block.count;
+      break;
+    }
+    stats.torn_blocks++;
+  }
+}
+
+esp_err_t sample_log_init(void) {
+  int64_t start = esp_timer_get_time();
+
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                       ESP_PARTITION_SUBTYPE_ANY,
+                                       LOG_PARTITION_LABEL);
+  if (partition == NULL) {
+    ESP_LOGW(TAG, "No '%s' partition, samples will not persist",
+             LOG_PARTITION_LABEL);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  n_sectors = partition->size / LOG_SECTOR_SIZE;
+
+  log_sector_hdr_t hdr;
+  have_head = find_head_binary(&hdr) || find_head_linear(&hdr);
+  if (have_head)
+    recover_head_sector(&hdr);
+
+  stats.recovery_reads = flash_reads;
+  stats.recovery_us = esp_timer_get_time() - start;
+  stats.next_seq = next_seq;
+
+  ESP_LOGI(TAG, "Head sector %u block %u, next seq %u (%u reads, %lld us)",
+           (unsigned)head_sector, (unsigned)head_block, (unsigned)next_seq,
+           (unsigned)stats.recovery_reads, (long long)stats.recovery_us);
+
+  if (!sample_bus_subscribe("sample_log", HISTORY_SAMPLE_CHANNELS, on_samples,
+                            NULL))
+    return ESP_ERR_NO_MEM;
+  return ESP_OK;
+}
+
+static esp_err_t open_next_sector(void) {
+  uint32_t sector = have_head ? (head_sector + 1) % n_sectors : 0;
+  uint32_t sector_seq = have_head ? head_sector_seq + 1 : 1;
+
+  esp_err_t err = esp_partition_erase_range(partition, sector_offset(sector),
+                                            LOG_SECTOR_SIZE);
+  if (err != ESP_OK)
+    return err;
+  stats.sectors_erased++;
+
+  log_sector_hdr_t hdr = {
+      .magic = LOG_SECTOR_MAGIC,
+      .sector_seq = sector_seq,
+      .first_seq = pending.first_seq,
+  };
+  hdr.crc =
+      esp_rom_crc32_le(0, (const uint8_t *)&hdr, offsetof(log_sector_hdr_t, crc));
+
+  err = esp_partition_write(partition, sector_offset(sector), &hdr,
+                            sizeof(hdr));
+  if (err != ESP_OK)
+    return err;
+
+  have_head = true;
+  head_sector = sector;
+  head_sector_seq = sector_seq;
+  head_block = 0;
+  return ESP_OK;
+}
+
+esp_err_t sample_log_flush(void) {
+  if (partition == NULL || pending.count == 0)
+    return ESP_OK;
+
+  if (!have_head || head_block >= LOG_BLOCKS_PER_SECTOR) {
+    esp_err_t err = open_next_sector();
+    if (err != ESP_OK) {
+      LOG_DEFER_E(TAG, "Sector rotation failed: %s", esp_err_to_name(err));
+      return err;
+    }
+  }
+
+  pending.magic = LOG_BLOCK_MAGIC;
+  pending.version = LOG_BLOCK_VERSION;
+  pending.crc = block_crc(&pending);
+
+  // Unused record slots stay erased
+  size_t len = offsetof(log_block_t, records) +
+               pending.count * sizeof(log_record_t);
+  esp_err_t err = esp_partition_write(
+      partition, block_offset(head_sector, head_block), &pending, len);
+
+  // The slot is consumed even if the write failed half-way
+  head_block++;
+  pending.count = 0;
+
+  if (err != ESP_OK) {
+    LOG_DEFER_E(TAG, "Block write failed: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  stats.blocks_written++;
+  return ESP_OK;
+}
+
+// Sample bus callback, in the publishing driver's task
+static void on_samples(sample_mask_t updated, void *ctx) {
+  history_row_t row;
+  history_row_from_bus(updated, &row);
+
+  uint32_t now_s = (uint32_t)time(NULL);
+
+  if (pending.count == 0) {
+    pending.first_seq = next_seq;
+    pending.base_time_s = now_s;
+  }
+
+  uint32_t dt = now_s - pending.base_time_s;
+  log_record_t *rec = &pending.records[pending.count++];
+  rec->dt_s = dt > UINT16_MAX ? UINT16_MAX : (uint16_t)dt;
+  memcpy(rec->v, row.v, sizeof(rec->v));
+  rec->accuracy = row.accuracy;
+  rec->reserved = 0xff;
+
+  next_seq++;
+  stats.appended++;
+  stats.next_seq = next_seq;
+
+  if (pending.count == SAMPLE_LOG_BATCH)
+    sample_log_flush();
+}
+
+esp_err_t sample_log_iterate(sample_log_visit_cb_t cb, void *ctx) {
+  if (partition == NULL)
+    return ESP_ERR_INVALID_STATE;
+  if (!have_head)
+    return ESP_OK;
+
+  // Oldest data sits right after the head sector in ring order
+  for (uint32_t k = 1; k <= n_sectors; k++) {
+    uint32_t sector = (head_sector + k) % n_sectors;
+    log_sector_hdr_t hdr;
+
+    if (!read_sector_hdr(sector, &hdr))
+      continue;
+
+    for (uint32_t slot = 0; slot < LOG_BLOCKS_PER_SECTOR; slot++) {
+      if (block_is_blank(sector, slot))
+        break;
+
+      log_block_t block;
+      if (!read_block(sector, slot, &block))
+        continue;
+
+      for (uint8_t i = 0; i < block.count; i++) {
+        const log_record_t *rec = &block.records[i];
+        sample_log_entry_t entry = {
+            .seq = block.first_seq + i,
+            .time_s = block.base_time_s + rec->dt_s,
+            .accuracy = rec->accuracy,
+        };
+        memcpy(entry.v, rec->v, sizeof(entry.v));
+
+        if (!cb(&entry, ctx))
+          return ESP_OK;
+      }
+    }
+  }
+
+  return ESP_OK;
+}
+
+void sample_log_get_stats(sample_log_stats_t *out) {
+  if (out)
+    *out = stats;
+}
@@ -0,0 +1,57 @@
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "history.h"
+
+// Append-only sample log on the "samplelog" flash partition.
+//
+// The partition is a ring of 4 KB sectors, each starting with a header that
+// carries a monotonically increasing sector sequence number. Samples are
+// buffered in RAM and written as fixed 256-byte blocks of up to
+// SAMPLE_LOG_BATCH samples, each block protected by a CRC32. Only the oldest
+// sector is ever erased, so wear is spread evenly over the partition.
+//
+// On boot the head sector is found by binary search over sector headers and
+// the write position by binary search over the blocks in that sector. A
+// block torn by a power cut fails its CRC and is skipped.
+
+#define SAMPLE_LOG_BATCH 15
+
+typedef struct {
+  uint32_t seq;
+  uint32_t time_s; // wall clock (time()) when the sample was captured
+  int16_t v[HISTORY_CH_COUNT];
+  uint8_t accuracy;
+} sample_log_entry_t;
+
+typedef struct {
+  uint32_t appended;       // samples received from the sample bus
+  uint32_t blocks_written; // flash program operations
+  uint32_t sectors_erased;
+  uint32_t torn_blocks;    // blocks skipped because of a bad CRC
+  uint32_t recovery_reads; // flash reads needed by sample_log_init
+  int64_t recovery_us;     // time spent in sample_log_init
+  uint32_t next_seq;
+} sample_log_stats_t;
+
+typedef bool (*sample_log_visit_cb_t)(const sample_log_entry_t *entry,
+                                      void *ctx);
+
+// Recovers the write position and subscribes to the history channels of
+// the sample bus. Samples are buffered and a block is written once
+// SAMPLE_LOG_BATCH are pending.
+esp_err_t sample_log_init(void);
+
+// Writes any buffered samples as a short block
+esp_err_t sample_log_flush(void);
+
+// Visits persisted samples from oldest to newest until `cb` returns false
+esp_err_t sample_log_iterate(sample_log_visit_cb_t cb, void *ctx);
+
+void sample_log_get_stats(sample_log_stats_t *out);
+
+#endif
@@ -0,0 +1,208 @@
+#include "sensor_registry.h"
+
+#include "driver/i2c.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <stdatomic.h>
+
+#include "i2c_trace.h"
+#include "log_defer.h"
+#include "power_policy.h"
+
+static const char *TAG = "SENSORS";
+
+typedef struct {
+  const char *task_name;
+  i2c_port_t port;
+  int sda_pin;
+  int scl_pin;
+  uint32_t clk_speed;
+  i2c_bus_t i2c;
+  TaskHandle_t task;
+} bus_t;
+
+typedef struct {
+  const sensor_driver_t *def;
+  sensor_driver_stats_t stats;
+  int64_t next_due_us;
+  atomic_bool poll_requested; // by sensor_registry_poll_now
+} driver_slot_t;
+
+static bus_t buses[SENSOR_BUS_COUNT] = {
+    [SENSOR_BUS_I2C0] = {.task_name = "sens_i2c0",
+                         .port = I2C_NUM_0,
+                         .sda_pin = 37,
+                         .scl_pin = 39,
+                         .clk_speed = CONFIG_SENSOR_I2C_CLK_HZ},
+};
+
+static driver_slot_t drivers[SENSOR_REGISTRY_MAX_DRIVERS];
+static size_t n_drivers;
+static bool started;
+
+bool sensor_registry_add(const sensor_driver_t *driver) {
+  if (started || driver == NULL || driver->poll == NULL ||
+      driver->bus >= SENSOR_BUS_COUNT || driver->period_ms == 0)
+    return false;
+
+  if (n_drivers == SENSOR_REGISTRY_MAX_DRIVERS) {
+    ESP_LOGE(TAG, "Too many drivers, %s not added", driver->name);
+    return false;
+  }
+
+  drivers[n_drivers++] = (driver_slot_t){
+      .def = driver,
+      .stats = {.name = driver->name, .bus = driver->bus},
+  };
+  return true;
+}
+
+static void poll_driver(bus_t *bus, driver_slot_t *slot) {
+  const int64_t period_us = (int64_t)slot->def->period_ms * 1000;
+  const int64_t start = esp_timer_get_time();
+  const int64_t wire_start = i2c_trace_bus_us(bus->port);
+
+  const int64_t late_us = start - slot->next_due_us;
+  if (late_us > 0) {
+    slot->stats.late_us_sum += late_us;
+    if (late_us > slot->stats.late_us_max)
+      slot->stats.late_us_max = late_us;
+    if (late_us > slot->def->jitter_us)
+      slot->stats.late++;
+  }
+
+  power_policy_acquire(POWER_ACT_I2C);
+  int64_t next_due = slot->def->poll(&bus->i2c, slot->def->ctx);
+  power_policy_release(POWER_ACT_I2C);
+
+  const int64_t end = esp_timer_get_time();
+  const int64_t took = end - start;
+  slot->stats.polls++;
+  slot->stats.bus_us += took;
+  slot->stats.wire_us += i2c_trace_bus_us(bus->port) - wire_start;
+  if (took > slot->stats.poll_us_max)
+    slot->stats.poll_us_max = took;
+
+  // A late periodic driver is rescheduled from now instead of catching up
+  // in a burst
+  if (next_due <= 0) {
+    next_due = slot->next_due_us + period_us;
+    if (next_due < end)
+      next_due = end + period_us;
+  }
+  slot->next_due_us = next_due;
+}
+
+static void bus_task_loop(void *param) {
+  bus_t *bus = param;
+  const sensor_bus_id_t id = (sensor_bus_id_t)(bus - buses);
+
+  // Internal pull-ups stay on in fast mode too, parallel to the external ones
+  esp_err_t err = i2c_bus_init(&bus->i2c, bus->port, bus->sda_pin,
+                               bus->scl_pin, true, true, bus->clk_speed);
+  if (err != ESP_OK) {
+    LOG_DEFER_E(TAG, "%s: bus init failed, task stopped", bus->task_name);
+    vTaskDelete(NULL);
+    return;
+  }
+  LOG_DEFER_I(TAG, "%s: %lu kHz", bus->task_name,
+              (unsigned long)(bus->clk_speed / 1000));
+
+  const int64_t now = esp_timer_get_time();
+  for (size_t i = 0; i < n_drivers; i++) {
+    driver_slot_t *slot = &drivers[i];
+    if (slot->def->bus != id)
+      continue;
+
+    power_policy_acquire(POWER_ACT_I2C);
+    slot->stats.ready =
+        slot->def->init == NULL || slot->def->init(&bus->i2c, slot->def->ctx);
+    power_policy_release(POWER_ACT_I2C);
+
+    if (!slot->stats.ready)
+      LOG_DEFER_E(TAG, "%s: init failed, driver disabled", slot->def->name);
+    slot->next_due_us = now;
+  }
+
+  while (true) {
+    driver_slot_t *next = NULL;
+
+    for (size_t i = 0; i < n_drivers; i++) {
+      driver_slot_t *slot = &drivers[i];
+      if (slot->def->bus != id || !slot->stats.ready)
+        continue;
+      if (atomic_exchange(&slot->poll_requested, false))
+        slot->next_due_us = esp_timer_get_time();
+      if (next == NULL || slot->next_due_us < next->next_due_us)
+        next = slot;
+    }
+
+    if (next == NULL) {
+      LOG_DEFER_W(TAG, "%s: no driver left, task stopped", bus->task_name);
+      vTaskDelete(NULL);
+      return;
+    }
+
+    // The first tick of a wait may come at once, so a wake-up can be up to a
+    // tick early: check again rather than poll before the due time. A
+    // notification from sensor_registry_poll_now ends the wait.
+    const int64_t wait_us = next->next_due_us - esp_timer_get_time();
+    if (wait_us > 0) {
+      const TickType_t ticks =
+          (TickType_t)((wait_us * configTICK_RATE_HZ + 999999) / 1000000);
+      ulTaskNotifyTake(pdTRUE, ticks);
+      continue;
+    }
+    poll_driver(bus, next);
+  }
+}
+
+bool sensor_registry_start(void) {
+  started = true;
+
+  for (sensor_bus_id_t id = 0; id < SENSOR_BUS_COUNT; id++) {
+    bool used = false;
+    for (size_t i = 0; i < n_drivers && !used; i++)
+      used = drivers[i].def->bus == id;
+    if (!used)
+      continue;
+
+    if (xTaskCreate(bus_task_loop, buses[id].task_name, 4096, &buses[id],
+                    tskIDLE_PRIORITY + 2, &buses[id].task) != pdPASS) {
+      ESP_LOGE(TAG, "Failed to start %s", buses[id].task_name);
+      return false;
+    }
+  }
+
+  ESP_LOGI(TAG, "%u drivers started", (unsigned)n_drivers);
+  return true;
+}
+
+bool sensor_registry_poll_now(const sensor_driver_t *driver) {
+  for (size_t i = 0; i < n_drivers; i++) {
+    if (drivers[i].def != driver)
+      continue;
+
+    atomic_store(&drivers[i].poll_requested, true);
+    // Before the bus task exists the request waits for its first pass
+    if (buses[driver->bus].task)
+      xTaskNotifyGive(buses[driver->bus].task);
+    return true;
+  }
+  return false;
+}
+
+i2c_port_t sensor_registry_port(sensor_bus_id_t bus) {
+  return bus < SENSOR_BUS_COUNT ? buses[bus].port : I2C_NUM_0;
+}
+
+size_t sensor_registry_get_stats(sensor_driver_stats_t *out, size_t max) {
+  size_t n = 0;
+
+  for (size_t i = 0; i < n_drivers && n < max; i++)
+    out[n++] = drivers[i].stats;
+  return n;
+}
@@ -0,0 +1,73 @@
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "i2c_bus.h"
+#include "sample_bus.h"
+
+// Sensor drivers and the buses they sit on. Each bus with drivers gets one
+// task that brings the bus up, initialises its drivers and then polls them
+// in order of their due time, sleeping in between. A driver does all its
+// transactions inside init and poll, so drivers sharing a bus never overlap
+// on the wire. Polls run with the I2C power activity held.
+//
+// A poll starting more than the driver's jitter budget after its due time
+// is counted as late; lateness is recorded per driver.
+//
+// Drivers publish their readings on the sample bus; only the channels they
+// declare may be written.
+
+#define SENSOR_REGISTRY_MAX_DRIVERS 6
+
+typedef enum {
+  SENSOR_BUS_I2C0,
+  SENSOR_BUS_COUNT,
+} sensor_bus_id_t;
+
+typedef struct {
+  const char *name;
+  sensor_bus_id_t bus;
+  sample_mask_t channels;
+  uint32_t period_ms; // poll cadence, unless poll names the next due time
+  uint32_t jitter_us; // tolerated lateness of a poll
+  // Called once on the bus task; a driver failing it is never polled
+  bool (*init)(i2c_bus_t *bus, void *ctx);
+  // Returns the esp_timer time at which the driver next needs a poll, or 0
+  // for period_ms after this poll was due
+  int64_t (*poll)(i2c_bus_t *bus, void *ctx);
+  void *ctx;
+} sensor_driver_t;
+
+typedef struct {
+  const char *name;
+  sensor_bus_id_t bus;
+  bool ready; // init succeeded
+  uint32_t polls;
+  uint32_t late;       // polls started more than jitter_us after due
+  int64_t late_us_sum; // lateness of all polls, for the average
+  int64_t late_us_max;
+  int64_t poll_us_max; // longest poll
+  int64_t bus_us;      // total time spent polling
+  int64_t wire_us;     // of which in I2C transactions
+} sensor_driver_stats_t;
+
+// Before sensor_registry_start only
+bool sensor_registry_add(const sensor_driver_t *driver);
+
+// Starts one task per bus that has drivers
+bool sensor_registry_start(void);
+
+// Wakes the bus task to poll `driver` now instead of at its due time, e.g.
+// after its settings changed. Any task; false if it was never added.
+bool sensor_registry_poll_now(const sensor_driver_t *driver);
+
+// The I2C port behind `bus`, e.g. for i2c_trace
+i2c_port_t sensor_registry_port(sensor_bus_id_t bus);
+
+// Copies the stats of up to `max` drivers, returns the count
+size_t sensor_registry_get_stats(sensor_driver_stats_t *out, size_t max);
+
+#endif
@@ -1,29 +1,82 @@
 #include "sensors_bme680.h"
 
-#include "driver/i2c.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
 #include "freertos/task.h"
-#include <stdio.h>
+#include <stdatomic.h>
 
+#include "boot_report.h"
 #include "bsec2.h"
 #include "bsec_datatypes.h"
 #include "bsec_iaq.h"
+#include "bsec_record.h"
+#include "bsec_state.h"
+#include "i2c_trace.h"
+#include "log_defer.h"
+#include "power_core.h"
 
 static const char *TAG = "BME680";
 
-#define SDA_PIN 37
-#define SCL_PIN 39
-#define I2C_PORT I2C_NUM_0
-#define I2C_CLK_SPEED 100000
+#define BME680_BOOT_MODE BME680_MODE_LP
 
-#define BME680_SAMPLE_RATE BSEC_SAMPLE_RATE_LP
+// The sensor task sleeps until the next call BSEC asks for. Should BSEC
+// not name a time in the future, bsec2_run is polled at this period, which
+// it tolerates: it returns at once when no measurement is due.
+#define BME680_POLL_PERIOD_MS 100
+
+// BSEC's accuracy suffers when calls come late. One tick of lateness comes
+// from the wake-up granularity alone; more means the task was held up.
+#define BME680_JITTER_US (2 * 1000000 / configTICK_RATE_HZ)
+
+// Poll interval once a replayed recording has run out
+#define BME680_REPLAY_IDLE_US (60LL * 60 * 1000000)
+
+#define BME680_CHANNELS                                                        \
+  (SAMPLE_MASK(SAMPLE_CH_IAQ) | SAMPLE_MASK(SAMPLE_CH_TEMP) |                  \
+   SAMPLE_MASK(SAMPLE_CH_PRESSURE) | SAMPLE_MASK(SAMPLE_CH_HUMIDITY) |         \
+   SAMPLE_MASK(SAMPLE_CH_GAS) | SAMPLE_MASK(SAMPLE_CH_CO2_EQ))
+
+// Calibration is saved whenever IAQ accuracy rises to 2 or more, and then
+// periodically while it stays there
+#define BSEC_STATE_SAVE_PERIOD_MS (4 * 60 * 60 * 1000)
+#define BSEC_STATE_MIN_ACCURACY 2
+
+typedef struct {
+  const char *name;
+  float sample_rate;
+  uint32_t sensor_ua; // BME680 datasheet, IAQ in this mode
+} mode_info_t;
+
+static const mode_info_t mode_info[BME680_MODE_COUNT] = {
+    [BME680_MODE_ULP] = {"ULP", BSEC_SAMPLE_RATE_ULP, 90},
+    [BME680_MODE_LP] = {"LP", BSEC_SAMPLE_RATE_LP, 900},
+    [BME680_MODE_CONT] = {"CONT", BSEC_SAMPLE_RATE_CONT, 12000},
+};
 
-static bme680_state_t internal_state;
-static SemaphoreHandle_t data_mutex;
 static bsec2_t bsec_instance;
-static i2c_bus_t i2c_bus;
+static uint8_t iaq_accuracy;
+static uint32_t samples;
+
+// Written by the sensor task; bme680_get_stats copies it from any task, so
+// its 64-bit counters are updated under stats_mux
+static bme680_stats_t stats = {.accuracy2_after_us = -1,
+                               .mode = BME680_BOOT_MODE};
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool state_save_pending;
+static int64_t last_state_save_us;
+
+// The mode BSEC is subscribed at, owned by the sensor task, and the one
+// asked for from any task
+static bme680_mode_t mode = BME680_BOOT_MODE;
+static atomic_int requested_mode = BME680_BOOT_MODE;
+static int64_t mode_since_us;
+
+// Set by bme680_replay: frames come from the recording instead of BSEC
+static bsec_record_reader_t replay_reader;
+static bsec_record_frame_t replay_frame;
+static int64_t replay_offset_us; // recording time to esp_timer time
+static bool replay_done;
 
 static bsec_sensor_t sensors_list[] = {
     BSEC_OUTPUT_STATIC_IAQ,
@@ -34,100 +87,312 @@ static bsec_sensor_t sensors_list[] = {
     BSEC_OUTPUT_CO2_EQUIVALENT,
 };
 
-static void on_read_data(const bme68x_data_t data, const bsec_outputs_t outputs,
-                         bsec2_t bsec2) {
-  if (outputs.n_outputs == 0)
+static sample_channel_t channel_of(uint8_t sensor_id) {
+  switch (sensor_id) {
+  case BSEC_OUTPUT_STATIC_IAQ:
+    return SAMPLE_CH_IAQ;
+  case BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE:
+    return SAMPLE_CH_TEMP;
+  case BSEC_OUTPUT_RAW_PRESSURE:
+    return SAMPLE_CH_PRESSURE;
+  case BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY:
+    return SAMPLE_CH_HUMIDITY;
+  case BSEC_OUTPUT_GAS_PERCENTAGE:
+    return SAMPLE_CH_GAS;
+  case BSEC_OUTPUT_CO2_EQUIVALENT:
+    return SAMPLE_CH_CO2_EQ;
+  default:
+    return SAMPLE_CH_COUNT;
+  }
+}
+
+// Everything downstream of BSEC, for live and replayed frames alike
+static void deliver(const bsec_outputs_t *outputs, int64_t now) {
+  if (outputs->n_outputs == 0)
     return;
 
-  if (xSemaphoreTake(data_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-    for (uint8_t i = 0; i < outputs.n_outputs; i++) {
-      const bsec_data_t output = outputs.output[i];
-
-      switch (output.sensor_id) {
-      case BSEC_OUTPUT_STATIC_IAQ:
-        internal_state.iaq = output.signal;
-        internal_state.accuracy = output.accuracy;
-        break;
-      case BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE:
-        internal_state.temp = output.signal;
-        break;
-      case BSEC_OUTPUT_RAW_PRESSURE:
-        internal_state.pressure = output.signal;
-        break;
-      case BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY:
-        internal_state.humidity = output.signal;
-        break;
-      case BSEC_OUTPUT_GAS_PERCENTAGE:
-        internal_state.gas = output.signal;
-        break;
-      case BSEC_OUTPUT_CO2_EQUIVALENT:
-        internal_state.co2 = output.signal;
-        break;
-      }
-    }
-    xSemaphoreGive(data_mutex);
+  const uint8_t prev_accuracy = iaq_accuracy;
+  sample_mask_t updated = 0;
+
+  for (uint8_t i = 0; i < outputs->n_outputs; i++) {
+    const bsec_data_t output = outputs->output[i];
+    const sample_channel_t ch = channel_of(output.sensor_id);
+
+    if (ch == SAMPLE_CH_COUNT)
+      continue;
+    if (ch == SAMPLE_CH_IAQ)
+      iaq_accuracy = output.accuracy;
 
-    ESP_LOGI(TAG, "T: %.1f, H: %.1f, IAQ: %.0f, Acc: %d", internal_state.temp,
-             internal_state.humidity, internal_state.iaq,
-             internal_state.accuracy);
+    sample_bus_write(ch, output.signal, output.accuracy, now);
+    updated |= SAMPLE_MASK(ch);
   }
+  if (updated == 0)
+    return;
+
+  // Subscribers run here, in the bus task
+  sample_bus_publish(updated);
+  if (++samples == 1)
+    boot_mark(BOOT_PHASE_FIRST_SAMPLE);
+
+  if (iaq_accuracy > prev_accuracy &&
+      iaq_accuracy >= BSEC_STATE_MIN_ACCURACY) {
+    state_save_pending = true;
+
+    if (stats.accuracy2_after_us < 0) {
+      taskENTER_CRITICAL(&stats_mux);
+      stats.accuracy2_after_us = now;
+      taskEXIT_CRITICAL(&stats_mux);
+      LOG_DEFER_I(TAG, "IAQ accuracy %d after %lld s (state %s)",
+                  iaq_accuracy, (long long)(now / 1000000),
+                  stats.state_restored ? "restored" : "fresh");
+    }
+  }
+
+  // Deferred: this runs inside bsec2_run, on the sensor's schedule
+  LOG_DEFER_I(TAG, "T: %.1f, H: %.1f, IAQ: %.0f, Acc: %d",
+              sample_bus_peek(SAMPLE_CH_TEMP)->value,
+              sample_bus_peek(SAMPLE_CH_HUMIDITY)->value,
+              sample_bus_peek(SAMPLE_CH_IAQ)->value, iaq_accuracy);
+}
+
+static void on_read_data(const bme68x_data_t data, const bsec_outputs_t outputs,
+                         bsec2_t bsec2) {
+  const int64_t now = esp_timer_get_time();
+
+  bsec_record_frame(now, &data, &outputs);
+  deliver(&outputs, now);
 }
 
-static bool hw_init(void) {
-  esp_err_t err = i2c_bus_init(&i2c_bus, I2C_PORT, SDA_PIN, SCL_PIN, true, true,
-                               I2C_CLK_SPEED);
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "I2C Init Error");
+// The first frame is delivered by the first poll, right after init
+static bool replay_init(void) {
+  if (!bsec_record_next(&replay_reader, &replay_frame)) {
+    LOG_DEFER_E(TAG, "Empty recording");
     return false;
   }
 
-  if (!bsec2_init(&bsec_instance, &i2c_bus, BME68X_I2C_INTF)) {
-    ESP_LOGE(TAG, "BSEC2 Init Error");
+  replay_offset_us = esp_timer_get_time() - replay_frame.timestamp_us;
+  LOG_DEFER_I(TAG, "Replaying a recording");
+  boot_mark(BOOT_PHASE_SENSOR_READY);
+  return true;
+}
+
+static int64_t replay_poll(void) {
+  const int64_t now = esp_timer_get_time();
+
+  // Nothing left to deliver
+  if (replay_done)
+    return now + BME680_REPLAY_IDLE_US;
+
+  deliver(&replay_frame.outputs, now);
+  taskENTER_CRITICAL(&stats_mux);
+  stats.replayed++;
+  taskEXIT_CRITICAL(&stats_mux);
+
+  if (!bsec_record_next(&replay_reader, &replay_frame)) {
+    LOG_DEFER_I(TAG, "Replay finished after %lu frames",
+                (unsigned long)stats.replayed);
+    replay_done = true;
+    return now + BME680_REPLAY_IDLE_US;
+  }
+  return replay_frame.timestamp_us + replay_offset_us;
+}
+
+// Sensor bring-up and BSEC state restore run on the bus task, concurrently
+// with the display init in the dashboard task
+static bool bme680_init(i2c_bus_t *bus, void *ctx) {
+  if (replay_reader.buf)
+    return replay_init();
+
+  if (!bsec2_init(&bsec_instance, bus, BME68X_I2C_INTF)) {
+    LOG_DEFER_E(TAG, "BSEC2 Init Error");
     return false;
   }
 
   bsec2_set_temperature_offset(&bsec_instance, 3.0f);
   bsec2_set_config(&bsec_instance, bsec_config_iaq);
 
+  uint8_t state[BSEC_MAX_STATE_BLOB_SIZE];
+  if (bsec_state_load(state, sizeof(state), bsec_config_iaq,
+                      sizeof(bsec_config_iaq))) {
+    const bool restored = bsec2_set_state(&bsec_instance, state);
+    taskENTER_CRITICAL(&stats_mux);
+    stats.state_restored = restored;
+    taskEXIT_CRITICAL(&stats_mux);
+    LOG_DEFER_I(TAG, "BSEC state %s",
+                restored ? "restored" : "rejected by BSEC");
+  }
+
+  // A mode asked for before the sensor task ran is taken from the start
+  mode = atomic_load(&requested_mode);
   if (!bsec2_update_subscription(&bsec_instance, sensors_list,
-                                 ARRAY_LEN(sensors_list), BME680_SAMPLE_RATE)) {
-    ESP_LOGE(TAG, "BSEC2 Subscription Error");
+                                 ARRAY_LEN(sensors_list),
+                                 mode_info[mode].sample_rate)) {
+    LOG_DEFER_E(TAG, "BSEC2 Subscription Error");
     return false;
   }
+  taskENTER_CRITICAL(&stats_mux);
+  stats.mode = mode;
+  mode_since_us = esp_timer_get_time();
+  taskEXIT_CRITICAL(&stats_mux);
+  LOG_DEFER_I(TAG, "%s mode", mode_info[mode].name);
 
   bsec2_attach_callback(&bsec_instance, on_read_data);
+  boot_mark(BOOT_PHASE_SENSOR_READY);
   return true;
 }
 
-static void bme680_task_loop(void *param) {
-  while (true) {
-    bsec2_run(&bsec_instance);
-    vTaskDelay(pdMS_TO_TICKS(100));
+static void save_state(void) {
+  uint8_t state[BSEC_MAX_STATE_BLOB_SIZE];
+
+  state_save_pending = false;
+  last_state_save_us = esp_timer_get_time();
+
+  if (bsec2_get_state(&bsec_instance, state) &&
+      bsec_state_save(state, sizeof(state), bsec_config_iaq,
+                      sizeof(bsec_config_iaq))) {
+    taskENTER_CRITICAL(&stats_mux);
+    stats.state_saves++;
+    taskEXIT_CRITICAL(&stats_mux);
+    LOG_DEFER_I(TAG, "BSEC state saved (accuracy %d)", iaq_accuracy);
+  }
+}
+
+// Outside the BSEC callback, like the state save
+static void apply_mode(void) {
+  const bme680_mode_t want = atomic_load(&requested_mode);
+  if (want == mode)
+    return;
+
+  // BSEC checks a subscription before applying it, so on failure the old
+  // one is still in place
+  if (!bsec2_update_subscription(&bsec_instance, sensors_list,
+                                 ARRAY_LEN(sensors_list),
+                                 mode_info[want].sample_rate)) {
+    LOG_DEFER_E(TAG, "BSEC rejected %s mode, staying in %s",
+                mode_info[want].name, mode_info[mode].name);
+    taskENTER_CRITICAL(&stats_mux);
+    stats.mode_failures++;
+    taskEXIT_CRITICAL(&stats_mux);
+    int expected = want;
+    atomic_compare_exchange_strong(&requested_mode, &expected, mode);
+    return;
+  }
+
+  const int64_t now = esp_timer_get_time();
+
+  // A faster mode starts at once, not at the next call of the slower one,
+  // which in ULP can be minutes away
+  if (mode_info[want].sample_rate > mode_info[mode].sample_rate)
+    bsec_instance.bme_conf.next_call = now * 1000;
+
+  LOG_DEFER_I(TAG, "%s -> %s mode, accuracy %d kept", mode_info[mode].name,
+              mode_info[want].name, iaq_accuracy);
+  taskENTER_CRITICAL(&stats_mux);
+  stats.modes[mode].time_us += now - mode_since_us;
+  mode_since_us = now;
+  stats.mode = want;
+  stats.mode_switches++;
+  taskEXIT_CRITICAL(&stats_mux);
+  mode = want;
+}
+
+static int64_t bme680_poll(i2c_bus_t *bus, void *ctx) {
+  if (replay_reader.buf)
+    return replay_poll();
+
+  const i2c_port_t port = sensor_registry_port(bme680_driver.bus);
+  const int64_t wire_start = i2c_trace_bus_us(port);
+  apply_mode();
+
+  const int64_t start = esp_timer_get_time();
+
+  // The bsec2 component does its I2C transfers inside bsec2_run
+  bsec2_run(&bsec_instance);
+
+  // Calls with no measurement due never touch the bus
+  const int64_t wire_us = i2c_trace_bus_us(port) - wire_start;
+  if (wire_us > 0) {
+    const int64_t run_us = esp_timer_get_time() - start;
+    taskENTER_CRITICAL(&stats_mux);
+    stats.bsec_runs++;
+    stats.bsec_run_us += run_us;
+    stats.bsec_wire_us += wire_us;
+    if (run_us > stats.bsec_run_us_max)
+      stats.bsec_run_us_max = run_us;
+    stats.modes[mode].runs++;
+    stats.modes[mode].run_us += run_us;
+    taskEXIT_CRITICAL(&stats_mux);
   }
+
+  // Outside the BSEC callback: the library must not be re-entered
+  bool period_due = iaq_accuracy >= BSEC_STATE_MIN_ACCURACY &&
+                    esp_timer_get_time() - last_state_save_us >=
+                        (int64_t)BSEC_STATE_SAVE_PERIOD_MS * 1000;
+  if (state_save_pending || period_due)
+    save_state();
+
+  // next_call is in esp_timer nanoseconds
+  const int64_t next_us = bsec_instance.bme_conf.next_call / 1000;
+  return next_us > esp_timer_get_time() ? next_us : 0;
 }
 
-bool bme680_start(void) {
-  data_mutex = xSemaphoreCreateMutex();
-  if (data_mutex == NULL)
+const sensor_driver_t bme680_driver = {
+    .name = "bme680",
+    .bus = SENSOR_BUS_I2C0,
+    .channels = BME680_CHANNELS,
+    .period_ms = BME680_POLL_PERIOD_MS,
+    .jitter_us = BME680_JITTER_US,
+    .init = bme680_init,
+    .poll = bme680_poll,
+};
+
+bool bme680_replay(const uint8_t *buf, size_t len) {
+  if (!bsec_record_reader_init(&replay_reader, buf, len)) {
+    ESP_LOGE(TAG, "Not a recording");
     return false;
+  }
+  return true;
+}
 
-  if (!hw_init())
+bool bme680_set_mode(bme680_mode_t new_mode) {
+  if (new_mode < 0 || new_mode >= BME680_MODE_COUNT)
     return false;
 
-  xTaskCreate(bme680_task_loop, "bme_task", 4096, NULL, tskIDLE_PRIORITY + 2,
-              NULL);
-  ESP_LOGI(TAG, "Task started");
+  atomic_store(&requested_mode, new_mode);
+  // Not added yet: init picks the mode up
+  sensor_registry_poll_now(&bme680_driver);
   return true;
 }
 
-void bme680_get_data(bme680_state_t *out_data) {
-  if (out_data == NULL)
+bme680_mode_t bme680_get_mode(void) { return atomic_load(&requested_mode); }
+
+const char *bme680_mode_name(bme680_mode_t m) {
+  return m >= 0 && m < BME680_MODE_COUNT ? mode_info[m].name : "?";
+}
+
+uint32_t bme680_mode_budget_ua(bme680_mode_t m, const bme680_mode_stats_t *s) {
+  static const power_core_config_t power = POWER_CORE_DEFAULT_CONFIG;
+
+  if (m < 0 || m >= BME680_MODE_COUNT)
+    return 0;
+
+  uint32_t ua = mode_info[m].sensor_ua;
+  if (s && s->time_us > 0)
+    ua += (uint32_t)((double)power.state_ua[POWER_STATE_BUS] *
+                     (double)s->run_us / (double)s->time_us);
+  return ua;
+}
+
+void bme680_get_stats(bme680_stats_t *out) {
+  if (out == NULL)
     return;
 
-  if (xSemaphoreTake(data_mutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-    *out_data = internal_state;
-    xSemaphoreGive(data_mutex);
-  } else {
-    ESP_LOGW(TAG, "Mutex timeout on read");
-  }
+  taskENTER_CRITICAL(&stats_mux);
+  *out = stats;
+  const int64_t since_us = mode_since_us;
+  taskEXIT_CRITICAL(&stats_mux);
+
+  // The current mode, up to now
+  if (since_us > 0)
+    out->modes[out->mode].time_us += esp_timer_get_time() - since_us;
 }
@@ -1,21 +1,68 @@
 #ifndef SENSORS_BME680_H
 #define SENSORS_BME680_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "sensor_registry.h"
+
+// BSEC sampling modes. A switch re-subscribes the BSEC outputs at the new
+// rate on the sensor task; the BSEC state, and with it the calibration,
+// carries over.
+typedef enum {
+    BME680_MODE_ULP,  // every 5 min
+    BME680_MODE_LP,   // every 3 s
+    BME680_MODE_CONT, // every second
+    BME680_MODE_COUNT,
+} bme680_mode_t;
+
+// Time spent in one mode and what it cost
 typedef struct {
-    float iaq;        
-    float temp;       
-    float pressure;   
-    float humidity;   
-    float gas;        
-    float co2;        
-    uint8_t accuracy;
-} bme680_state_t;
-
-bool bme680_start(void);
-
-void bme680_get_data(bme680_state_t *out_data);
+    int64_t time_us;
+    uint32_t runs;   // measuring bsec2_run calls
+    int64_t run_us;  // spent in them, with the I2C power activity held
+} bme680_mode_stats_t;
+
+typedef struct {
+    bool state_restored;       // BSEC calibration loaded from NVS at boot
+    uint32_t state_saves;
+    int64_t accuracy2_after_us; // boot to IAQ accuracy >= 2, -1 until then
+    // bsec2_run calls that talked to the sensor, and where their time went
+    uint32_t bsec_runs;
+    int64_t bsec_run_us;
+    int64_t bsec_wire_us;       // in I2C transactions; the rest is BSEC and
+                                // the sample bus subscribers
+    int64_t bsec_run_us_max;
+    bme680_mode_t mode;
+    uint32_t mode_switches;
+    uint32_t mode_failures;     // rejected by BSEC, the old mode stays
+    bme680_mode_stats_t modes[BME680_MODE_COUNT];
+    uint32_t replayed;          // frames taken from a recording
+} bme680_stats_t;
+
+// BME680 through BSEC2. Publishes IAQ, temperature, pressure, humidity, gas
+// percentage and the CO2 equivalent, all captured at the same time.
+extern const sensor_driver_t bme680_driver;
+
+// Before sensor_registry_start: the driver then feeds `buf`, a recording
+// (bsec_record.h), through the same pipeline at its recorded pace, instead
+// of running BSEC. Nothing is saved as BSEC state. `buf` must stay valid.
+bool bme680_replay(const uint8_t *buf, size_t len);
+
+// Takes effect within a poll of the sensor task, which is woken for it.
+// Any task.
+bool bme680_set_mode(bme680_mode_t mode);
+// The mode last asked for, until BSEC rejects it
+bme680_mode_t bme680_get_mode(void);
+const char *bme680_mode_name(bme680_mode_t mode);
+
+// Average current of the mode from its stats: the sensor's own figure from
+// the datasheet plus the MCU held awake on the bus for the measured duty
+// cycle. Display and idle CPU are not included.
+uint32_t bme680_mode_budget_ua(bme680_mode_t mode,
+                               const bme680_mode_stats_t *s);
+
+void bme680_get_stats(bme680_stats_t *out);
 
 #endif
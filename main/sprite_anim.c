@@ -0,0 +1,59 @@
+#include "sprite_anim.h"
+
+typedef struct {
+  lv_obj_t *img;
+  lv_timer_t *timer;
+  const sprite_anim_dsc_t *dsc;
+  uint16_t index;
+} sprite_anim_t;
+
+static sprite_anim_stats_t stats;
+
+static void next_frame(lv_timer_t *timer) {
+  sprite_anim_t *anim = lv_timer_get_user_data(timer);
+
+  anim->index = (anim->index + 1) % anim->dsc->frame_count;
+  lv_image_set_src(anim->img, &anim->dsc->frames[anim->index]);
+  lv_timer_set_period(timer, anim->dsc->durations_ms[anim->index]);
+
+  stats.frames_shown++;
+}
+
+static void on_delete(lv_event_t *e) {
+  sprite_anim_t *anim = lv_event_get_user_data(e);
+
+  lv_timer_delete(anim->timer);
+  lv_free(anim);
+}
+
+lv_obj_t *sprite_anim_create(lv_obj_t *parent, const sprite_anim_dsc_t *dsc) {
+  lv_mem_monitor_t before, after;
+  lv_mem_monitor(&before);
+
+  lv_obj_t *img = lv_image_create(parent);
+  lv_image_set_src(img, &dsc->frames[0]);
+
+  // A single frame needs no timer
+  if (dsc->frame_count > 1) {
+    sprite_anim_t *anim = lv_malloc(sizeof(*anim));
+    if (anim == NULL)
+      return img;
+
+    anim->img = img;
+    anim->dsc = dsc;
+    anim->index = 0;
+    anim->timer = lv_timer_create(next_frame, dsc->durations_ms[0], anim);
+    lv_obj_add_event_cb(img, on_delete, LV_EVENT_DELETE, anim);
+  }
+
+  lv_mem_monitor(&after);
+  if (before.free_size > after.free_size)
+    stats.heap_bytes += before.free_size - after.free_size;
+
+  return img;
+}
+
+void sprite_anim_get_stats(sprite_anim_stats_t *out) {
+  if (out)
+    *out = stats;
+}
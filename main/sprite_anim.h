@@ -0,0 +1,30 @@
+#ifndef SPRITE_ANIM_H
+#define SPRITE_ANIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lvgl.h"
+
+// Frame-by-frame animation of images decoded at build time (see
+// tools/gif_to_sprite.py). Switching frames only swaps the image source, so
+// no decoder runs and no canvas is allocated at run time.
+
+typedef struct {
+  const lv_image_dsc_t *frames;
+  const uint16_t *durations_ms;
+  uint16_t frame_count;
+  size_t sheet_bytes; // flash used by the pixel data
+} sprite_anim_dsc_t;
+
+typedef struct {
+  uint32_t frames_shown;
+  size_t heap_bytes; // LVGL heap taken by the widget when created
+} sprite_anim_stats_t;
+
+lv_obj_t *sprite_anim_create(lv_obj_t *parent, const sprite_anim_dsc_t *dsc);
+
+// Totals over all animations
+void sprite_anim_get_stats(sprite_anim_stats_t *out);
+
+#endif
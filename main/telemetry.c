@@ -0,0 +1,177 @@
+#include "telemetry.h"
+
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sample_bus.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "TELEMETRY";
+
+#define TELEMETRY_HEADER_LEN 19
+#define TELEMETRY_CHANNEL_LEN 5
+#define TELEMETRY_PAYLOAD_MAX                                                  \
+  (TELEMETRY_HEADER_LEN + SAMPLE_CH_COUNT * TELEMETRY_CHANNEL_LEN + 4)
+// COBS adds one byte per 254, and the frame has a 0x00 at either end
+#define TELEMETRY_FRAME_MAX                                                    \
+  (TELEMETRY_PAYLOAD_MAX + TELEMETRY_PAYLOAD_MAX / 254 + 1 + 2)
+
+// A minute of LP mode samples; a power of two
+#define TELEMETRY_SLOTS 32
+
+#define TELEMETRY_ALL_CHANNELS (SAMPLE_MASK(SAMPLE_CH_COUNT) - 1)
+
+typedef struct {
+  uint8_t len;
+  uint8_t buf[TELEMETRY_FRAME_MAX];
+} telemetry_slot_t;
+
+// Publishers fill slots at head, one at a time under the lock; the writer
+// empties them from tail without taking it
+static telemetry_slot_t slots[TELEMETRY_SLOTS];
+static atomic_uint head;
+static atomic_uint tail;
+static portMUX_TYPE head_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t next_seq;
+static FILE *out_file;
+static TaskHandle_t writer_task;
+static telemetry_stats_t stats;
+
+static uint8_t *put_le(uint8_t *p, uint64_t v, int len) {
+  for (int i = 0; i < len; i++)
+    *p++ = (uint8_t)(v >> (8 * i));
+  return p;
+}
+
+// Returns the encoded length; `out` holds at least len + len / 254 + 1
+static size_t cobs_encode(const uint8_t *in, size_t len, uint8_t *out) {
+  uint8_t *code = out;
+  uint8_t *p = out + 1;
+  uint8_t run = 1;
+
+  for (size_t i = 0; i < len; i++) {
+    if (in[i] != 0) {
+      *p++ = in[i];
+      run++;
+    }
+    if (in[i] == 0 || run == 0xff) {
+      *code = run;
+      code = p++;
+      run = 1;
+    }
+  }
+  *code = run;
+  return (size_t)(p - out);
+}
+
+// In the publishing driver's task: only the channels in `updated` may be
+// peeked
+static size_t encode_frame(uint8_t *frame, uint32_t seq,
+                           sample_mask_t updated) {
+  uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+  int64_t time_us = 0;
+
+  for (int ch = 0; ch < SAMPLE_CH_COUNT; ch++)
+    if (updated & SAMPLE_MASK(ch)) {
+      time_us = sample_bus_peek(ch)->timestamp_us;
+      break;
+    }
+
+  uint8_t *p = payload;
+  *p++ = TELEMETRY_VERSION;
+  p = put_le(p, seq, 4);
+  p = put_le(p, (uint64_t)time_us, 8);
+  p = put_le(p, (uint32_t)time(NULL), 4);
+  p = put_le(p, updated, 2);
+  for (int ch = 0; ch < SAMPLE_CH_COUNT; ch++) {
+    if ((updated & SAMPLE_MASK(ch)) == 0)
+      continue;
+    const sample_t *s = sample_bus_peek(ch);
+    uint32_t bits;
+    memcpy(&bits, &s->value, sizeof(bits));
+    p = put_le(p, bits, 4);
+    *p++ = s->accuracy;
+  }
+  const size_t len = (size_t)(p - payload);
+  p = put_le(p, esp_rom_crc32_le(0, payload, len), 4);
+
+  frame[0] = 0;
+  const size_t n = cobs_encode(payload, (size_t)(p - payload), frame + 1);
+  frame[n + 1] = 0;
+  return n + 2;
+}
+
+// Sample bus callback, in the publishing driver's task. Encoding happens
+// outside the lock; the slot only takes a copy.
+static void on_samples(sample_mask_t updated, void *ctx) {
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  bool queued = false;
+
+  taskENTER_CRITICAL(&head_lock);
+  const uint32_t seq = next_seq++;
+  taskEXIT_CRITICAL(&head_lock);
+
+  const size_t len = encode_frame(frame, seq, updated);
+
+  taskENTER_CRITICAL(&head_lock);
+  const unsigned h = atomic_load_explicit(&head, memory_order_relaxed);
+  if (h - atomic_load_explicit(&tail, memory_order_acquire) <
+      TELEMETRY_SLOTS) {
+    telemetry_slot_t *slot = &slots[h % TELEMETRY_SLOTS];
+    memcpy(slot->buf, frame, len);
+    slot->len = (uint8_t)len;
+    atomic_store_explicit(&head, h + 1, memory_order_release);
+    stats.frames++;
+    queued = true;
+  } else {
+    stats.dropped++;
+  }
+  taskEXIT_CRITICAL(&head_lock);
+
+  if (queued)
+    xTaskNotifyGive(writer_task);
+}
+
+// Each frame goes out in one fwrite, so console lines from other tasks
+// land between frames rather than inside one
+static void telemetry_task(void *param) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    unsigned t = atomic_load_explicit(&tail, memory_order_relaxed);
+    while (t != atomic_load_explicit(&head, memory_order_acquire)) {
+      const telemetry_slot_t *slot = &slots[t % TELEMETRY_SLOTS];
+      stats.bytes += fwrite(slot->buf, 1, slot->len, out_file);
+      atomic_store_explicit(&tail, ++t, memory_order_release);
+    }
+    fflush(out_file);
+  }
+}
+
+bool telemetry_start(FILE *out) {
+  if (out == NULL)
+    return false;
+  out_file = out;
+
+  if (xTaskCreate(telemetry_task, "telemetry", 3072, NULL,
+                  tskIDLE_PRIORITY + 1, &writer_task) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start task");
+    return false;
+  }
+
+  if (!sample_bus_subscribe("telemetry", TELEMETRY_ALL_CHANNELS, on_samples,
+                            NULL)) {
+    ESP_LOGE(TAG, "Failed to subscribe");
+    return false;
+  }
+  return true;
+}
+
+void telemetry_get_stats(telemetry_stats_t *out) {
+  if (out)
+    *out = stats;
+}
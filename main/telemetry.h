@@ -0,0 +1,42 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Binary telemetry: one frame per sample bus publish, for machines rather
+// than people. Frames are encoded in the publishing task into a ring that a
+// low priority task writes out, so a slow or missing host never holds up a
+// sensor bus. A frame that finds the ring full is dropped and counted.
+//
+// Each frame is COBS encoded between two 0x00 bytes, so console text
+// around it is skipped by the decoder (tools/telemetry_decode.py). Decoded,
+// little endian:
+//
+//   u8   version
+//   u32  sequence number, +1 per publish; a gap is a dropped frame
+//   i64  esp_timer time the samples were captured, us
+//   u32  wall clock (time()), s
+//   u16  channel mask, bit n for sample_channel_t n
+//   per channel in the mask, lowest first: f32 value, u8 accuracy
+//   u32  CRC32 (esp_rom_crc32_le) of all the above
+//
+// A BME680 publish, six channels, is 56 bytes on the wire.
+
+#define TELEMETRY_VERSION 1
+
+typedef struct {
+  uint32_t frames;  // queued for the writer
+  uint32_t dropped; // the ring was full
+  uint64_t bytes;   // written out
+} telemetry_stats_t;
+
+// Subscribes to every sample bus channel and starts the writer task, which
+// writes to `out`. On the device `out` is the console, which must pass 0x0a
+// unchanged (LF line endings).
+bool telemetry_start(FILE *out);
+
+void telemetry_get_stats(telemetry_stats_t *out);
+
+#endif
@@ -1,19 +1,31 @@
 #include "ui.h"
 #include "font/lv_font.h"
 #include "lv_conf_internal.h"
-#include <stdio.h>
+#include <string.h>
 
-LV_IMG_DECLARE(kitty_gif);
+#include "sdkconfig.h"
 
-LV_FONT_DECLARE(lv_font_montserrat_10);
-LV_FONT_DECLARE(lv_font_montserrat_14);
-LV_FONT_DECLARE(lv_font_montserrat_20);
-LV_FONT_DECLARE(lv_font_montserrat_28);
+#include "dashboard.h"
+#include "sprite_anim.h"
+#include "ui_diag.h"
+#include "ui_fmt.h"
+#include "ui_history.h"
+#include "ui_screens.h"
 
-#define FONT_TINY &lv_font_montserrat_10
-#define FONT_SMALL &lv_font_montserrat_12
-#define FONT_MEDIUM &lv_font_montserrat_20
-#define FONT_LARGE &lv_font_montserrat_28
+// Generated at build time from assets/kitty.gif
+extern const sprite_anim_dsc_t kitty_sprite;
+
+// Montserrat subsets generated at build time with only the glyphs the UI
+// strings can render (tools/font_subset.py)
+LV_FONT_DECLARE(ui_font_montserrat_10);
+LV_FONT_DECLARE(ui_font_montserrat_12);
+LV_FONT_DECLARE(ui_font_montserrat_20);
+LV_FONT_DECLARE(ui_font_montserrat_28);
+
+#define FONT_TINY &ui_font_montserrat_10
+#define FONT_SMALL &ui_font_montserrat_12
+#define FONT_MEDIUM &ui_font_montserrat_20
+#define FONT_LARGE &ui_font_montserrat_28
 
 #define COLOR_BG lv_color_hex(0x000000)
 #define COLOR_CARD lv_color_hex(0x181818)
@@ -27,6 +39,76 @@ LV_FONT_DECLARE(lv_font_montserrat_28);
 #define COLOR_WARN lv_palette_main(LV_PALETTE_YELLOW)
 #define COLOR_BAD lv_palette_main(LV_PALETTE_RED)
 
+// Written out here rather than taken from bme680_mode_name, so the font
+// subset sees their glyphs
+static const char *const mode_text[BME680_MODE_COUNT] = {
+    [BME680_MODE_ULP] = "ULP",
+    [BME680_MODE_LP] = "LP",
+    [BME680_MODE_CONT] = "CONT",
+};
+
+static ui_update_stats_t update_stats;
+static ui_state_t dashboard;
+
+static void set_label_text(lv_obj_t *lbl, ui_widget_cache_t *cache,
+                           const char *text) {
+  if (cache->has_text && strcmp(cache->text, text) == 0) {
+    update_stats.skipped++;
+    return;
+  }
+
+  lv_label_set_text(lbl, text);
+  update_stats.applied++;
+
+  // Strings that don't fit are never cached, so they are always applied
+  size_t len = strlen(text);
+  cache->has_text = len < sizeof(cache->text);
+  if (cache->has_text)
+    memcpy(cache->text, text, len + 1);
+}
+
+static void set_text_color(lv_obj_t *obj, ui_widget_cache_t *cache,
+                           lv_color_t color) {
+  if (cache->has_color && lv_color_eq(cache->color, color)) {
+    update_stats.skipped++;
+    return;
+  }
+
+  lv_obj_set_style_text_color(obj, color, 0);
+  update_stats.applied++;
+
+  cache->color = color;
+  cache->has_color = true;
+}
+
+static void set_arc_value(lv_obj_t *arc, ui_widget_cache_t *cache,
+                          int32_t value) {
+  if (cache->has_value && cache->value == value) {
+    update_stats.skipped++;
+    return;
+  }
+
+  lv_arc_set_value(arc, value);
+  update_stats.applied++;
+
+  cache->value = value;
+  cache->has_value = true;
+}
+
+static void set_bar_value(lv_obj_t *bar, ui_widget_cache_t *cache,
+                          int32_t value) {
+  if (cache->has_value && cache->value == value) {
+    update_stats.skipped++;
+    return;
+  }
+
+  lv_bar_set_value(bar, value, LV_ANIM_ON);
+  update_stats.applied++;
+
+  cache->value = value;
+  cache->has_value = true;
+}
+
 static lv_obj_t *create_card(lv_obj_t *parent) {
   lv_obj_t *card = lv_obj_create(parent);
   lv_obj_set_style_bg_color(card, COLOR_CARD, 0);
@@ -47,17 +129,29 @@ static void style_text_value(lv_obj_t *lbl) {
   lv_obj_set_style_text_color(lbl, COLOR_TEXT_MAIN, 0);
 }
 
-ui_state_t ui_setup(lv_display_t *display) {
+static void on_diag_open(lv_event_t *e) {
+  (void)e;
+  ui_screens_show(UI_SCREEN_DIAG);
+}
+
+// Cycles ULP -> LP -> CONT; the dashboard task updates the label
+static void on_mode_tap(lv_event_t *e) {
+  (void)e;
+  bme680_set_mode((bme680_get_mode() + 1) % BME680_MODE_COUNT);
+  dashboard_notify(DASHBOARD_EVT_MODE);
+}
+
+static void build_dashboard(lv_obj_t *screen, void *ctx) {
+  ui_state_t *out = ctx;
   ui_state_t ui;
+  memset(&ui.cache, 0, sizeof(ui.cache));
 
-  ui.screen = lv_obj_create(NULL);
+  ui.screen = screen;
   lv_obj_set_style_bg_color(ui.screen, COLOR_BG, 0);
 
   lv_obj_set_scrollbar_mode(ui.screen, LV_SCROLLBAR_MODE_OFF);
   lv_obj_clear_flag(ui.screen, LV_OBJ_FLAG_SCROLLABLE);
 
-  lv_screen_load(ui.screen);
-
   lv_obj_set_flex_flow(ui.screen, LV_FLEX_FLOW_COLUMN);
 
   lv_obj_set_style_pad_all(ui.screen, 2, 0);
@@ -97,7 +191,7 @@ ui_state_t ui_setup(lv_display_t *display) {
   lv_obj_set_style_text_font(ui.lbl_bat, FONT_SMALL, 0);
   lv_obj_set_style_text_color(ui.lbl_bat, COLOR_GOOD, 0);
 
-  // 4. GIF
+  // 4. KITTY
   ui.gif_container = lv_obj_create(row_top);
   lv_obj_set_size(ui.gif_container, 50, 50);
   lv_obj_set_style_bg_color(ui.gif_container, lv_color_hex(0x222222), 0);
@@ -105,8 +199,12 @@ ui_state_t ui_setup(lv_display_t *display) {
   lv_obj_set_style_border_width(ui.gif_container, 0, 0);
   lv_obj_set_scrollbar_mode(ui.gif_container, LV_SCROLLBAR_MODE_OFF);
 
-  lv_obj_t *gif = lv_gif_create(ui.gif_container);
-  lv_gif_set_src(gif, &kitty_gif);
+  sprite_anim_create(ui.gif_container, &kitty_sprite);
+
+  // A long press on the kitty opens the hidden diagnostics screen
+  lv_obj_add_flag(ui.gif_container, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_add_event_cb(ui.gif_container, on_diag_open, LV_EVENT_LONG_PRESSED,
+                      NULL);
 
   // ==========================================
   // ROW 2: TEMPERATURE | HUMIDITY
@@ -175,11 +273,22 @@ ui_state_t ui_setup(lv_display_t *display) {
   lv_obj_set_flex_align(card_air, LV_FLEX_ALIGN_SPACE_AROUND,
                         LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
+  // A tap anywhere on the card changes the sampling mode
+  lv_obj_add_event_cb(card_air, on_mode_tap, LV_EVENT_CLICKED, NULL);
+
+  ui.lbl_mode = lv_label_create(card_air);
+  lv_label_set_text(ui.lbl_mode, "--");
+  lv_obj_add_flag(ui.lbl_mode, LV_OBJ_FLAG_IGNORE_LAYOUT);
+  lv_obj_align(ui.lbl_mode, LV_ALIGN_TOP_RIGHT, 0, -8);
+  lv_obj_set_style_text_font(ui.lbl_mode, FONT_TINY, 0);
+  lv_obj_set_style_text_color(ui.lbl_mode, COLOR_TEXT_SEC, 0);
+
   // 1. IAQ
   lv_obj_t *cont_iaq = lv_obj_create(card_air);
   lv_obj_set_style_bg_opa(cont_iaq, 0, 0);
   lv_obj_set_style_border_width(cont_iaq, 0, 0);
   lv_obj_set_size(cont_iaq, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+  lv_obj_clear_flag(cont_iaq, LV_OBJ_FLAG_CLICKABLE);
   lv_obj_set_flex_flow(cont_iaq, LV_FLEX_FLOW_COLUMN);
   lv_obj_set_flex_align(cont_iaq, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER,
                         LV_FLEX_ALIGN_CENTER);
@@ -208,6 +317,7 @@ ui_state_t ui_setup(lv_display_t *display) {
   lv_obj_set_style_bg_opa(cont_co2, 0, 0);
   lv_obj_set_style_border_width(cont_co2, 0, 0);
   lv_obj_set_size(cont_co2, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+  lv_obj_clear_flag(cont_co2, LV_OBJ_FLAG_CLICKABLE);
   lv_obj_set_flex_flow(cont_co2, LV_FLEX_FLOW_COLUMN);
   lv_obj_set_flex_align(cont_co2, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER,
                         LV_FLEX_ALIGN_CENTER);
@@ -226,74 +336,105 @@ ui_state_t ui_setup(lv_display_t *display) {
   lv_obj_set_style_text_font(ui.lbl_press_val, FONT_TINY, 0);
   lv_obj_set_style_text_color(ui.lbl_press_val, COLOR_TEXT_SEC, 0);
 
-  return ui;
+  *out = ui;
+}
+
+ui_state_t ui_setup(lv_display_t *display) {
+  static const ui_screen_def_t screens[UI_SCREEN_COUNT] = {
+      [UI_SCREEN_DASHBOARD] = {.name = "dashboard",
+                               .build = build_dashboard,
+                               .ctx = &dashboard,
+                               .resident = true},
+      [UI_SCREEN_HISTORY] = {.name = "history", .build = ui_history_build},
+      [UI_SCREEN_DIAG] = {.name = "diagnostics",
+                          .build = ui_diag_build,
+                          .hidden = true},
+  };
+
+  ui_screens_init(CONFIG_UI_SCREEN_BUDGET_KB * 1024);
+  for (int i = 0; i < UI_SCREEN_COUNT; i++)
+    ui_screens_add(i, &screens[i]);
+
+  ui_screens_show(UI_SCREEN_DASHBOARD);
+  return dashboard;
 }
 
-void ui_sensors_update(ui_state_t *ui, const bme680_state_t *data) {
-  if (!ui || !data)
+void ui_sensors_update(ui_state_t *ui, const sample_t *samples) {
+  if (!ui || !samples)
     return;
   char buf[32];
+  const float temp = samples[SAMPLE_CH_TEMP].value;
+  const float humidity = samples[SAMPLE_CH_HUMIDITY].value;
+  const float iaq = samples[SAMPLE_CH_IAQ].value;
+  const sample_t *co2 = samples[SAMPLE_CH_CO2].seq != 0
+                            ? &samples[SAMPLE_CH_CO2]
+                            : &samples[SAMPLE_CH_CO2_EQ];
 
   // Temp
-  snprintf(buf, sizeof(buf), "%.1f°", data->temp);
-  lv_label_set_text(ui->lbl_temp_val, buf);
-  int temp_arc = (int)((data->temp / 40.0) * 100);
+  ui_fmt_temp(buf, sizeof(buf), temp);
+  set_label_text(ui->lbl_temp_val, &ui->cache.temp_val, buf);
+  int temp_arc = (int)((temp / 40.0) * 100);
   if (temp_arc > 100)
     temp_arc = 100;
   if (temp_arc < 0)
     temp_arc = 0;
-  lv_arc_set_value(ui->arc_temp, temp_arc);
+  set_arc_value(ui->arc_temp, &ui->cache.temp_arc, temp_arc);
 
   // Hum
-  snprintf(buf, sizeof(buf), "%.0f%%", data->humidity);
-  lv_label_set_text(ui->lbl_hum_val, buf);
-  lv_bar_set_value(ui->bar_hum, (int)data->humidity, LV_ANIM_ON);
+  ui_fmt_percent(buf, sizeof(buf), humidity);
+  set_label_text(ui->lbl_hum_val, &ui->cache.hum_val, buf);
+  set_bar_value(ui->bar_hum, &ui->cache.hum_bar, (int)humidity);
 
   // IAQ
-  snprintf(buf, sizeof(buf), "%.0f", data->iaq);
-  lv_label_set_text(ui->lbl_iaq_val, buf);
+  ui_fmt_count(buf, sizeof(buf), iaq);
+  set_label_text(ui->lbl_iaq_val, &ui->cache.iaq_val, buf);
 
   lv_color_t color = COLOR_GOOD;
   const char *status = "Excellent";
-  if (data->iaq > 50) {
+  if (iaq > 50) {
     color = COLOR_GOOD;
     status = "Good";
   }
-  if (data->iaq > 100) {
+  if (iaq > 100) {
     color = COLOR_WARN;
     status = "Average";
   }
-  if (data->iaq > 150) {
+  if (iaq > 150) {
     color = COLOR_BAD;
     status = "Poor";
   }
-  if (data->iaq > 200) {
+  if (iaq > 200) {
     color = COLOR_BAD;
     status = "Bad";
   }
 
-  lv_obj_set_style_text_color(ui->lbl_iaq_val, color, 0);
-  lv_label_set_text(ui->lbl_iaq_text, status);
-  lv_obj_set_style_text_color(ui->lbl_iaq_text, color, 0);
+  set_text_color(ui->lbl_iaq_val, &ui->cache.iaq_val, color);
+  set_label_text(ui->lbl_iaq_text, &ui->cache.iaq_text, status);
+  set_text_color(ui->lbl_iaq_text, &ui->cache.iaq_text, color);
 
   // CO2
-  snprintf(buf, sizeof(buf), "%.0f", data->co2);
-  lv_label_set_text(ui->lbl_co2_val, buf);
+  ui_fmt_count(buf, sizeof(buf), co2->value);
+  set_label_text(ui->lbl_co2_val, &ui->cache.co2_val, buf);
 
   // Press
-  snprintf(buf, sizeof(buf), "%.0f hPa", data->pressure / 100.0f);
-  lv_label_set_text(ui->lbl_press_val, buf);
+  ui_fmt_pressure(buf, sizeof(buf), samples[SAMPLE_CH_PRESSURE].value);
+  set_label_text(ui->lbl_press_val, &ui->cache.press_val, buf);
+}
+
+void ui_sampling_mode_update(ui_state_t *ui, bme680_mode_t mode) {
+  if (ui && ui->lbl_mode && mode < BME680_MODE_COUNT)
+    set_label_text(ui->lbl_mode, &ui->cache.mode, mode_text[mode]);
 }
 
 void ui_clock_update(ui_state_t *ui, const char *time_str) {
   if (ui && ui->lbl_time) {
-    lv_label_set_text(ui->lbl_time, time_str);
+    set_label_text(ui->lbl_time, &ui->cache.time, time_str);
   }
 }
 
 void ui_date_update(ui_state_t *ui, const char *date_str) {
   if (ui && ui->lbl_date) {
-    lv_label_set_text(ui->lbl_date, date_str);
+    set_label_text(ui->lbl_date, &ui->cache.date, date_str);
   }
 }
 
@@ -326,6 +467,13 @@ void ui_battery_update(ui_state_t *ui, int level_percent, bool is_charging) {
     }
   }
 
-  lv_label_set_text_fmt(ui->lbl_bat, "%s %d%%", symbol, level_percent);
-  lv_obj_set_style_text_color(ui->lbl_bat, color, 0);
+  char buf[UI_CACHE_TEXT_LEN];
+  ui_fmt_battery(buf, sizeof(buf), symbol, level_percent);
+  set_label_text(ui->lbl_bat, &ui->cache.bat, buf);
+  set_text_color(ui->lbl_bat, &ui->cache.bat, color);
+}
+
+void ui_get_update_stats(ui_update_stats_t *out) {
+  if (out)
+    *out = update_stats;
 }
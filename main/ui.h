@@ -3,8 +3,27 @@
 
 #include "lvgl.h"
 
+#include "sample_bus.h"
 #include "sensors_bme680.h"
 
+#define UI_CACHE_TEXT_LEN 24
+
+// Last value pushed to a widget. Setters compare against it and skip the
+// LVGL call (and the invalidation + SPI flush it causes) when unchanged.
+typedef struct {
+    char text[UI_CACHE_TEXT_LEN];
+    int32_t value;
+    lv_color_t color;
+    bool has_text;
+    bool has_value;
+    bool has_color;
+} ui_widget_cache_t;
+
+typedef struct {
+    uint32_t applied;
+    uint32_t skipped;
+} ui_update_stats_t;
+
 typedef struct {
     lv_obj_t *screen;
 
@@ -27,13 +46,43 @@ typedef struct {
     lv_obj_t *lbl_iaq_text;
     lv_obj_t *lbl_co2_val;
     lv_obj_t *lbl_press_val;
+    lv_obj_t *lbl_mode; // tap the card to change
+
+    struct {
+        ui_widget_cache_t time;
+        ui_widget_cache_t date;
+        ui_widget_cache_t bat;
+        ui_widget_cache_t temp_val;
+        ui_widget_cache_t temp_arc;
+        ui_widget_cache_t hum_val;
+        ui_widget_cache_t hum_bar;
+        ui_widget_cache_t iaq_val;
+        ui_widget_cache_t iaq_text;
+        ui_widget_cache_t co2_val;
+        ui_widget_cache_t press_val;
+        ui_widget_cache_t mode;
+    } cache;
 
 } ui_state_t;
 
+// Screens in swipe order (see ui_screens.h)
+typedef enum {
+    UI_SCREEN_DASHBOARD,
+    UI_SCREEN_HISTORY,
+    UI_SCREEN_DIAG, // hidden: long-press the kitty
+    UI_SCREEN_COUNT,
+} ui_screen_id_t;
+
+// Registers the screens and shows the dashboard, which is built at once and
+// stays resident; the others are built on first use
 ui_state_t ui_setup(lv_display_t *display);
-void ui_sensors_update(ui_state_t *ui, const bme680_state_t *data);
+// `samples` is indexed by sample_channel_t. CO2 shows the NDIR reading once
+// one has been published, the BSEC estimate until then.
+void ui_sensors_update(ui_state_t *ui, const sample_t *samples);
+void ui_sampling_mode_update(ui_state_t *ui, bme680_mode_t mode);
 void ui_clock_update(ui_state_t *ui, const char *time_str);
 void ui_date_update(ui_state_t *ui, const char *date_str);
 void ui_battery_update(ui_state_t *ui, int level_percent, bool is_charging);
+void ui_get_update_stats(ui_update_stats_t *out);
 
 #endif
@@ -0,0 +1,121 @@
+#include "ui_diag.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "diagnostics.h"
+#include "ui_screens.h"
+
+// Subset kept to printable ASCII for this screen (see main/CMakeLists.txt)
+LV_FONT_DECLARE(ui_font_montserrat_12);
+
+#define DIAG_REFRESH_MS 1000
+#define DIAG_TEXT_LEN 1024
+
+typedef struct {
+  lv_obj_t *screen; // the one built last
+  lv_obj_t *label;
+  lv_timer_t *timer;
+} ui_diag_t;
+
+static ui_diag_t diag;
+
+static int append(char *buf, int len, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static int append(char *buf, int len, const char *fmt, ...) {
+  if (len >= DIAG_TEXT_LEN)
+    return len;
+
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + len, DIAG_TEXT_LEN - len, fmt, args);
+  va_end(args);
+
+  return n < 0 ? len : len + n;
+}
+
+static void refresh(lv_timer_t *timer) {
+  static diag_snapshot_t s;
+  static char text[DIAG_TEXT_LEN];
+  ui_screen_stats_t screens[UI_SCREENS_MAX];
+  (void)timer;
+
+  if (!diagnostics_get(&s)) {
+    lv_label_set_text(diag.label, "Waiting for first sample...");
+    return;
+  }
+
+  int len = 0;
+  len = append(text, len, "Up %lus  heap %lu free / %lu min\n",
+               (unsigned long)s.uptime_s, (unsigned long)s.heap.free,
+               (unsigned long)s.heap.min_free);
+  len = append(text, len, "Largest block %lu (min %lu), frag %u%%\n",
+               (unsigned long)s.heap.largest,
+               (unsigned long)s.heap.min_largest, s.heap.frag_pct);
+  len = append(text, len, "LVGL %lu / %lu used, largest %lu, frag %u%%\n\n",
+               (unsigned long)s.lvgl_used, (unsigned long)s.lvgl_total,
+               (unsigned long)s.lvgl_largest, s.lvgl_frag_pct);
+  len = append(text, len, "Task             CPU   Stack free\n");
+  for (size_t i = 0; i < s.task_count; i++) {
+    const diag_task_t *t = &s.tasks[i];
+    len = append(text, len, "%-16s %3u%%   %lu\n", t->name, t->cpu_pct,
+                 (unsigned long)t->stack_free);
+  }
+
+  const size_t n = ui_screens_get_stats(screens, UI_SCREENS_MAX);
+  len = append(text, len, "\nScreen       Build us   Heap  Builds\n");
+  for (size_t i = 0; i < n; i++)
+    len = append(text, len, "%-12s %8ld %6lu %7lu%s\n", screens[i].name,
+                 (long)screens[i].build_us,
+                 (unsigned long)screens[i].heap_bytes,
+                 (unsigned long)screens[i].builds,
+                 screens[i].built ? "" : " (freed)");
+
+  lv_label_set_text(diag.label, text);
+}
+
+static void on_loaded(lv_event_t *e) {
+  (void)e;
+  refresh(diag.timer);
+  lv_timer_resume(diag.timer);
+}
+
+static void on_unloaded(lv_event_t *e) {
+  (void)e;
+  lv_timer_pause(diag.timer);
+}
+
+// Each screen deletes its own timer. An evicted screen is deleted later,
+// maybe after it was built again and `diag` already belongs to the new one.
+static void on_delete(lv_event_t *e) {
+  lv_timer_delete(lv_event_get_user_data(e));
+  if (lv_event_get_target(e) == diag.screen)
+    diag = (ui_diag_t){0};
+}
+
+static void on_close(lv_event_t *e) {
+  (void)e;
+  ui_screens_back();
+}
+
+void ui_diag_build(lv_obj_t *screen, void *ctx) {
+  (void)ctx;
+
+  diag.screen = screen;
+  lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), 0);
+  lv_obj_set_style_pad_all(screen, 4, 0);
+  lv_obj_add_event_cb(screen, on_close, LV_EVENT_CLICKED, NULL);
+  lv_obj_add_event_cb(screen, on_loaded, LV_EVENT_SCREEN_LOADED, NULL);
+  lv_obj_add_event_cb(screen, on_unloaded, LV_EVENT_SCREEN_UNLOADED, NULL);
+
+  diag.label = lv_label_create(screen);
+  lv_obj_set_width(diag.label, LV_PCT(100));
+  lv_obj_set_style_text_font(diag.label, &ui_font_montserrat_12, 0);
+  lv_obj_set_style_text_color(diag.label, lv_color_hex(0xA0A0A0), 0);
+
+  // Started by LV_EVENT_SCREEN_LOADED
+  diag.timer = lv_timer_create(refresh, DIAG_REFRESH_MS, NULL);
+  lv_timer_pause(diag.timer);
+  lv_obj_add_event_cb(screen, on_delete, LV_EVENT_DELETE, diag.timer);
+}
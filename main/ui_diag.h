@@ -0,0 +1,11 @@
+#ifndef UI_DIAG_H
+#define UI_DIAG_H
+
+#include "lvgl.h"
+
+// Hidden diagnostics screen showing the latest diagnostics sample and the
+// cost of each UI screen, refreshed every second while visible. A tap
+// anywhere returns to the previous screen. A ui_screens build callback.
+void ui_diag_build(lv_obj_t *screen, void *ctx);
+
+#endif
@@ -0,0 +1,214 @@
+#include "ui_fmt.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+  char *buf;
+  size_t size;
+  size_t len;
+  bool full;
+} out_t;
+
+static const char *const week_days[] = {"Sun", "Mon", "Tue", "Wed",
+                                         "Thu", "Fri", "Sat"};
+
+static const char *const months[] = {"Jan", "Feb", "Mar", "Apr",
+                                     "May", "Jun", "Jul", "Aug",
+                                     "Sep", "Oct", "Nov", "Dec"};
+
+static void put_char(out_t *out, char c) {
+  if (out->len + 1 >= out->size) {
+    out->full = true;
+    return;
+  }
+  out->buf[out->len++] = c;
+}
+
+static void put_str(out_t *out, const char *s) {
+  while (*s)
+    put_char(out, *s++);
+}
+
+static void put_uint(out_t *out, uint32_t v, int min_digits) {
+  char digits[10];
+  int n = 0;
+
+  do {
+    digits[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v > 0);
+  while (n < min_digits && n < (int)sizeof(digits))
+    digits[n++] = '0';
+  while (n > 0)
+    put_char(out, digits[--n]);
+}
+
+static void put_int(out_t *out, int v, int min_digits) {
+  if (v < 0) {
+    put_char(out, '-');
+    put_uint(out, -(uint32_t)v, min_digits - 1); // the sign takes a digit
+  } else {
+    put_uint(out, (uint32_t)v, min_digits);
+  }
+}
+
+// IEEE 754 single precision: the value is mantissa * 2^exp2
+typedef struct {
+  uint32_t mantissa;
+  int exp2;
+  bool negative;
+  bool inf;
+  bool nan;
+} float_parts_t;
+
+static float_parts_t split_float(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  const int biased = (int)((bits >> 23) & 0xff);
+  const uint32_t frac = bits & 0x7fffff;
+  float_parts_t p = {.negative = bits >> 31};
+
+  if (biased == 0xff) {
+    p.nan = frac != 0;
+    p.inf = frac == 0;
+  } else if (biased == 0) {
+    p.mantissa = frac; // subnormal
+    p.exp2 = -149;
+  } else {
+    p.mantissa = frac | 0x800000;
+    p.exp2 = biased - 150;
+  }
+  return p;
+}
+
+// mantissa * 2^exp2 * mul / div, rounded half to even, saturating at
+// UINT32_MAX. mantissa * mul stays below 2^28, so every step is exact in
+// 64 bits and ties are real ties.
+static uint32_t round_scaled(const float_parts_t *p, uint32_t mul,
+                             uint32_t div) {
+  uint64_t n = (uint64_t)p->mantissa * mul;
+  uint64_t d = div;
+
+  if (n == 0)
+    return 0;
+  if (p->exp2 >= 0) {
+    if (p->exp2 > 32)
+      return UINT32_MAX;
+    n <<= p->exp2;
+  } else {
+    // Below 2^-40 the quotient is under a half
+    if (p->exp2 < -40)
+      return 0;
+    d <<= -p->exp2;
+  }
+
+  uint64_t i = n / d;
+  const uint64_t rem2 = 2 * (n - i * d);
+  if (rem2 > d || (rem2 == d && (i & 1)))
+    i++;
+  return i > UINT32_MAX ? UINT32_MAX : (uint32_t)i;
+}
+
+// printf's "%.<decimals>f" of value / div, for decimals 0 or 1
+static void put_fixed(out_t *out, float value, int decimals, uint32_t div) {
+  const float_parts_t p = split_float(value);
+
+  if (p.nan) {
+    put_str(out, "nan");
+    return;
+  }
+
+  // Sign first, as printf does even when the value rounds to zero
+  if (p.negative)
+    put_char(out, '-');
+
+  if (p.inf) {
+    put_str(out, "inf");
+  } else if (decimals == 0) {
+    put_uint(out, round_scaled(&p, 1, div), 1);
+  } else {
+    const uint32_t tenths = round_scaled(&p, 10, div);
+    put_uint(out, tenths / 10, 1);
+    put_char(out, '.');
+    put_char(out, (char)('0' + tenths % 10));
+  }
+}
+
+static size_t finish(out_t *out) {
+  if (out->size == 0)
+    return 0;
+  if (out->full)
+    out->len = 0;
+  out->buf[out->len] = '\0';
+  return out->len;
+}
+
+size_t ui_fmt_temp(char *buf, size_t size, float celsius) {
+  out_t out = {.buf = buf, .size = size};
+
+  put_fixed(&out, celsius, 1, 1);
+  put_str(&out, "°");
+  return finish(&out);
+}
+
+size_t ui_fmt_percent(char *buf, size_t size, float percent) {
+  out_t out = {.buf = buf, .size = size};
+
+  put_fixed(&out, percent, 0, 1);
+  put_char(&out, '%');
+  return finish(&out);
+}
+
+size_t ui_fmt_count(char *buf, size_t size, float value) {
+  out_t out = {.buf = buf, .size = size};
+
+  put_fixed(&out, value, 0, 1);
+  return finish(&out);
+}
+
+size_t ui_fmt_pressure(char *buf, size_t size, float pa) {
+  out_t out = {.buf = buf, .size = size};
+
+  put_fixed(&out, pa, 0, 100);
+  put_str(&out, " hPa");
+  return finish(&out);
+}
+
+size_t ui_fmt_time(char *buf, size_t size, int hour, int min) {
+  out_t out = {.buf = buf, .size = size};
+
+  put_int(&out, hour, 2);
+  put_char(&out, ':');
+  put_int(&out, min, 2);
+  return finish(&out);
+}
+
+size_t ui_fmt_date(char *buf, size_t size, int wday, int mday, int mon) {
+  out_t out = {.buf = buf, .size = size};
+
+  if (wday < 0 || wday > 6 || mon < 0 || mon > 11) {
+    out.full = true;
+    return finish(&out);
+  }
+
+  put_str(&out, week_days[wday]);
+  put_str(&out, ", ");
+  put_int(&out, mday, 2);
+  put_char(&out, ' ');
+  put_str(&out, months[mon]);
+  return finish(&out);
+}
+
+size_t ui_fmt_battery(char *buf, size_t size, const char *symbol,
+                      int percent) {
+  out_t out = {.buf = buf, .size = size};
+
+  put_str(&out, symbol);
+  put_char(&out, ' ');
+  put_int(&out, percent, 1);
+  put_char(&out, '%');
+  return finish(&out);
+}
@@ -0,0 +1,28 @@
+#ifndef UI_FMT_H
+#define UI_FMT_H
+
+#include <stddef.h>
+
+// Text for the dashboard labels, formatted with integer arithmetic into the
+// caller's buffer. Nothing is allocated and newlib's printf (with its float
+// support and stack appetite) stays out of the UI path. Sensor values are
+// split into their IEEE 754 mantissa and exponent and scaled in 64-bit
+// integers, so the FPU-less ESP32-S2 makes no soft-float calls. They are
+// rounded once, half to even like printf, so the text matches the "%.1f" /
+// "%.0f" / "%02d" formats it replaces character for character.
+//
+// Every function returns the length of the text, or 0 and an empty string
+// when it does not fit in `size` bytes.
+
+size_t ui_fmt_temp(char *buf, size_t size, float celsius);    // "23.4°"
+size_t ui_fmt_percent(char *buf, size_t size, float percent); // "45%"
+size_t ui_fmt_count(char *buf, size_t size, float value);     // IAQ, CO2: "412"
+size_t ui_fmt_pressure(char *buf, size_t size, float pa);     // "1013 hPa"
+
+size_t ui_fmt_time(char *buf, size_t size, int hour, int min); // "07:05"
+// Fields as in struct tm: "Mon, 05 Jan"
+size_t ui_fmt_date(char *buf, size_t size, int wday, int mday, int mon);
+size_t ui_fmt_battery(char *buf, size_t size, const char *symbol,
+                      int percent); // "<symbol> 80%"
+
+#endif
@@ -0,0 +1,121 @@
+#include "ui_history.h"
+
+#include <stdlib.h>
+
+#include "history.h"
+
+LV_FONT_DECLARE(ui_font_montserrat_12);
+
+// 8 hours of 5 min buckets
+#define HISTORY_POINTS 96
+#define HISTORY_REFRESH_MS (60 * 1000)
+
+typedef struct {
+  lv_obj_t *screen; // the one built last
+  lv_obj_t *chart;
+  lv_chart_series_t *temp;
+  lv_chart_series_t *hum;
+  lv_timer_t *timer;
+} ui_history_t;
+
+static ui_history_t hist;
+
+static void refresh(lv_timer_t *timer) {
+  (void)timer;
+
+  // Only needed while redrawing; the chart keeps its own copy of the points
+  history_agg_t *agg = malloc(HISTORY_POINTS * sizeof(*agg));
+  if (agg == NULL)
+    return;
+
+  size_t n = history_read_agg(HISTORY_TIER_5MIN, agg, HISTORY_POINTS);
+
+  // Newest bucket on the right, gaps before the first one
+  for (size_t i = 0; i < HISTORY_POINTS; i++) {
+    int32_t temp = LV_CHART_POINT_NONE;
+    int32_t hum = LV_CHART_POINT_NONE;
+
+    if (i >= HISTORY_POINTS - n) {
+      const history_agg_t *a = &agg[i - (HISTORY_POINTS - n)];
+      temp = a->avg[HISTORY_CH_TEMP];
+      hum = a->avg[HISTORY_CH_HUMIDITY];
+    }
+    lv_chart_set_value_by_id(hist.chart, hist.temp, i, temp);
+    lv_chart_set_value_by_id(hist.chart, hist.hum, i, hum);
+  }
+  free(agg);
+
+  lv_chart_refresh(hist.chart);
+}
+
+static void on_loaded(lv_event_t *e) {
+  (void)e;
+  refresh(hist.timer);
+  lv_timer_resume(hist.timer);
+}
+
+static void on_unloaded(lv_event_t *e) {
+  (void)e;
+  lv_timer_pause(hist.timer);
+}
+
+// Each screen deletes its own timer. An evicted screen is deleted later,
+// maybe after it was built again and `hist` already belongs to the new one.
+static void on_delete(lv_event_t *e) {
+  lv_timer_delete(lv_event_get_user_data(e));
+  if (lv_event_get_target(e) == hist.screen)
+    hist = (ui_history_t){0};
+}
+
+static lv_obj_t *add_label(lv_obj_t *parent, const char *text,
+                           lv_color_t color, lv_align_t align) {
+  lv_obj_t *lbl = lv_label_create(parent);
+  lv_label_set_text(lbl, text);
+  lv_obj_set_style_text_font(lbl, &ui_font_montserrat_12, 0);
+  lv_obj_set_style_text_color(lbl, color, 0);
+  lv_obj_align(lbl, align, 0, 0);
+  return lbl;
+}
+
+void ui_history_build(lv_obj_t *screen, void *ctx) {
+  (void)ctx;
+
+  hist.screen = screen;
+  lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), 0);
+  lv_obj_set_style_pad_all(screen, 4, 0);
+  lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(screen, on_loaded, LV_EVENT_SCREEN_LOADED, NULL);
+  lv_obj_add_event_cb(screen, on_unloaded, LV_EVENT_SCREEN_UNLOADED, NULL);
+
+  add_label(screen, "Last 8 h", lv_color_hex(0xA0A0A0), LV_ALIGN_TOP_LEFT);
+  lv_obj_t *hum = add_label(screen, "Hum %", lv_palette_main(LV_PALETTE_BLUE),
+                            LV_ALIGN_TOP_RIGHT);
+  lv_obj_t *temp = add_label(screen, "Temp °C",
+                             lv_palette_main(LV_PALETTE_ORANGE),
+                             LV_ALIGN_TOP_RIGHT);
+  lv_obj_align_to(temp, hum, LV_ALIGN_OUT_LEFT_MID, -12, 0);
+
+  hist.chart = lv_chart_create(screen);
+  lv_obj_set_size(hist.chart, 312, 208);
+  lv_obj_align(hist.chart, LV_ALIGN_BOTTOM_MID, 0, 0);
+  lv_obj_set_style_bg_color(hist.chart, lv_color_hex(0x181818), 0);
+  lv_obj_set_style_border_width(hist.chart, 0, 0);
+  lv_obj_set_style_line_width(hist.chart, 2, LV_PART_ITEMS);
+  lv_obj_set_style_size(hist.chart, 0, 0, LV_PART_INDICATOR);
+  lv_chart_set_type(hist.chart, LV_CHART_TYPE_LINE);
+  lv_chart_set_div_line_count(hist.chart, 5, 8);
+  lv_chart_set_point_count(hist.chart, HISTORY_POINTS);
+
+  // Stored history units: 0.01 °C and 0.01 %RH
+  lv_chart_set_range(hist.chart, LV_CHART_AXIS_PRIMARY_Y, 0, 4000);
+  lv_chart_set_range(hist.chart, LV_CHART_AXIS_SECONDARY_Y, 0, 10000);
+  hist.temp = lv_chart_add_series(
+      hist.chart, lv_palette_main(LV_PALETTE_ORANGE), LV_CHART_AXIS_PRIMARY_Y);
+  hist.hum = lv_chart_add_series(hist.chart, lv_palette_main(LV_PALETTE_BLUE),
+                                 LV_CHART_AXIS_SECONDARY_Y);
+
+  // Started by LV_EVENT_SCREEN_LOADED
+  hist.timer = lv_timer_create(refresh, HISTORY_REFRESH_MS, NULL);
+  lv_timer_pause(hist.timer);
+  lv_obj_add_event_cb(screen, on_delete, LV_EVENT_DELETE, hist.timer);
+}
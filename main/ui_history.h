@@ -0,0 +1,11 @@
+#ifndef UI_HISTORY_H
+#define UI_HISTORY_H
+
+#include "lvgl.h"
+
+// History screen: temperature and humidity over the last 8 hours as 5 min
+// averages from the sensor history. Redrawn when shown and every minute
+// while visible. A ui_screens build callback.
+void ui_history_build(lv_obj_t *screen, void *ctx);
+
+#endif
@@ -0,0 +1,185 @@
+#include "ui_screens.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+static const char *TAG = "SCREENS";
+
+typedef struct {
+  ui_screen_def_t def;
+  ui_screen_stats_t stats;
+  lv_obj_t *screen;
+  uint32_t last_shown; // show counter value, for LRU eviction
+  bool registered;
+} screen_slot_t;
+
+static screen_slot_t slots[UI_SCREENS_MAX];
+static size_t budget;
+static int current = -1;
+static int previous = -1;
+static uint32_t show_count;
+
+static size_t lvgl_heap_used(void) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+static bool valid(int id) {
+  return id >= 0 && id < UI_SCREENS_MAX && slots[id].registered;
+}
+
+static void on_delete(lv_event_t *e) {
+  screen_slot_t *slot = lv_event_get_user_data(e);
+
+  // An evicted screen is deleted later, maybe after the slot was rebuilt
+  if (lv_event_get_target(e) != slot->screen)
+    return;
+  slot->screen = NULL;
+  slot->stats.built = false;
+}
+
+// Next screen in `step` direction that swipes can reach, or -1
+static int neighbour(int id, int step) {
+  for (int i = id + step; i >= 0 && i < UI_SCREENS_MAX; i += step)
+    if (slots[i].registered && !slots[i].def.hidden)
+      return i;
+  return -1;
+}
+
+static void on_gesture(lv_event_t *e) {
+  lv_indev_t *indev = lv_indev_active();
+  if (indev == NULL || current < 0 || slots[current].def.hidden)
+    return;
+
+  int next = -1;
+  switch (lv_indev_get_gesture_dir(indev)) {
+  case LV_DIR_LEFT:
+    next = neighbour(current, 1);
+    break;
+  case LV_DIR_RIGHT:
+    next = neighbour(current, -1);
+    break;
+  default:
+    break;
+  }
+
+  if (next >= 0)
+    ui_screens_show(next);
+}
+
+static bool build(int id) {
+  screen_slot_t *slot = &slots[id];
+  const size_t heap_before = lvgl_heap_used();
+  const int64_t start = esp_timer_get_time();
+
+  slot->screen = lv_obj_create(NULL);
+  if (slot->screen == NULL) {
+    ESP_LOGE(TAG, "No memory for the %s screen", slot->def.name);
+    return false;
+  }
+  lv_obj_add_event_cb(slot->screen, on_delete, LV_EVENT_DELETE, slot);
+  lv_obj_add_event_cb(slot->screen, on_gesture, LV_EVENT_GESTURE, NULL);
+  slot->def.build(slot->screen, slot->def.ctx);
+
+  const size_t heap_after = lvgl_heap_used();
+  slot->stats.build_us = esp_timer_get_time() - start;
+  slot->stats.heap_bytes =
+      heap_after > heap_before ? heap_after - heap_before : 0;
+  slot->stats.builds++;
+  slot->stats.built = true;
+
+  ESP_LOGI(TAG, "%s built in %lld us, %u bytes of LVGL heap", slot->def.name,
+           (long long)slot->stats.build_us, (unsigned)slot->stats.heap_bytes);
+  return true;
+}
+
+// Deletes idle screens, least recently shown first, until within budget
+static void evict(void) {
+  while (ui_screens_heap_bytes() > budget) {
+    screen_slot_t *lru = NULL;
+
+    for (int i = 0; i < UI_SCREENS_MAX; i++) {
+      screen_slot_t *slot = &slots[i];
+      if (slot->screen == NULL || slot->def.resident || i == current)
+        continue;
+      if (lru == NULL || slot->last_shown < lru->last_shown)
+        lru = slot;
+    }
+    if (lru == NULL)
+      return;
+
+    ESP_LOGD(TAG, "Evicting %s (%u bytes)", lru->def.name,
+             (unsigned)lru->stats.heap_bytes);
+    lru->stats.evictions++;
+    lru->stats.built = false;
+    // May be the target of the event that switched screens
+    lv_obj_delete_async(lru->screen);
+    lru->screen = NULL;
+  }
+}
+
+void ui_screens_init(size_t budget_bytes) {
+  memset(slots, 0, sizeof(slots));
+  budget = budget_bytes;
+  current = -1;
+  previous = -1;
+}
+
+bool ui_screens_add(int id, const ui_screen_def_t *def) {
+  if (id < 0 || id >= UI_SCREENS_MAX || def == NULL || def->build == NULL)
+    return false;
+
+  slots[id] = (screen_slot_t){
+      .def = *def,
+      .stats = {.name = def->name},
+      .registered = true,
+  };
+  return true;
+}
+
+bool ui_screens_show(int id) {
+  if (!valid(id))
+    return false;
+  if (id == current)
+    return true;
+
+  screen_slot_t *slot = &slots[id];
+  if (slot->screen == NULL && !build(id))
+    return false;
+
+  lv_screen_load(slot->screen);
+  slot->last_shown = ++show_count;
+  previous = current;
+  current = id;
+
+  evict();
+  return true;
+}
+
+void ui_screens_back(void) {
+  if (valid(previous))
+    ui_screens_show(previous);
+}
+
+lv_obj_t *ui_screens_get(int id) { return valid(id) ? slots[id].screen : NULL; }
+
+size_t ui_screens_heap_bytes(void) {
+  size_t total = 0;
+
+  // Resident screens (the dashboard) are outside the budget
+  for (int i = 0; i < UI_SCREENS_MAX; i++)
+    if (slots[i].screen && !slots[i].def.resident)
+      total += slots[i].stats.heap_bytes;
+  return total;
+}
+
+size_t ui_screens_get_stats(ui_screen_stats_t *out, size_t max) {
+  size_t n = 0;
+
+  for (int i = 0; i < UI_SCREENS_MAX && n < max; i++)
+    if (slots[i].registered)
+      out[n++] = slots[i].stats;
+  return n;
+}
@@ -0,0 +1,63 @@
+#ifndef UI_SCREENS_H
+#define UI_SCREENS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lvgl.h"
+
+// Screen manager. Screens are registered up front but only built, on a
+// fresh LVGL screen object, the first time they are shown. After every
+// switch, screens that are neither visible nor resident are deleted, least
+// recently shown first, while the LVGL heap taken by the built screens that
+// are not resident is over the budget; showing one again rebuilds it. Build
+// time and heap are measured per screen.
+//
+// A swipe left/right moves to the next/previous screen in id order,
+// skipping hidden ones. All functions need the LVGL lock.
+
+#define UI_SCREENS_MAX 6
+
+// Creates the widgets on `screen`. Per-screen state must be released from
+// an LV_EVENT_DELETE handler on `screen`.
+typedef void (*ui_screen_build_t)(lv_obj_t *screen, void *ctx);
+
+typedef struct {
+  const char *name;
+  ui_screen_build_t build;
+  void *ctx;
+  bool resident; // never deleted once built
+  bool hidden;   // not reachable by swiping
+} ui_screen_def_t;
+
+typedef struct {
+  const char *name;
+  uint32_t builds;
+  uint32_t evictions;
+  int64_t build_us;  // last build
+  size_t heap_bytes; // LVGL heap taken by the last build
+  bool built;
+} ui_screen_stats_t;
+
+// Forgets all registered screens; ones already built are left alone
+void ui_screens_init(size_t budget_bytes);
+
+bool ui_screens_add(int id, const ui_screen_def_t *def);
+
+// Builds the screen if needed and loads it
+bool ui_screens_show(int id);
+
+// Returns to the screen shown before the current one
+void ui_screens_back(void);
+
+// The screen object if it is built, otherwise NULL
+lv_obj_t *ui_screens_get(int id);
+
+// Heap of the built screens the budget applies to, i.e. not resident ones
+size_t ui_screens_heap_bytes(void);
+
+// Copies the stats of up to `max` registered screens, returns the count
+size_t ui_screens_get_stats(ui_screen_stats_t *out, size_t max);
+
+#endif
@@ -0,0 +1,209 @@
+// Host benchmark of main/ui_fmt.c against the snprintf calls it replaced.
+//
+//   ./build-sim/esp32_clock_fmt_bench
+//
+// Every field is formatted for a set of plausible readings (plus rounding
+// ties and signed zeros) by both implementations; any difference in the text
+// is reported and fails the run. Then each implementation formats the set
+// repeatedly and the best of several passes is printed per call, in TSC
+// cycles on x86 and nanoseconds elsewhere. Host numbers only show the ratio:
+// on the ESP32-S2, which has no FPU, the float printf path costs much more.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TICK_UNIT "cycles"
+static inline uint64_t ticks(void) { return __rdtsc(); }
+#else
+#define TICK_UNIT "ns"
+static inline uint64_t ticks(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#include "ui_fmt.h"
+
+#define SAMPLES 1024
+#define PASSES 50
+#define RUNS 5
+
+static float temp[SAMPLES], hum[SAMPLES], iaq[SAMPLES], co2[SAMPLES],
+    press[SAMPLES];
+static struct tm tms[SAMPLES];
+static int bat[SAMPLES];
+
+static const char *const week_days[] = {"Sun", "Mon", "Tue", "Wed",
+                                        "Thu", "Fri", "Sat"};
+static const char *const months[] = {"Jan", "Feb", "Mar", "Apr",
+                                     "May", "Jun", "Jul", "Aug",
+                                     "Sep", "Oct", "Nov", "Dec"};
+// LV_SYMBOL_BATTERY_2, as UTF-8
+static const char *const bat_symbol = "\xEF\x89\x82";
+
+static uint32_t rng = 12345;
+
+static float uniform(float lo, float hi) {
+  rng = rng * 1664525u + 1013904223u;
+  return lo + (hi - lo) * (float)(rng >> 8) / (float)(1u << 24);
+}
+
+static void fill_inputs(void) {
+  // Exact ties, signed zeros and infinities, where differences would show
+  static const float edges[] = {0.0f,   -0.0f,  0.5f,   1.5f,
+                                2.5f,   23.25f, 23.75f, -0.04f,
+                                -0.05f, 99.5f,  INFINITY, -INFINITY};
+  const size_t n_edges = sizeof(edges) / sizeof(edges[0]);
+
+  for (int i = 0; i < SAMPLES; i++) {
+    temp[i] = uniform(-10.0f, 45.0f);
+    hum[i] = uniform(0.0f, 100.0f);
+    iaq[i] = uniform(0.0f, 500.0f);
+    co2[i] = uniform(400.0f, 5000.0f);
+    press[i] = uniform(90000.0f, 105000.0f);
+    tms[i] = (struct tm){.tm_hour = i % 24,
+                         .tm_min = (i * 7) % 60,
+                         .tm_mday = 1 + i % 31,
+                         .tm_mon = i % 12,
+                         .tm_wday = i % 7};
+    bat[i] = i % 101;
+  }
+
+  for (size_t i = 0; i < n_edges; i++) {
+    temp[i] = hum[i] = iaq[i] = co2[i] = edges[i];
+    press[i] = edges[i] * 100.0f;
+  }
+}
+
+typedef size_t (*format_fn_t)(char *buf, size_t size, int i);
+
+static size_t ref_temp(char *b, size_t n, int i) {
+  return snprintf(b, n, "%.1f°", temp[i]);
+}
+static size_t new_temp(char *b, size_t n, int i) {
+  return ui_fmt_temp(b, n, temp[i]);
+}
+static size_t ref_hum(char *b, size_t n, int i) {
+  return snprintf(b, n, "%.0f%%", hum[i]);
+}
+static size_t new_hum(char *b, size_t n, int i) {
+  return ui_fmt_percent(b, n, hum[i]);
+}
+static size_t ref_iaq(char *b, size_t n, int i) {
+  return snprintf(b, n, "%.0f", iaq[i]);
+}
+static size_t new_iaq(char *b, size_t n, int i) {
+  return ui_fmt_count(b, n, iaq[i]);
+}
+static size_t ref_co2(char *b, size_t n, int i) {
+  return snprintf(b, n, "%.0f", co2[i]);
+}
+static size_t new_co2(char *b, size_t n, int i) {
+  return ui_fmt_count(b, n, co2[i]);
+}
+static size_t ref_press(char *b, size_t n, int i) {
+  return snprintf(b, n, "%.0f hPa", press[i] / 100.0f);
+}
+static size_t new_press(char *b, size_t n, int i) {
+  return ui_fmt_pressure(b, n, press[i]);
+}
+static size_t ref_time(char *b, size_t n, int i) {
+  return snprintf(b, n, "%02d:%02d", tms[i].tm_hour, tms[i].tm_min);
+}
+static size_t new_time(char *b, size_t n, int i) {
+  return ui_fmt_time(b, n, tms[i].tm_hour, tms[i].tm_min);
+}
+static size_t ref_date(char *b, size_t n, int i) {
+  return snprintf(b, n, "%s, %02d %s", week_days[tms[i].tm_wday],
+                  tms[i].tm_mday, months[tms[i].tm_mon]);
+}
+static size_t new_date(char *b, size_t n, int i) {
+  return ui_fmt_date(b, n, tms[i].tm_wday, tms[i].tm_mday, tms[i].tm_mon);
+}
+static size_t ref_bat(char *b, size_t n, int i) {
+  return snprintf(b, n, "%s %d%%", bat_symbol, bat[i]);
+}
+static size_t new_bat(char *b, size_t n, int i) {
+  return ui_fmt_battery(b, n, bat_symbol, bat[i]);
+}
+
+static const struct {
+  const char *name;
+  format_fn_t ref;
+  format_fn_t fmt;
+} fields[] = {
+    {"temperature", ref_temp, new_temp}, {"humidity", ref_hum, new_hum},
+    {"iaq", ref_iaq, new_iaq},           {"co2", ref_co2, new_co2},
+    {"pressure", ref_press, new_press},  {"time", ref_time, new_time},
+    {"date", ref_date, new_date},        {"battery", ref_bat, new_bat},
+};
+
+static volatile size_t sink;
+
+// Best per-call time over RUNS runs of PASSES passes over the inputs
+static double time_per_call(format_fn_t fn) {
+  char buf[32];
+  uint64_t best = UINT64_MAX;
+
+  for (int run = 0; run < RUNS; run++) {
+    size_t acc = 0;
+    const uint64_t start = ticks();
+    for (int pass = 0; pass < PASSES; pass++)
+      for (int i = 0; i < SAMPLES; i++)
+        acc += fn(buf, sizeof(buf), i) + (unsigned char)buf[0];
+    const uint64_t elapsed = ticks() - start;
+    sink = acc;
+    if (elapsed < best)
+      best = elapsed;
+  }
+  return (double)best / (PASSES * SAMPLES);
+}
+
+static int check(const char *name, format_fn_t ref, format_fn_t fmt) {
+  int mismatches = 0;
+
+  for (int i = 0; i < SAMPLES; i++) {
+    char want[32], got[32];
+    ref(want, sizeof(want), i);
+    fmt(got, sizeof(got), i);
+    if (strcmp(want, got) != 0 && mismatches++ < 5)
+      printf("%s: sample %d: snprintf \"%s\", ui_fmt \"%s\"\n", name, i, want,
+             got);
+  }
+  return mismatches;
+}
+
+int main(void) {
+  const size_t n_fields = sizeof(fields) / sizeof(fields[0]);
+  int mismatches = 0;
+
+  fill_inputs();
+
+  for (size_t f = 0; f < n_fields; f++)
+    mismatches += check(fields[f].name, fields[f].ref, fields[f].fmt);
+
+  printf("%-12s %12s %12s %8s\n", "field", "snprintf", "ui_fmt", "speedup");
+  double ref_total = 0, fmt_total = 0;
+  for (size_t f = 0; f < n_fields; f++) {
+    const double ref = time_per_call(fields[f].ref);
+    const double fmt = time_per_call(fields[f].fmt);
+    ref_total += ref;
+    fmt_total += fmt;
+    printf("%-12s %12.1f %12.1f %7.1fx\n", fields[f].name, ref, fmt,
+           ref / fmt);
+  }
+  printf("%-12s %12.1f %12.1f %7.1fx   (" TICK_UNIT " per call)\n", "all",
+         ref_total, fmt_total, ref_total / fmt_total);
+
+  if (mismatches > 0) {
+    printf("%d mismatches\n", mismatches);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,193 @@
+// Host test of main/history.c, through the sample bus like the firmware.
+//
+//   ./build-sim/esp32_clock_history_test
+//
+// Publishes scripted samples with chosen timestamps and checks what the
+// rings hold: min/avg/max and lowest accuracy folding, the 5 min to 1 h
+// cascade at the bucket boundaries, ring wraparound on read, and the int16
+// clamping of history_scale. Prints each failed check and fails the run.
+
+#include <stdio.h>
+
+#include "history.h"
+#include "sample_bus.h"
+
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      failures++;                                                              \
+      printf("%s:%d: ", __FILE__, __LINE__);                                   \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+static const sample_channel_t channels[] = {
+    SAMPLE_CH_IAQ,      SAMPLE_CH_TEMP, SAMPLE_CH_PRESSURE,
+    SAMPLE_CH_HUMIDITY, SAMPLE_CH_GAS,  SAMPLE_CH_CO2_EQ,
+};
+
+static history_raw_t raw[HISTORY_RAW_LEN + 8];
+static history_agg_t agg[HISTORY_5MIN_LEN + 8];
+
+// Every history channel gets `value`. The CO2 channel is stored 1:1, so the
+// checks below read it back from there.
+static void publish(uint32_t time_s, float value, uint8_t accuracy) {
+  for (size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); i++)
+    sample_bus_write(channels[i], value, accuracy, (int64_t)time_s * 1000000);
+  sample_bus_publish(HISTORY_SAMPLE_CHANNELS);
+}
+
+static size_t read_tier(history_tier_t tier) {
+  return history_read_agg(tier, agg, sizeof(agg) / sizeof(agg[0]));
+}
+
+static void check_agg(const history_agg_t *a, uint32_t start_s, int16_t min,
+                      int16_t avg, int16_t max, uint16_t count,
+                      uint8_t accuracy) {
+  const int16_t *v = a->min;
+  CHECK(a->start_s == start_s, "bucket start %u, want %u",
+        (unsigned)a->start_s, (unsigned)start_s);
+  CHECK(v[HISTORY_CH_CO2] == min && a->avg[HISTORY_CH_CO2] == avg &&
+            a->max[HISTORY_CH_CO2] == max,
+        "bucket at %u: %d/%d/%d, want %d/%d/%d", (unsigned)start_s,
+        v[HISTORY_CH_CO2], a->avg[HISTORY_CH_CO2], a->max[HISTORY_CH_CO2],
+        min, avg, max);
+  CHECK(a->count == count, "bucket at %u: %u samples, want %u",
+        (unsigned)start_s, a->count, count);
+  CHECK(a->accuracy == accuracy, "bucket at %u: accuracy %u, want %u",
+        (unsigned)start_s, a->accuracy, accuracy);
+}
+
+static void test_scale(void) {
+  CHECK(history_scale(HISTORY_CH_TEMP, 21.555f) == 2156, "21.555 C: %d",
+        history_scale(HISTORY_CH_TEMP, 21.555f));
+  CHECK(history_scale(HISTORY_CH_PRESSURE, 101325.0f) == 10133,
+        "101325 Pa: %d", history_scale(HISTORY_CH_PRESSURE, 101325.0f));
+  CHECK(history_scale(HISTORY_CH_TEMP, 327.67f) == INT16_MAX,
+        "327.67 C: %d", history_scale(HISTORY_CH_TEMP, 327.67f));
+  CHECK(history_scale(HISTORY_CH_TEMP, 400.0f) == INT16_MAX, "400 C: %d",
+        history_scale(HISTORY_CH_TEMP, 400.0f));
+  CHECK(history_scale(HISTORY_CH_TEMP, -400.0f) == INT16_MIN, "-400 C: %d",
+        history_scale(HISTORY_CH_TEMP, -400.0f));
+  CHECK(history_scale(HISTORY_CH_CO2, 1e9f) == INT16_MAX, "1e9 ppm: %d",
+        history_scale(HISTORY_CH_CO2, 1e9f));
+  CHECK(history_scale(HISTORY_CH_CO2, -1e9f) == INT16_MIN, "-1e9 ppm: %d",
+        history_scale(HISTORY_CH_CO2, -1e9f));
+}
+
+// One 5 min bucket, its last sample on the boundary second, then the hour
+static void test_fold_and_cascade(void) {
+  publish(0, 10, 3);
+  publish(100, 40, 1);
+  publish(299, 25, 2);
+  CHECK(read_tier(HISTORY_TIER_5MIN) == 0, "5 min bucket finished early");
+
+  publish(300, 50, 3);
+  CHECK(read_tier(HISTORY_TIER_5MIN) == 1, "5 min bucket not finished");
+  check_agg(&agg[0], 0, 10, 25, 40, 3, 1);
+
+  for (uint32_t t = 600; t < HISTORY_1H_PERIOD_S; t += 300)
+    publish(t, 50, 3);
+  publish(3599, 50, 3);
+  CHECK(read_tier(HISTORY_TIER_5MIN) == 11, "%u 5 min buckets, want 11",
+        (unsigned)read_tier(HISTORY_TIER_5MIN));
+  check_agg(&agg[10], 3000, 50, 50, 50, 1, 3);
+
+  // The hour only ends with the first 5 min bucket after it
+  publish(3600, 5, 2);
+  CHECK(read_tier(HISTORY_TIER_1H) == 0, "hourly bucket finished early");
+  publish(3900, 5, 2);
+  CHECK(read_tier(HISTORY_TIER_1H) == 1, "hourly bucket not finished");
+
+  // 75 from the first bucket, then 50 x 12 over 15 samples
+  check_agg(&agg[0], 0, 10, 45, 50, 15, 1);
+  CHECK(read_tier(HISTORY_TIER_5MIN) == 13, "%u 5 min buckets, want 13",
+        (unsigned)read_tier(HISTORY_TIER_5MIN));
+  check_agg(&agg[11], 3300, 50, 50, 50, 2, 3);
+  check_agg(&agg[12], 3600, 5, 5, 5, 1, 2);
+}
+
+// Far more samples than the raw ring holds, so it has wrapped
+static void test_raw_wrap(void) {
+  const uint32_t start_s = 4000;
+  const int n = HISTORY_RAW_LEN + 300;
+  uint32_t newest_s = 0;
+
+  for (int i = 0; i < n; i++)
+    publish(start_s + 3 * (uint32_t)i, (float)i, 3);
+
+  size_t got = history_read_raw(raw, sizeof(raw) / sizeof(raw[0]), &newest_s);
+  CHECK(got == HISTORY_RAW_LEN, "%u raw entries, want %u", (unsigned)got,
+        HISTORY_RAW_LEN);
+  CHECK(newest_s == start_s + 3 * (uint32_t)(n - 1), "newest at %u",
+        (unsigned)newest_s);
+  for (size_t i = 0; i < got; i++) {
+    const int want = n - HISTORY_RAW_LEN + (int)i;
+    if (raw[i].v[HISTORY_CH_CO2] != want ||
+        raw[i].time_s != (uint16_t)(start_s + 3 * (uint32_t)want)) {
+      CHECK(0, "raw[%u] holds %d at %u, want %d", (unsigned)i,
+            raw[i].v[HISTORY_CH_CO2], raw[i].time_s, want);
+      break;
+    }
+  }
+
+  got = history_read_raw(raw, 5, NULL);
+  CHECK(got == 5 && raw[0].v[HISTORY_CH_CO2] == n - 5 &&
+            raw[4].v[HISTORY_CH_CO2] == n - 1,
+        "newest 5 raw: %u entries from %d", (unsigned)got,
+        raw[0].v[HISTORY_CH_CO2]);
+}
+
+// A day and a half of 5 min buckets, so that ring has wrapped too
+static void test_agg_wrap(void) {
+  const uint32_t start_s = 24 * HISTORY_1H_PERIOD_S;
+  const uint32_t n = HISTORY_5MIN_LEN + HISTORY_5MIN_LEN / 2;
+
+  for (uint32_t i = 0; i <= n; i++)
+    publish(start_s + i * HISTORY_5MIN_PERIOD_S, (float)i, 3);
+
+  size_t got = read_tier(HISTORY_TIER_5MIN);
+  CHECK(got == HISTORY_5MIN_LEN, "%u 5 min buckets, want %u", (unsigned)got,
+        HISTORY_5MIN_LEN);
+  for (size_t i = 0; i < got; i++) {
+    const uint32_t want = n - HISTORY_5MIN_LEN + (uint32_t)i;
+    if (agg[i].start_s != start_s + want * HISTORY_5MIN_PERIOD_S ||
+        agg[i].avg[HISTORY_CH_CO2] != (int16_t)want) {
+      CHECK(0, "5 min bucket %u starts at %u with %d, want %u", (unsigned)i,
+            (unsigned)agg[i].start_s, agg[i].avg[HISTORY_CH_CO2],
+            (unsigned)want);
+      break;
+    }
+  }
+
+  // The newest finished 5 min bucket ends the hour before its own
+  const uint32_t last_hour =
+      (n - 1) * HISTORY_5MIN_PERIOD_S / HISTORY_1H_PERIOD_S - 1;
+  got = read_tier(HISTORY_TIER_1H);
+  CHECK(got > 0 && agg[got - 1].start_s ==
+                       start_s + last_hour * HISTORY_1H_PERIOD_S,
+        "newest hourly bucket at %u",
+        got > 0 ? (unsigned)agg[got - 1].start_s : 0u);
+}
+
+int main(void) {
+  if (!history_init()) {
+    printf("history_init failed\n");
+    return 1;
+  }
+
+  test_scale();
+  test_fold_and_cascade();
+  test_raw_wrap();
+  test_agg_wrap();
+
+  if (failures > 0) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+  printf("history: all checks passed\n");
+  return 0;
+}
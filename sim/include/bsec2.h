@@ -0,0 +1,64 @@
+#ifndef SIM_BSEC2_H
+#define SIM_BSEC2_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bsec_datatypes.h"
+#include "i2c_bus.h"
+
+// Stand-in for the bsec2 component. The BSEC library ships as a binary for
+// Xtensa/ARM only, so on host the outputs are synthesised from a
+// deterministic indoor-climate model while the I2C traffic of a forced-mode
+// measurement is accounted on the i2c_bus stand-in.
+
+#define ARRAY_LEN(array) (sizeof(array) / sizeof(array[0]))
+
+typedef enum {
+  BME68X_SPI_INTF,
+  BME68X_I2C_INTF,
+} bme68x_intf_t;
+
+typedef struct {
+  uint8_t status;
+  uint8_t gas_index;
+  uint8_t meas_index;
+  uint8_t res_heat;
+  uint8_t idac;
+  uint8_t gas_wait;
+  float temperature;
+  float pressure;
+  float humidity;
+  float gas_resistance;
+} bme68x_data_t;
+
+typedef struct bsec2_s bsec2_t;
+
+typedef void (*bsec2_callback_t)(const bme68x_data_t data,
+                                 const bsec_outputs_t outputs,
+                                 const bsec2_t bsec2);
+
+struct bsec2_s {
+  i2c_bus_t *i2c_bus;
+  bsec_bme_settings_t bme_conf;
+  bsec_outputs_t outputs;
+  bsec2_callback_t new_data_callback;
+  bsec_sensor_t subscription[BSEC_NUMBER_OUTPUTS];
+  uint8_t n_subscription;
+  float sample_rate;
+  float temp_offset;
+  uint32_t n_samples;
+  uint8_t state[BSEC_MAX_STATE_BLOB_SIZE];
+};
+
+bool bsec2_init(bsec2_t *const me, void *intf_ptr, bme68x_intf_t intf);
+bool bsec2_set_config(bsec2_t *const me, const uint8_t *config);
+bool bsec2_update_subscription(bsec2_t *const me, bsec_sensor_t *sensor_list,
+                               uint8_t n_sensors, float sample_rate);
+void bsec2_attach_callback(bsec2_t *const me, bsec2_callback_t callback);
+void bsec2_set_temperature_offset(bsec2_t *const me, float temp_offset);
+bool bsec2_get_state(bsec2_t *const me, uint8_t *state);
+bool bsec2_set_state(bsec2_t *const me, uint8_t *state);
+bool bsec2_run(bsec2_t *const me);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SIM_BSEC_DATATYPES_H
+#define SIM_BSEC_DATATYPES_H
+
+#include <stdint.h>
+
+// Subset of the BSEC 2.x datatypes used by the firmware. Ids and constants
+// match the vendor header so recorded values stay comparable.
+
+#define BSEC_MAX_STATE_BLOB_SIZE (221)
+#define BSEC_MAX_PROPERTY_BLOB_SIZE (2063)
+#define BSEC_NUMBER_OUTPUTS (19)
+
+#define BSEC_SAMPLE_RATE_DISABLED (65535.0f)
+#define BSEC_SAMPLE_RATE_ULP (0.0033333f)
+#define BSEC_SAMPLE_RATE_CONT (1.0f)
+#define BSEC_SAMPLE_RATE_LP (0.33333f)
+#define BSEC_SAMPLE_RATE_SCAN (0.055556f)
+
+typedef enum {
+  BSEC_OUTPUT_IAQ = 1,
+  BSEC_OUTPUT_STATIC_IAQ = 2,
+  BSEC_OUTPUT_CO2_EQUIVALENT = 3,
+  BSEC_OUTPUT_BREATH_VOC_EQUIVALENT = 4,
+  BSEC_OUTPUT_RAW_TEMPERATURE = 6,
+  BSEC_OUTPUT_RAW_PRESSURE = 7,
+  BSEC_OUTPUT_RAW_HUMIDITY = 8,
+  BSEC_OUTPUT_RAW_GAS = 9,
+  BSEC_OUTPUT_STABILIZATION_STATUS = 12,
+  BSEC_OUTPUT_RUN_IN_STATUS = 13,
+  BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE = 14,
+  BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY = 15,
+  BSEC_OUTPUT_GAS_PERCENTAGE = 21,
+} bsec_virtual_sensor_t;
+
+typedef uint8_t bsec_sensor_t;
+
+typedef struct {
+  int64_t time_stamp;
+  float signal;
+  uint8_t signal_dimensions;
+  uint8_t sensor_id;
+  uint8_t accuracy;
+} bsec_data_t;
+
+typedef struct {
+  bsec_data_t output[BSEC_NUMBER_OUTPUTS];
+  uint8_t n_outputs;
+} bsec_outputs_t;
+
+typedef struct {
+  int64_t next_call;
+  uint32_t process_data;
+  uint16_t heater_temperature;
+  uint16_t heater_duration;
+  uint8_t run_gas;
+  uint8_t pressure_oversampling;
+  uint8_t temperature_oversampling;
+  uint8_t humidity_oversampling;
+  uint8_t trigger_measurement;
+  uint8_t op_mode;
+} bsec_bme_settings_t;
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef SIM_DRIVER_I2C_H
+#define SIM_DRIVER_I2C_H
+
+#include "esp_err.h"
+
+typedef int i2c_port_t;
+typedef int gpio_num_t;
+
+#define I2C_NUM_0 0
+#define I2C_NUM_1 1
+
+#endif
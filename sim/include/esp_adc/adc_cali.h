@@ -0,0 +1,11 @@
+#ifndef SIM_ESP_ADC_CALI_H
+#define SIM_ESP_ADC_CALI_H
+
+#include "esp_err.h"
+
+typedef struct sim_adc_cali *adc_cali_handle_t;
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw,
+                                  int *voltage);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef SIM_ESP_LCD_ILI9341_H
+#define SIM_ESP_LCD_ILI9341_H
+
+#include "driver/spi_common.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+typedef struct {
+  int reset_gpio_num;
+  lcd_rgb_endian_t rgb_endian;
+  unsigned int bits_per_pixel;
+} esp_lcd_panel_dev_config_t;
+
+esp_err_t esp_lcd_new_panel_ili9341(const esp_lcd_panel_io_handle_t io,
+                                    const esp_lcd_panel_dev_config_t *config,
+                                    esp_lcd_panel_handle_t *ret_panel);
+
+#define ILI9341_PANEL_BUS_SPI_CONFIG(sclk, mosi, max_trans_sz)                 \
+  {                                                                            \
+      .mosi_io_num = mosi,                                                     \
+      .miso_io_num = -1,                                                       \
+      .sclk_io_num = sclk,                                                     \
+      .quadwp_io_num = -1,                                                     \
+      .quadhd_io_num = -1,                                                     \
+      .max_transfer_sz = max_trans_sz,                                         \
+  }
+
+#define ILI9341_PANEL_IO_SPI_CONFIG(cs, dc, callback, callback_ctx)            \
+  {                                                                            \
+      .cs_gpio_num = cs,                                                       \
+      .dc_gpio_num = dc,                                                       \
+      .spi_mode = 0,                                                           \
+      .pclk_hz = 40 * 1000 * 1000,                                             \
+      .trans_queue_depth = 10,                                                 \
+      .on_color_trans_done = callback,                                         \
+      .user_ctx = callback_ctx,                                                \
+      .lcd_cmd_bits = 8,                                                       \
+      .lcd_param_bits = 8,                                                     \
+  }
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SIM_ESP_LCD_PANEL_COMMANDS_H
+#define SIM_ESP_LCD_PANEL_COMMANDS_H
+
+// MIPI DCS commands used by the firmware
+#define LCD_CMD_SLPOUT 0x11
+#define LCD_CMD_DISPOFF 0x28
+#define LCD_CMD_DISPON 0x29
+#define LCD_CMD_CASET 0x2A
+#define LCD_CMD_RASET 0x2B
+#define LCD_CMD_RAMWR 0x2C
+#define LCD_CMD_MADCTL 0x36
+#define LCD_CMD_RAMWRC 0x3C
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef SIM_ESP_LCD_PANEL_IO_INTERFACE_H
+#define SIM_ESP_LCD_PANEL_IO_INTERFACE_H
+
+#include "esp_lcd_panel_io.h"
+
+typedef struct esp_lcd_panel_io_t esp_lcd_panel_io_t;
+
+// Parameter transfers dispatch through the handle as in esp_lcd, so
+// callers can interpose on them; the remaining fields belong to sim_lcd.c
+struct esp_lcd_panel_io_t {
+  esp_err_t (*rx_param)(esp_lcd_panel_io_t *io, int lcd_cmd, void *param,
+                        size_t param_size);
+  esp_err_t (*tx_param)(esp_lcd_panel_io_t *io, int lcd_cmd,
+                        const void *param, size_t param_size);
+
+  esp_lcd_spi_bus_handle_t bus;
+  esp_lcd_panel_io_spi_config_t config;
+  esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+  void *user_ctx;
+};
+
+#endif
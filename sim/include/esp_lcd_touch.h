@@ -0,0 +1,33 @@
+#ifndef SIM_ESP_LCD_TOUCH_H
+#define SIM_ESP_LCD_TOUCH_H
+
+#include "esp_lcd_panel_io.h"
+
+typedef struct esp_lcd_touch_s *esp_lcd_touch_handle_t;
+
+typedef void (*esp_lcd_touch_interrupt_callback_t)(esp_lcd_touch_handle_t tp);
+
+typedef struct {
+  uint16_t x_max;
+  uint16_t y_max;
+  int rst_gpio_num;
+  int int_gpio_num;
+  struct {
+    unsigned int reset : 1;
+    unsigned int interrupt : 1;
+  } levels;
+  struct {
+    unsigned int swap_xy : 1;
+    unsigned int mirror_x : 1;
+    unsigned int mirror_y : 1;
+  } flags;
+  esp_lcd_touch_interrupt_callback_t interrupt_callback;
+  void *user_data;
+} esp_lcd_touch_config_t;
+
+esp_err_t esp_lcd_touch_read_data(esp_lcd_touch_handle_t tp);
+bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x,
+                                   uint16_t *y, uint16_t *strength,
+                                   uint8_t *point_num, uint8_t max_point_num);
+
+#endif
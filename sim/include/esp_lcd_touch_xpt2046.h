@@ -0,0 +1,25 @@
+#ifndef SIM_ESP_LCD_TOUCH_XPT2046_H
+#define SIM_ESP_LCD_TOUCH_XPT2046_H
+
+#include "esp_lcd_touch.h"
+
+#define ESP_LCD_TOUCH_SPI_CLOCK_HZ (1 * 1000 * 1000)
+
+#define ESP_LCD_TOUCH_IO_SPI_XPT2046_CONFIG(touch_cs)                          \
+  {                                                                            \
+      .cs_gpio_num = touch_cs,                                                 \
+      .dc_gpio_num = -1,                                                       \
+      .spi_mode = 0,                                                           \
+      .pclk_hz = ESP_LCD_TOUCH_SPI_CLOCK_HZ,                                   \
+      .trans_queue_depth = 3,                                                  \
+      .on_color_trans_done = NULL,                                             \
+      .user_ctx = NULL,                                                        \
+      .lcd_cmd_bits = 8,                                                       \
+      .lcd_param_bits = 8,                                                     \
+  }
+
+esp_err_t esp_lcd_touch_new_spi_xpt2046(const esp_lcd_panel_io_handle_t io,
+                                        const esp_lcd_touch_config_t *config,
+                                        esp_lcd_touch_handle_t *out_touch);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef SIM_ESP_LCD_TYPES_H
+#define SIM_ESP_LCD_TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+typedef int esp_lcd_spi_bus_handle_t;
+
+typedef enum {
+  LCD_RGB_ENDIAN_RGB,
+  LCD_RGB_ENDIAN_BGR,
+} lcd_rgb_endian_t;
+
+#endif
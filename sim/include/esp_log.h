@@ -0,0 +1,44 @@
+#ifndef SIM_ESP_LOG_H
+#define SIM_ESP_LOG_H
+
+#include <stdint.h>
+
+typedef enum {
+  ESP_LOG_NONE,
+  ESP_LOG_ERROR,
+  ESP_LOG_WARN,
+  ESP_LOG_INFO,
+  ESP_LOG_DEBUG,
+  ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+// Colours are off on host
+#define LOG_COLOR_E ""
+#define LOG_COLOR_W ""
+#define LOG_COLOR_I ""
+#define LOG_RESET_COLOR ""
+
+// The level set with sim_log_set_level, for every tag
+esp_log_level_t esp_log_level_get(const char *tag);
+
+// Milliseconds of virtual time, like the RTOS timestamp source
+uint32_t esp_log_timestamp(void);
+// Prints `fmt` as is, without the level letter, time and tag
+void esp_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                   ...) __attribute__((format(printf, 3, 4)));
+
+void sim_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                   ...) __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, fmt, ...)                                                \
+  sim_log_write(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...)                                                \
+  sim_log_write(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...)                                                \
+  sim_log_write(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...)                                                \
+  sim_log_write(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...)                                                \
+  sim_log_write(ESP_LOG_VERBOSE, tag, fmt, ##__VA_ARGS__)
+
+#endif
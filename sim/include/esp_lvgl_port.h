@@ -0,0 +1,62 @@
+#ifndef SIM_ESP_LVGL_PORT_H
+#define SIM_ESP_LVGL_PORT_H
+
+#include "esp_err.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_touch.h"
+#include "lvgl.h"
+
+typedef struct {
+  int task_priority;
+  int task_stack;
+  int task_affinity;
+  int task_max_sleep_ms;
+  int timer_period_ms;
+} lvgl_port_cfg_t;
+
+#define ESP_LVGL_PORT_INIT_CONFIG()                                            \
+  {                                                                            \
+      .task_priority = 4,                                                      \
+      .task_stack = 4096,                                                      \
+      .task_affinity = -1,                                                     \
+      .task_max_sleep_ms = 500,                                                \
+      .timer_period_ms = 5,                                                    \
+  }
+
+typedef struct {
+  esp_lcd_panel_io_handle_t io_handle;
+  esp_lcd_panel_handle_t panel_handle;
+  uint32_t buffer_size;
+  bool double_buffer;
+  uint32_t trans_size;
+  uint32_t hres;
+  uint32_t vres;
+  bool monochrome;
+  struct {
+    bool swap_xy;
+    bool mirror_x;
+    bool mirror_y;
+  } rotation;
+  struct {
+    unsigned int buff_dma : 1;
+    unsigned int buff_spiram : 1;
+    unsigned int sw_rotate : 1;
+    unsigned int swap_bytes : 1;
+    unsigned int full_refresh : 1;
+    unsigned int direct_mode : 1;
+  } flags;
+} lvgl_port_display_cfg_t;
+
+typedef struct {
+  lv_display_t *disp;
+  esp_lcd_touch_handle_t handle;
+} lvgl_port_touch_cfg_t;
+
+esp_err_t lvgl_port_init(const lvgl_port_cfg_t *cfg);
+lv_display_t *lvgl_port_add_disp(const lvgl_port_display_cfg_t *disp_cfg);
+esp_err_t lvgl_port_remove_disp(lv_display_t *disp);
+lv_indev_t *lvgl_port_add_touch(const lvgl_port_touch_cfg_t *touch_cfg);
+bool lvgl_port_lock(uint32_t timeout_ms);
+void lvgl_port_unlock(void);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+
+typedef void (*TaskFunction_t)(void *);
+typedef struct sim_task *TaskHandle_t;
+
+typedef enum {
+  eRunning,
+  eReady,
+  eBlocked,
+  eSuspended,
+  eDeleted,
+  eInvalid,
+} eTaskState;
+
+typedef struct {
+  TaskHandle_t xHandle;
+  const char *pcTaskName;
+  UBaseType_t xTaskNumber;
+  eTaskState eCurrentState;
+  UBaseType_t uxCurrentPriority;
+  UBaseType_t uxBasePriority;
+  uint32_t ulRunTimeCounter; // host CPU microseconds
+  uint8_t *pxStackBase;
+  uint32_t usStackHighWaterMark; // bytes, as in ESP-IDF
+} TaskStatus_t;
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                       uint32_t stack_depth, void *param,
+                       UBaseType_t priority, TaskHandle_t *out_handle);
+#define taskENTER_CRITICAL(mux) ((void)(mux))
+#define taskEXIT_CRITICAL(mux) ((void)(mux))
+
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+UBaseType_t uxTaskGetNumberOfTasks(void);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t max,
+                                 uint32_t *total_run_time);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+
+// "Interrupts" run synchronously inside the task that triggered them
+static inline void vTaskNotifyGiveFromISR(TaskHandle_t task,
+                                          BaseType_t *woken) {
+  xTaskNotifyGive(task);
+  if (woken)
+    *woken = pdFALSE;
+}
+
+#endif
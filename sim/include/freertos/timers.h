@@ -0,0 +1,20 @@
+#ifndef SIM_FREERTOS_TIMERS_H
+#define SIM_FREERTOS_TIMERS_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*PendedFunction_t)(void *arg1, uint32_t arg2);
+
+// No timer service task on host: the deferred call runs at once, in the
+// task that raised the "interrupt"
+static inline BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t fn,
+                                                       void *arg1,
+                                                       uint32_t arg2,
+                                                       BaseType_t *woken) {
+  fn(arg1, arg2);
+  if (woken)
+    *woken = pdFALSE;
+  return pdPASS;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef SIM_I2C_BUS_H
+#define SIM_I2C_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/i2c.h"
+
+// Stand-in for the i2c_bus component: no wire, only traffic accounting.
+typedef struct {
+  i2c_port_t port;
+  uint32_t clk_speed;
+  uint64_t transactions;
+  uint64_t bytes;
+} i2c_bus_t;
+
+esp_err_t i2c_bus_init(i2c_bus_t *const me, i2c_port_t i2c_num,
+                       gpio_num_t sda_io_num, gpio_num_t scl_io_num,
+                       bool sda_pullup_en, bool scl_pullup_en,
+                       uint32_t clk_speed);
+
+// Accounts one transaction of `len` payload bytes on the bus
+void i2c_bus_sim_transfer(i2c_bus_t *const me, uint32_t len);
+
+#endif
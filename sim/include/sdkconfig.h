@@ -0,0 +1,27 @@
+#ifndef SIM_SDKCONFIG_H
+#define SIM_SDKCONFIG_H
+
+// Project options from sdkconfig. CONFIG_LCD_BENCHMARK,
+// CONFIG_POWER_LIGHT_SLEEP and a 400 kHz CONFIG_SENSOR_I2C_CLK_HZ are set by
+// the SIM_LCD_BENCHMARK, SIM_POWER_LIGHT_SLEEP and SIM_I2C_FAST CMake
+// options.
+#define CONFIG_LCD_DRAW_BUFFER_PARTIAL 1
+#define CONFIG_LCD_DRAW_BUFFER_LINES 80
+#define CONFIG_LCD_DRAW_BUFFER_DOUBLE 1
+#define CONFIG_UI_SCREEN_BUDGET_KB 20
+#ifndef CONFIG_SENSOR_I2C_CLK_HZ
+#define CONFIG_SENSOR_I2C_CLK_HZ 100000
+#endif
+#define CONFIG_DIAG_REPORT_PERIOD_S 300
+#define CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ 240
+#define CONFIG_PM_ENABLE 1
+#define CONFIG_POWER_MIN_CPU_FREQ_MHZ 80
+#define CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP 3
+// The board model in sim_adc.c
+#define CONFIG_BATTERY_MONITOR 1
+#define CONFIG_BATTERY_ADC_CHANNEL 2
+#define CONFIG_BATTERY_DIVIDER_TOP_KOHM 100
+#define CONFIG_BATTERY_DIVIDER_BOTTOM_KOHM 100
+#define CONFIG_BATTERY_CHRG_GPIO 5
+
+#endif
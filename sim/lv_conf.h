@@ -0,0 +1,49 @@
+// LVGL configuration for the host simulator. Values mirror the CONFIG_LV_*
+// entries in the firmware sdkconfig so rendering cost and heap use match.
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+
+#define LV_USE_STDLIB_MALLOC LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE (64 * 1024U)
+
+#define LV_DEF_REFR_PERIOD 33
+#define LV_DPI_DEF 130
+
+#define LV_USE_OS LV_OS_NONE
+
+#define LV_USE_DRAW_SW 1
+#define LV_DRAW_SW_DRAW_UNIT_CNT 1
+#define LV_DRAW_SW_COMPLEX 1
+#define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
+#define LV_DRAW_SW_LAYER_SIMPLE_BUF_SIZE (24 * 1024)
+
+#define LV_USE_LOG 0
+#define LV_USE_ASSERT_NULL 1
+#define LV_USE_ASSERT_MALLOC 1
+#define LV_USE_ASSERT_STYLE 1
+
+// 10, 12, 20 and 28 are replaced by the subsets built from them
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_14
+
+#define LV_USE_ARC 1
+#define LV_USE_CHART 1
+#define LV_USE_BAR 1
+#define LV_USE_LABEL 1
+#define LV_USE_IMAGE 1
+#define LV_USE_FLEX 1
+#define LV_USE_THEME_DEFAULT 1
+
+#define LV_USE_GIF 0
+
+#define LV_USE_SYSMON 1
+#define LV_USE_PERF_MONITOR 1
+#define LV_USE_PERF_MONITOR_POS LV_ALIGN_BOTTOM_RIGHT
+#define LV_USE_MEM_MONITOR 1
+#define LV_USE_MEM_MONITOR_POS LV_ALIGN_BOTTOM_LEFT
+
+#endif
@@ -0,0 +1,187 @@
+// Host test of the power policy core (main/power_core.c) on a scripted
+// timeline, through power_core_replay.
+//
+//   ./build-sim/esp32_clock_power_test
+//
+// One minute of a desk clock: a BSEC step on the I2C bus every 3 s, a
+// render and flush burst every second for 40 s (one of them overlapping a
+// BSEC step), then 20 s with the display idle. The timeline is replayed
+// with light sleep off and on. The time in each state is checked against
+// a millisecond by millisecond walk of the same timeline, and the estimated
+// current against those times. The savings over a fixed 240 MHz CPU are
+// printed.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "power_core.h"
+
+#define TIMELINE_MS 60000
+#define BSEC_PERIOD_MS 3000
+#define BSEC_STEP_MS 12
+#define FLUSH_UNTIL_MS 40000
+#define MAX_EVENTS 256
+
+// CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP of 3 ticks at 100 Hz
+#define SLEEP_THRESHOLD_US 30000
+
+static power_event_t events[MAX_EVENTS];
+static size_t n_events;
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      failures++;                                                              \
+      printf("%s:%d: ", __FILE__, __LINE__);                                   \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+static void add(int64_t at_ms, uint32_t duration_ms, power_activity_t act) {
+  if (n_events < MAX_EVENTS)
+    events[n_events++] = (power_event_t){.at_us = at_ms * 1000,
+                                         .duration_us = duration_ms * 1000,
+                                         .activity = act};
+}
+
+static int by_start(const void *a, const void *b) {
+  const power_event_t *ea = a, *eb = b;
+  return (ea->at_us > eb->at_us) - (ea->at_us < eb->at_us);
+}
+
+static void build_timeline(void) {
+  for (int64_t t = 0; t < TIMELINE_MS; t += BSEC_PERIOD_MS)
+    add(t, BSEC_STEP_MS, POWER_ACT_I2C);
+
+  // Render, then two bands; the first band starts while LVGL still runs
+  for (int64_t t = 500; t < FLUSH_UNTIL_MS; t += 1000) {
+    add(t, 8, POWER_ACT_LVGL);
+    add(t + 6, 14, POWER_ACT_SPI);
+    add(t + 20, 10, POWER_ACT_SPI);
+  }
+
+  // A touch redraw during a BSEC step
+  add(12005, 20, POWER_ACT_LVGL);
+
+  qsort(events, n_events, sizeof(events[0]), by_start);
+}
+
+// The reference: walks the timeline a millisecond at a time. An idle
+// stretch is light sleep as a whole when it is long enough, and a trailing
+// stretch shorter than the threshold is not accounted yet.
+static void expected_times(uint32_t threshold_us, int64_t *time_us,
+                           uint32_t *sleeps) {
+  static power_state_t state[TIMELINE_MS];
+
+  for (int ms = 0; ms < TIMELINE_MS; ms++) {
+    bool held[POWER_ACT_COUNT] = {false};
+    for (size_t i = 0; i < n_events; i++) {
+      const int64_t at = events[i].at_us / 1000;
+      if (ms >= at && ms < at + events[i].duration_us / 1000)
+        held[events[i].activity] = true;
+    }
+    state[ms] = held[POWER_ACT_LVGL]                        ? POWER_STATE_MAX
+                : held[POWER_ACT_SPI] || held[POWER_ACT_I2C] ? POWER_STATE_BUS
+                                                             : POWER_STATE_MIN;
+  }
+
+  for (int s = 0; s < POWER_STATE_COUNT; s++)
+    time_us[s] = 0;
+  *sleeps = 0;
+
+  for (int ms = 0; ms < TIMELINE_MS;) {
+    int end = ms + 1;
+    while (end < TIMELINE_MS && (state[end] == POWER_STATE_MIN) ==
+                                    (state[ms] == POWER_STATE_MIN) &&
+           (state[ms] == POWER_STATE_MIN || state[end] == state[ms]))
+      end++;
+
+    const int64_t len_us = (int64_t)(end - ms) * 1000;
+    if (state[ms] != POWER_STATE_MIN || threshold_us == 0) {
+      time_us[state[ms]] += len_us;
+    } else if (len_us >= threshold_us) {
+      time_us[POWER_STATE_SLEEP] += len_us;
+      (*sleeps)++;
+    } else if (end < TIMELINE_MS) {
+      time_us[POWER_STATE_MIN] += len_us;
+    }
+    ms = end;
+  }
+}
+
+static uint32_t expected_ua(const power_core_config_t *config,
+                            const int64_t *time_us, bool baseline) {
+  uint64_t total_us = 0, charge = 0;
+
+  for (int s = 0; s < POWER_STATE_COUNT; s++) {
+    const uint32_t ua = baseline && s != POWER_STATE_MAX ? config->baseline_ua
+                                                         : config->state_ua[s];
+    total_us += (uint64_t)time_us[s];
+    charge += (uint64_t)time_us[s] * ua;
+  }
+  return total_us ? (uint32_t)(charge / total_us) : 0;
+}
+
+static uint32_t run(const char *name, uint32_t threshold_us) {
+  power_core_config_t config = POWER_CORE_DEFAULT_CONFIG;
+  config.sleep_threshold_us = threshold_us;
+
+  power_core_t core;
+  power_core_init(&core, &config, 0);
+  power_core_replay(&core, events, n_events, (int64_t)TIMELINE_MS * 1000);
+
+  int64_t want_us[POWER_STATE_COUNT];
+  uint32_t want_sleeps;
+  expected_times(threshold_us, want_us, &want_sleeps);
+
+  printf("%-12s", name);
+  for (int s = 0; s < POWER_STATE_COUNT; s++) {
+    printf(" %s %.3f s%s", power_state_name(s),
+           (double)core.stats.time_us[s] / 1e6,
+           s + 1 < POWER_STATE_COUNT ? "," : "");
+    CHECK(core.stats.time_us[s] == want_us[s], "%s: %s %lld us, want %lld",
+          name, power_state_name(s), (long long)core.stats.time_us[s],
+          (long long)want_us[s]);
+  }
+  printf("; %u light sleeps\n", (unsigned)core.stats.sleeps);
+  CHECK(core.stats.sleeps == want_sleeps, "%s: %u light sleeps, want %u",
+        name, (unsigned)core.stats.sleeps, (unsigned)want_sleeps);
+
+  for (int a = 0; a < POWER_ACT_COUNT; a++) {
+    uint32_t n = 0;
+    for (size_t i = 0; i < n_events; i++)
+      n += events[i].activity == (power_activity_t)a;
+    CHECK(core.stats.acquired[a] == n, "%s: activity %d acquired %u times",
+          name, a, (unsigned)core.stats.acquired[a]);
+  }
+
+  const uint32_t avg = power_core_average_ua(&core);
+  const uint32_t baseline = power_core_baseline_ua(&core);
+  CHECK(avg == expected_ua(&config, want_us, false), "%s: %u uA, want %u",
+        name, (unsigned)avg, (unsigned)expected_ua(&config, want_us, false));
+  CHECK(baseline == expected_ua(&config, want_us, true),
+        "%s: baseline %u uA, want %u", name, (unsigned)baseline,
+        (unsigned)expected_ua(&config, want_us, true));
+  CHECK(avg < baseline, "%s: no saving", name);
+
+  printf("%-12s estimated %.2f mA vs %.2f mA at a fixed 240 MHz (-%.0f%%)\n",
+         "", (double)avg / 1e3, (double)baseline / 1e3,
+         100.0 * (baseline - avg) / baseline);
+  return avg;
+}
+
+int main(void) {
+  build_timeline();
+
+  const uint32_t dfs_ua = run("dfs", 0);
+  const uint32_t sleep_ua = run("light sleep", SLEEP_THRESHOLD_US);
+  CHECK(sleep_ua < dfs_ua, "light sleep saves nothing over DFS alone");
+
+  if (failures > 0) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+  return 0;
+}
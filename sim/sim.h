@@ -0,0 +1,81 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_log.h"
+
+// Virtual clock and cooperative scheduler driving the firmware tasks on host.
+// A task runs until it blocks (vTaskDelay, semaphore wait, ...), then the
+// clock jumps straight to the next wake-up, so idle time costs nothing.
+
+#define SIM_MAX_TASKS 16
+
+typedef struct {
+  const char *name;
+  uint64_t iterations; // number of times the task blocked
+  uint64_t cpu_ns;     // host CPU time spent inside the task
+  uint64_t max_cpu_ns; // longest single run between two blocks
+} sim_task_stats_t;
+
+typedef struct {
+  uint64_t flushes;  // pixel transfers
+  uint64_t bytes;
+  uint64_t commands; // polling command transactions
+  uint64_t touch_reads;
+  uint64_t touch_transactions;
+} sim_panel_stats_t;
+
+typedef struct {
+  uint64_t transactions;
+  uint64_t bytes;
+} sim_i2c_stats_t;
+
+typedef struct {
+  uint64_t reads;
+  uint64_t bytes_read;
+  uint64_t writes;
+  uint64_t bytes_written;
+  uint64_t erases; // 4 KB sectors
+  uint32_t mutating_ops;
+} sim_flash_stats_t;
+
+uint64_t sim_now_us(void);
+
+// Charges `us` of busy time to the running task (flash, bus transfers, ...)
+void sim_consume_us(uint64_t us);
+void sim_set_epoch(int64_t epoch_s);
+
+// Runs the scheduler until virtual time reaches `until_us`
+void sim_run_until(uint64_t until_us);
+
+// Called with the whole milliseconds of every clock advance (lv_tick_inc in
+// the simulator), so the scheduler itself needs no LVGL
+void sim_set_tick_hook(void (*hook)(uint32_t ms));
+
+size_t sim_task_stats(sim_task_stats_t *out, size_t max);
+void sim_panel_get_stats(sim_panel_stats_t *out);
+void sim_i2c_get_stats(sim_i2c_stats_t *out);
+
+void sim_log_set_level(esp_log_level_t level);
+// Every console line blocks the task printing it for `us`, as a USB
+// console can while no host reads it
+void sim_log_set_console_stall(uint32_t us);
+
+// Backs the flash partitions with a file so data survives between runs
+void sim_flash_set_file(const char *path);
+// Cuts power half-way through the n-th write or erase (0 = never)
+void sim_flash_set_power_loss(uint32_t after_ops);
+void sim_flash_get_stats(sim_flash_stats_t *out);
+// Gives heap_caps_malloc a PSRAM region of `bytes` (default none)
+void sim_heap_set_psram(size_t bytes);
+// Drives an input pin; runs the ISR handler of a matching edge at once
+void sim_gpio_set_level(int pin, int level);
+// Taps the touch screen every `period_s` (default 600, 0 = never)
+void sim_touch_set_tap_period(uint32_t period_s);
+// Keeps NVS contents in "<flash_path>.nvs"
+void sim_nvs_set_file(const char *flash_path);
+
+#endif
@@ -0,0 +1,126 @@
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_continuous.h"
+
+// Board model: a 1S LiPo behind a 1:2 divider, discharging linearly from
+// 4.10 V at 60 mV per hour, read with about +-20 mV of noise at the pin.
+// The charger never runs, so CHRG stays at its idle (pulled-up) level.
+#define CELL_START_MV 4100
+#define CELL_DRAIN_MV_PER_H 60
+#define CELL_MIN_MV 3300
+#define DIVIDER 2
+#define NOISE_RAW 64
+#define FULL_SCALE_MV 2500
+#define RAW_MAX ((1 << SOC_ADC_DIGI_MAX_BITWIDTH) - 1)
+
+struct sim_adc {
+  uint32_t frame_bytes;
+  uint32_t sample_freq_hz;
+  uint8_t channel;
+  bool running;
+  bool frame_ready;
+};
+
+struct sim_adc_cali {
+  int unused;
+};
+
+static uint32_t noise_state = 12345;
+
+static int noise(void) {
+  noise_state = noise_state * 1103515245u + 12345u;
+  return (int)((noise_state >> 16) % (2 * NOISE_RAW + 1)) - NOISE_RAW;
+}
+
+static int cell_mv(void) {
+  const int drained =
+      (int)(sim_now_us() * CELL_DRAIN_MV_PER_H / 3600000000ULL);
+  const int mv = CELL_START_MV - drained;
+  return mv < CELL_MIN_MV ? CELL_MIN_MV : mv;
+}
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *cfg,
+                                    adc_continuous_handle_t *out) {
+  struct sim_adc *adc = calloc(1, sizeof(*adc));
+  if (adc == NULL)
+    return ESP_ERR_NO_MEM;
+
+  adc->frame_bytes = cfg->conv_frame_size;
+  *out = adc;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle,
+                                const adc_continuous_config_t *config) {
+  if (config->pattern_num != 1 || config->sample_freq_hz == 0)
+    return ESP_ERR_INVALID_ARG;
+
+  handle->channel = config->adc_pattern[0].channel;
+  handle->sample_freq_hz = config->sample_freq_hz;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle) {
+  if (handle->running)
+    return ESP_ERR_INVALID_STATE;
+
+  handle->running = true;
+  handle->frame_ready = false;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle) {
+  if (!handle->running)
+    return ESP_ERR_INVALID_STATE;
+
+  handle->running = false;
+  return ESP_OK;
+}
+
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t *buf,
+                              uint32_t length_max, uint32_t *out_length,
+                              uint32_t timeout_ms) {
+  *out_length = 0;
+  if (!handle->running || handle->frame_ready)
+    return ESP_ERR_TIMEOUT;
+
+  const uint32_t bytes =
+      length_max < handle->frame_bytes ? length_max : handle->frame_bytes;
+  const uint32_t samples = bytes / SOC_ADC_DIGI_RESULT_BYTES;
+
+  // The DMA fills the frame at the sample rate
+  sim_consume_us((uint64_t)samples * 1000000 / handle->sample_freq_hz);
+
+  const int pin_mv = cell_mv() / DIVIDER;
+  for (uint32_t i = 0; i < samples; i++) {
+    int raw = pin_mv * RAW_MAX / FULL_SCALE_MV + noise();
+    raw = raw < 0 ? 0 : raw > RAW_MAX ? RAW_MAX : raw;
+
+    adc_digi_output_data_t d = {0};
+    d.type1.data = (uint16_t)raw;
+    d.type1.channel = handle->channel;
+    memcpy(buf + i * SOC_ADC_DIGI_RESULT_BYTES, &d, sizeof(d));
+  }
+
+  handle->frame_ready = true;
+  *out_length = samples * SOC_ADC_DIGI_RESULT_BYTES;
+  return ESP_OK;
+}
+
+esp_err_t
+adc_cali_create_scheme_line_fitting(const adc_cali_line_fitting_config_t *cfg,
+                                    adc_cali_handle_t *out) {
+  static struct sim_adc_cali cali;
+  *out = &cali;
+  return ESP_OK;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw,
+                                  int *voltage) {
+  *voltage = raw * FULL_SCALE_MV / RAW_MAX;
+  return ESP_OK;
+}
@@ -0,0 +1,194 @@
+#include "sim.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "bsec2.h"
+#include "esp_timer.h"
+#include "i2c_trace.h"
+
+// Register traffic of one forced-mode cycle on a BME680: heater and
+// oversampling setup, mode trigger, status polling and the field readout.
+#define SIM_CONFIG_WRITES 6
+#define SIM_CONFIG_WRITE_LEN 2
+#define SIM_STATUS_POLLS 3
+#define SIM_FIELD_READ_LEN 15
+
+// Per transaction: START, address byte, STOP, plus the time the legacy
+// driver takes to queue the command link and wait for its completion
+#define SIM_I2C_FRAME_BITS (2 + 9)
+#define SIM_I2C_DRIVER_US 40
+
+static i2c_bus_t *stats_bus;
+
+esp_err_t i2c_bus_init(i2c_bus_t *const me, i2c_port_t i2c_num,
+                       gpio_num_t sda_io_num, gpio_num_t scl_io_num,
+                       bool sda_pullup_en, bool scl_pullup_en,
+                       uint32_t clk_speed) {
+  (void)sda_io_num;
+  (void)scl_io_num;
+  (void)sda_pullup_en;
+  (void)scl_pullup_en;
+
+  memset(me, 0, sizeof(*me));
+  me->port = i2c_num;
+  me->clk_speed = clk_speed;
+  stats_bus = me;
+  return ESP_OK;
+}
+
+void i2c_bus_sim_transfer(i2c_bus_t *const me, uint32_t len) {
+  const uint64_t bits = SIM_I2C_FRAME_BITS + 9ull * len;
+  const uint32_t us =
+      SIM_I2C_DRIVER_US + (uint32_t)((bits * 1000000 + me->clk_speed - 1) /
+                                     me->clk_speed);
+
+  me->transactions++;
+  me->bytes += len;
+  sim_consume_us(us);
+  i2c_trace_record(me->port, len + 1, us, ESP_OK);
+}
+
+void sim_i2c_get_stats(sim_i2c_stats_t *out) {
+  out->transactions = stats_bus ? stats_bus->transactions : 0;
+  out->bytes = stats_bus ? stats_bus->bytes : 0;
+}
+
+bool bsec2_init(bsec2_t *const me, void *intf_ptr, bme68x_intf_t intf) {
+  if (intf != BME68X_I2C_INTF)
+    return false;
+
+  memset(me, 0, sizeof(*me));
+  me->i2c_bus = intf_ptr;
+  me->sample_rate = BSEC_SAMPLE_RATE_DISABLED;
+
+  // Chip id and calibration readout
+  i2c_bus_sim_transfer(me->i2c_bus, 1);
+  i2c_bus_sim_transfer(me->i2c_bus, 42);
+  return true;
+}
+
+bool bsec2_set_config(bsec2_t *const me, const uint8_t *config) {
+  return me != NULL && config != NULL;
+}
+
+bool bsec2_update_subscription(bsec2_t *const me, bsec_sensor_t *sensor_list,
+                               uint8_t n_sensors, float sample_rate) {
+  if (n_sensors > BSEC_NUMBER_OUTPUTS)
+    return false;
+
+  memcpy(me->subscription, sensor_list, n_sensors * sizeof(*sensor_list));
+  me->n_subscription = n_sensors;
+  me->sample_rate = sample_rate;
+  me->bme_conf.next_call = esp_timer_get_time() * 1000;
+  return true;
+}
+
+void bsec2_attach_callback(bsec2_t *const me, bsec2_callback_t callback) {
+  me->new_data_callback = callback;
+}
+
+void bsec2_set_temperature_offset(bsec2_t *const me, float temp_offset) {
+  me->temp_offset = temp_offset;
+}
+
+bool bsec2_get_state(bsec2_t *const me, uint8_t *state) {
+  memcpy(state, me->state, sizeof(me->state));
+  return true;
+}
+
+bool bsec2_set_state(bsec2_t *const me, uint8_t *state) {
+  memcpy(me->state, state, sizeof(me->state));
+  return true;
+}
+
+// Small deterministic noise so consecutive samples are not bit-identical
+static float noise(uint32_t n) {
+  n = n * 1103515245u + 12345u;
+  return (float)((n >> 16) & 0x7fff) / 32768.0f - 0.5f;
+}
+
+static uint8_t accuracy_at(double t_s) {
+  if (t_s < 5 * 60)
+    return 0;
+  if (t_s < 30 * 60)
+    return 1;
+  if (t_s < 2 * 3600)
+    return 2;
+  return 3;
+}
+
+static float signal_for(bsec2_t *const me, uint8_t sensor_id, double t_s) {
+  const double day = 2.0 * M_PI * t_s / 86400.0;
+  const uint32_t n = me->n_samples * 31u + sensor_id;
+
+  switch (sensor_id) {
+  case BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE:
+    return 25.5f + 1.5f * (float)sin(day) - me->temp_offset +
+           0.05f * noise(n);
+  case BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY:
+    return 45.0f - 5.0f * (float)sin(day) + 0.3f * noise(n);
+  case BSEC_OUTPUT_RAW_PRESSURE:
+    return 101325.0f + 150.0f * (float)sin(day / 3.0) + 5.0f * noise(n);
+  case BSEC_OUTPUT_STATIC_IAQ:
+  case BSEC_OUTPUT_IAQ:
+    return 60.0f + 40.0f * (float)sin(day * 4.0) + 2.0f * noise(n);
+  case BSEC_OUTPUT_CO2_EQUIVALENT:
+    return 600.0f + 300.0f * (float)sin(day * 4.0) + 10.0f * noise(n);
+  case BSEC_OUTPUT_GAS_PERCENTAGE:
+    return 50.0f + 20.0f * (float)sin(day * 4.0) + noise(n);
+  default:
+    return 0.0f;
+  }
+}
+
+bool bsec2_run(bsec2_t *const me) {
+  const int64_t now_ns = esp_timer_get_time() * 1000;
+
+  if (me->sample_rate == BSEC_SAMPLE_RATE_DISABLED ||
+      now_ns < me->bme_conf.next_call)
+    return true;
+
+  for (int i = 0; i < SIM_CONFIG_WRITES; i++)
+    i2c_bus_sim_transfer(me->i2c_bus, SIM_CONFIG_WRITE_LEN);
+  for (int i = 0; i < SIM_STATUS_POLLS; i++)
+    i2c_bus_sim_transfer(me->i2c_bus, 1);
+  i2c_bus_sim_transfer(me->i2c_bus, SIM_FIELD_READ_LEN);
+
+  const double t_s = (double)now_ns / 1e9;
+
+  // state[0] carries the calibration level so a restored state skips the
+  // warm-up, as it does with the real library
+  uint8_t accuracy = accuracy_at(t_s);
+  if (accuracy < me->state[0])
+    accuracy = me->state[0];
+  me->state[0] = accuracy;
+
+  bme68x_data_t data = {
+      .status = 0xb0,
+      .temperature = signal_for(
+          me, BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE, t_s),
+      .pressure = signal_for(me, BSEC_OUTPUT_RAW_PRESSURE, t_s),
+      .humidity = signal_for(
+          me, BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY, t_s),
+      .gas_resistance = 120000.0f,
+  };
+
+  me->outputs.n_outputs = 0;
+  for (uint8_t i = 0; i < me->n_subscription; i++) {
+    bsec_data_t *out = &me->outputs.output[me->outputs.n_outputs++];
+    out->time_stamp = now_ns;
+    out->sensor_id = me->subscription[i];
+    out->signal = signal_for(me, me->subscription[i], t_s);
+    out->signal_dimensions = 1;
+    out->accuracy = accuracy;
+  }
+
+  me->n_samples++;
+  me->bme_conf.next_call = now_ns + (int64_t)(1e9f / me->sample_rate);
+
+  if (me->new_data_callback)
+    me->new_data_callback(data, me->outputs, *me);
+
+  return true;
+}
@@ -0,0 +1,176 @@
+#include "sim.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+
+// File- or RAM-backed stand-in for the data partitions of partitions.csv.
+// Programming can only clear bits, like NOR flash, and every operation
+// charges a modelled latency to the virtual clock of the calling task.
+
+#define SIM_FLASH_SECTOR 4096
+
+// ESP32-S2 with a typical QSPI NOR part
+#define SIM_FLASH_READ_SETUP_US 2
+#define SIM_FLASH_READ_BYTES_PER_US 40
+#define SIM_FLASH_PROGRAM_SETUP_US 25
+#define SIM_FLASH_PROGRAM_US_PER_16B 40
+#define SIM_FLASH_ERASE_SECTOR_US 45000
+
+static esp_partition_t sample_log_partition = {
+    .type = ESP_PARTITION_TYPE_DATA,
+    .subtype = (esp_partition_subtype_t)0x40,
+    .address = 0x110000,
+    .size = 0x80000,
+    .erase_size = SIM_FLASH_SECTOR,
+    .label = "samplelog",
+};
+
+static uint8_t *flash_mem;
+static const char *flash_path;
+static uint32_t power_loss_after;
+static sim_flash_stats_t flash_stats;
+
+void sim_flash_set_file(const char *path) { flash_path = path; }
+
+void sim_flash_set_power_loss(uint32_t after_ops) {
+  power_loss_after = after_ops;
+}
+
+void sim_flash_get_stats(sim_flash_stats_t *out) { *out = flash_stats; }
+
+static bool flash_open(void) {
+  const size_t size = sample_log_partition.size;
+
+  if (flash_mem)
+    return true;
+
+  if (flash_path == NULL) {
+    flash_mem = malloc(size);
+    if (flash_mem == NULL)
+      return false;
+    memset(flash_mem, 0xff, size);
+    return true;
+  }
+
+  int fd = open(flash_path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0)
+    return false;
+
+  off_t existing = lseek(fd, 0, SEEK_END);
+  if (existing < (off_t)size) {
+    // Fresh image: extend with erased bytes
+    static const uint8_t erased[SIM_FLASH_SECTOR] = {[0 ... SIM_FLASH_SECTOR -
+                                                     1] = 0xff};
+    for (off_t off = existing; off < (off_t)size; off += sizeof(erased))
+      pwrite(fd, erased, sizeof(erased), off);
+  }
+
+  flash_mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (flash_mem == MAP_FAILED) {
+    flash_mem = NULL;
+    return false;
+  }
+  return true;
+}
+
+// Counts a mutating operation and reports whether power dies during it
+static bool power_lost_now(void) {
+  flash_stats.mutating_ops++;
+  return power_loss_after != 0 && flash_stats.mutating_ops == power_loss_after;
+}
+
+static void power_loss_exit(const char *op) {
+  printf("\n*** simulated power loss during %s #%u ***\n", op,
+         (unsigned)flash_stats.mutating_ops);
+  fflush(stdout);
+  exit(3);
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label) {
+  const esp_partition_t *p = &sample_log_partition;
+
+  if (type != p->type)
+    return NULL;
+  if (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != p->subtype)
+    return NULL;
+  if (label != NULL && strcmp(label, p->label) != 0)
+    return NULL;
+
+  return flash_open() ? p : NULL;
+}
+
+static bool in_range(const esp_partition_t *p, size_t offset, size_t size) {
+  return offset <= p->size && size <= p->size - offset;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t src_offset,
+                             void *dst, size_t size) {
+  if (!in_range(p, src_offset, size))
+    return ESP_ERR_INVALID_SIZE;
+
+  memcpy(dst, flash_mem + src_offset, size);
+  flash_stats.reads++;
+  flash_stats.bytes_read += size;
+  sim_consume_us(SIM_FLASH_READ_SETUP_US + size / SIM_FLASH_READ_BYTES_PER_US);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t dst_offset,
+                              const void *src, size_t size) {
+  if (!in_range(p, dst_offset, size))
+    return ESP_ERR_INVALID_SIZE;
+
+  bool lost = power_lost_now();
+  size_t n = lost ? size / 2 : size;
+  const uint8_t *bytes = src;
+
+  for (size_t i = 0; i < n; i++)
+    flash_mem[dst_offset + i] &= bytes[i];
+
+  if (lost)
+    power_loss_exit("write");
+
+  flash_stats.writes++;
+  flash_stats.bytes_written += size;
+  sim_consume_us(SIM_FLASH_PROGRAM_SETUP_US +
+                 (size + 15) / 16 * SIM_FLASH_PROGRAM_US_PER_16B);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset,
+                                    size_t size) {
+  if (!in_range(p, offset, size) || offset % SIM_FLASH_SECTOR != 0 ||
+      size % SIM_FLASH_SECTOR != 0)
+    return ESP_ERR_INVALID_ARG;
+
+  bool lost = power_lost_now();
+  memset(flash_mem + offset, 0xff, lost ? size / 2 : size);
+
+  if (lost)
+    power_loss_exit("erase");
+
+  flash_stats.erases += size / SIM_FLASH_SECTOR;
+  sim_consume_us(size / SIM_FLASH_SECTOR * SIM_FLASH_ERASE_SECTOR_US);
+  return ESP_OK;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xedb88320u & -(crc & 1));
+  }
+  return ~crc;
+}
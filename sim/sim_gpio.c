@@ -0,0 +1,72 @@
+#include "sim.h"
+
+#include "driver/gpio.h"
+
+#define SIM_GPIO_COUNT 48
+
+typedef struct {
+  int level;
+  gpio_int_type_t intr_type;
+  gpio_isr_t handler;
+  void *arg;
+} sim_gpio_t;
+
+// Unconnected and open-drain inputs idle high
+static sim_gpio_t pins[SIM_GPIO_COUNT] = {
+    [0 ... SIM_GPIO_COUNT - 1] = {.level = 1},
+};
+
+static bool valid(gpio_num_t pin) { return pin >= 0 && pin < SIM_GPIO_COUNT; }
+
+esp_err_t gpio_config(const gpio_config_t *config) {
+  for (int pin = 0; pin < SIM_GPIO_COUNT; pin++)
+    if (config->pin_bit_mask & (1ULL << pin))
+      pins[pin].intr_type = config->intr_type;
+  return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+  return valid(gpio_num) ? pins[gpio_num].level : 0;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull) {
+  (void)pull;
+  return valid(gpio_num) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+  static bool installed;
+  (void)intr_alloc_flags;
+
+  if (installed)
+    return ESP_ERR_INVALID_STATE;
+  installed = true;
+  return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler,
+                               void *args) {
+  if (!valid(gpio_num))
+    return ESP_ERR_INVALID_ARG;
+
+  pins[gpio_num].handler = isr_handler;
+  pins[gpio_num].arg = args;
+  return ESP_OK;
+}
+
+void sim_gpio_set_level(int pin, int level) {
+  if (!valid(pin))
+    return;
+
+  sim_gpio_t *p = &pins[pin];
+  const int old = p->level;
+  p->level = level ? 1 : 0;
+  if (p->handler == NULL || old == p->level)
+    return;
+
+  const bool rising = p->level == 1;
+  if (p->intr_type == GPIO_INTR_ANYEDGE ||
+      (p->intr_type == GPIO_INTR_POSEDGE && rising) ||
+      (p->intr_type == GPIO_INTR_NEGEDGE && !rising))
+    p->handler(p->arg);
+}
@@ -0,0 +1,88 @@
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+
+// Capability-aware heap: blocks come from the host allocator, but each region
+// has a fixed capacity so allocations fail where they would on the device.
+// Internal RAM is what an ESP32-S2 has free once the app starts; PSRAM is
+// absent unless sim_heap_set_psram is called.
+
+#define SIM_INTERNAL_HEAP_BYTES (220 * 1024)
+
+typedef struct {
+  size_t size;
+  uint32_t region;
+} block_hdr_t;
+
+enum { REGION_INTERNAL, REGION_SPIRAM, REGION_COUNT };
+
+static size_t capacity[REGION_COUNT] = {SIM_INTERNAL_HEAP_BYTES, 0};
+static size_t used[REGION_COUNT];
+static size_t peak[REGION_COUNT];
+
+void sim_heap_set_psram(size_t bytes) { capacity[REGION_SPIRAM] = bytes; }
+
+static void *region_alloc(int region, size_t size) {
+  if (used[region] + size > capacity[region])
+    return NULL;
+
+  block_hdr_t *hdr = malloc(sizeof(*hdr) + size);
+  if (hdr == NULL)
+    return NULL;
+
+  hdr->size = size;
+  hdr->region = region;
+  used[region] += size;
+  if (used[region] > peak[region])
+    peak[region] = used[region];
+  return hdr + 1;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+  // PSRAM is not DMA capable
+  if (caps & MALLOC_CAP_SPIRAM)
+    return (caps & MALLOC_CAP_DMA) ? NULL : region_alloc(REGION_SPIRAM, size);
+  return region_alloc(REGION_INTERNAL, size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  void *p = heap_caps_malloc(n * size, caps);
+  if (p)
+    memset(p, 0, n * size);
+  return p;
+}
+
+void heap_caps_free(void *ptr) {
+  if (ptr == NULL)
+    return;
+
+  block_hdr_t *hdr = (block_hdr_t *)ptr - 1;
+  used[hdr->region] -= hdr->size;
+  free(hdr);
+}
+
+static int caps_region(uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? REGION_SPIRAM : REGION_INTERNAL;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+  return capacity[caps_region(caps)];
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  int r = caps_region(caps);
+  return capacity[r] - used[r];
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  int r = caps_region(caps);
+  return capacity[r] - peak[r];
+}
+
+// Fragmentation is not modelled
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
@@ -0,0 +1,450 @@
+#include "sim.h"
+
+#include <stdlib.h>
+
+#include "driver/spi_common.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_ili9341.h"
+#include "driver/gpio.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_lcd_touch_xpt2046.h"
+#include "esp_lvgl_port.h"
+#include "freertos/task.h"
+
+// Headless stand-ins for the SPI bus, the ILI9341 panel, the XPT2046 touch
+// controller and esp_lvgl_port. Pixels are discarded; only the traffic that
+// would reach the panel is counted.
+
+struct esp_lcd_panel_t {
+  esp_lcd_panel_io_handle_t io;
+  unsigned int bits_per_pixel;
+};
+
+struct esp_lcd_touch_s {
+  esp_lcd_panel_io_handle_t io;
+  esp_lcd_touch_config_t config;
+};
+
+// The XPT2046 driver reads Z1 and Z2 on every poll and, with the pen down,
+// this many X/Y pairs to average
+#define SIM_TOUCH_SAMPLES 4
+#define SIM_TAP_MS 200
+
+// ILI9341_PANEL_IO_SPI_CONFIG clocks the panel at 40 MHz
+#define SIM_SPI_CLOCK_MHZ 40
+// Driver and bus set-up of one polling transaction
+#define SIM_SPI_POLL_US 10
+
+static sim_panel_stats_t panel_stats;
+static lv_display_t *port_disp;
+static esp_lcd_panel_handle_t port_panel;
+static lvgl_port_display_cfg_t port_cfg;
+static void *port_bufs[2];
+static void *port_trans;
+static int port_task_max_sleep_ms;
+static esp_lcd_touch_handle_t sim_touch;
+static bool pen_down;
+static uint32_t tap_period_s = 600;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host,
+                             const spi_bus_config_t *config,
+                             spi_dma_chan_t dma_chan) {
+  (void)host;
+  (void)dma_chan;
+  return config != NULL ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host) {
+  (void)host;
+  return ESP_OK;
+}
+
+// A parameter transfer is a polling transaction: set-up time plus its
+// bytes at the device's clock. Only the panel (the device with a D/C line)
+// counts as panel commands.
+static void poll_transaction(esp_lcd_panel_io_t *io, size_t bytes) {
+  const uint64_t clock_hz = io->config.pclk_hz ? io->config.pclk_hz
+                                               : SIM_SPI_CLOCK_MHZ * 1000000;
+  if (io->config.dc_gpio_num >= 0)
+    panel_stats.commands++;
+  else
+    panel_stats.touch_transactions++;
+  sim_consume_us(SIM_SPI_POLL_US + bytes * 8 * 1000000 / clock_hz);
+}
+
+static esp_err_t spi_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param,
+                              size_t param_size) {
+  (void)lcd_cmd;
+  (void)param;
+  poll_transaction(io, 1 + param_size);
+  return ESP_OK;
+}
+
+static esp_err_t spi_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd,
+                              const void *param, size_t param_size) {
+  (void)param;
+  if (lcd_cmd >= 0)
+    poll_transaction(io, 1 + param_size);
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus,
+                                   const esp_lcd_panel_io_spi_config_t *config,
+                                   esp_lcd_panel_io_handle_t *ret_io) {
+  struct esp_lcd_panel_io_t *io = calloc(1, sizeof(*io));
+  if (io == NULL)
+    return ESP_ERR_NO_MEM;
+
+  io->rx_param = spi_rx_param;
+  io->tx_param = spi_tx_param;
+  io->bus = bus;
+  io->config = *config;
+  io->on_color_trans_done = config->on_color_trans_done;
+  io->user_ctx = config->user_ctx;
+  *ret_io = io;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io) {
+  free(io);
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(
+    esp_lcd_panel_io_handle_t io, const esp_lcd_panel_io_callbacks_t *cbs,
+    void *user_ctx) {
+  io->on_color_trans_done = cbs->on_color_trans_done;
+  io->user_ctx = user_ctx;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_rx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd,
+                                    void *param, size_t param_size) {
+  return io->rx_param(io, lcd_cmd, param, param_size);
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd,
+                                    const void *param, size_t param_size) {
+  return io->tx_param(io, lcd_cmd, param, param_size);
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd,
+                                    const void *color, size_t color_size) {
+  (void)color;
+  if (lcd_cmd >= 0)
+    poll_transaction(io, 1);
+
+  panel_stats.flushes++;
+  panel_stats.bytes += color_size;
+
+  // The DMA runs to completion before the caller continues
+  sim_consume_us(color_size * 8 / SIM_SPI_CLOCK_MHZ);
+  if (io->on_color_trans_done)
+    io->on_color_trans_done(io, NULL, io->user_ctx);
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_ili9341(const esp_lcd_panel_io_handle_t io,
+                                    const esp_lcd_panel_dev_config_t *config,
+                                    esp_lcd_panel_handle_t *ret_panel) {
+  struct esp_lcd_panel_t *panel = calloc(1, sizeof(*panel));
+  if (panel == NULL)
+    return ESP_ERR_NO_MEM;
+
+  panel->io = io;
+  panel->bits_per_pixel = config->bits_per_pixel;
+  *ret_panel = panel;
+  return ESP_OK;
+}
+
+// The ILI9341 driver sleeps through the reset pulse and the 120 ms the
+// controller needs after SLPOUT; other tasks run meanwhile
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel) {
+  (void)panel;
+  vTaskDelay(pdMS_TO_TICKS(20));
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel) {
+  (void)panel;
+  vTaskDelay(pdMS_TO_TICKS(120));
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel) {
+  free(panel);
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start,
+                                    int y_start, int x_end, int y_end,
+                                    const void *color_data) {
+  (void)color_data;
+
+  uint64_t pixels = (uint64_t)(x_end - x_start) * (uint64_t)(y_end - y_start);
+
+  // Same sequence as the ILI9341 driver
+  esp_lcd_panel_io_tx_param(panel->io, LCD_CMD_CASET, NULL, 4);
+  esp_lcd_panel_io_tx_param(panel->io, LCD_CMD_RASET, NULL, 4);
+  return esp_lcd_panel_io_tx_color(panel->io, LCD_CMD_RAMWR, color_data,
+                                   pixels * panel->bits_per_pixel / 8);
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x,
+                               bool mirror_y) {
+  (void)panel;
+  (void)mirror_x;
+  (void)mirror_y;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes) {
+  (void)panel;
+  (void)swap_axes;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel,
+                                    bool on_off) {
+  (void)panel;
+  (void)on_off;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_touch_new_spi_xpt2046(const esp_lcd_panel_io_handle_t io,
+                                        const esp_lcd_touch_config_t *config,
+                                        esp_lcd_touch_handle_t *out_touch) {
+  struct esp_lcd_touch_s *tp = calloc(1, sizeof(*tp));
+  if (tp == NULL)
+    return ESP_ERR_NO_MEM;
+
+  tp->io = io;
+  tp->config = *config;
+
+  // As esp_lcd_touch: PENIRQ edge interrupt calling the user callback
+  if (config->int_gpio_num >= 0) {
+    const gpio_config_t irq = {
+        .pin_bit_mask = 1ULL << config->int_gpio_num,
+        .mode = GPIO_MODE_INPUT,
+        .intr_type = config->levels.interrupt ? GPIO_INTR_POSEDGE
+                                              : GPIO_INTR_NEGEDGE,
+    };
+    gpio_config(&irq);
+    if (config->interrupt_callback) {
+      gpio_install_isr_service(0);
+      gpio_isr_handler_add(config->int_gpio_num,
+                           (gpio_isr_t)config->interrupt_callback, tp);
+    }
+  }
+
+  sim_touch = tp;
+  *out_touch = tp;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_touch_read_data(esp_lcd_touch_handle_t tp) {
+  uint8_t buf[2];
+
+  panel_stats.touch_reads++;
+  esp_lcd_panel_io_rx_param(tp->io, 0xB0, buf, 2); // Z1
+  esp_lcd_panel_io_rx_param(tp->io, 0xC0, buf, 2); // Z2
+  if (pen_down) {
+    for (int i = 0; i < SIM_TOUCH_SAMPLES; i++) {
+      esp_lcd_panel_io_rx_param(tp->io, 0xD0, buf, 2); // X
+      esp_lcd_panel_io_rx_param(tp->io, 0x90, buf, 2); // Y
+    }
+  }
+  return ESP_OK;
+}
+
+bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x,
+                                   uint16_t *y, uint16_t *strength,
+                                   uint8_t *point_num, uint8_t max_point_num) {
+  (void)tp;
+  (void)strength;
+  (void)max_point_num;
+
+  *point_num = pen_down ? 1 : 0;
+  if (pen_down) {
+    // An empty spot in the middle of the dashboard
+    *x = 160;
+    *y = 120;
+  }
+  return pen_down;
+}
+
+// A finger that taps the screen every tap_period_s
+static void touch_model_task(void *param) {
+  (void)param;
+
+  while (true) {
+    vTaskDelay(pdMS_TO_TICKS((uint64_t)tap_period_s * 1000));
+    if (sim_touch == NULL)
+      continue;
+
+    const int pin = sim_touch->config.int_gpio_num;
+    pen_down = true;
+    sim_gpio_set_level(pin, 0);
+    vTaskDelay(pdMS_TO_TICKS(SIM_TAP_MS));
+    pen_down = false;
+    sim_gpio_set_level(pin, 1);
+  }
+}
+
+void sim_touch_set_tap_period(uint32_t period_s) { tap_period_s = period_s; }
+
+void sim_panel_get_stats(sim_panel_stats_t *out) { *out = panel_stats; }
+
+static void port_task(void *param) {
+  (void)param;
+
+  while (true) {
+    uint32_t sleep_ms = lv_timer_handler();
+    if (sleep_ms > (uint32_t)port_task_max_sleep_ms)
+      sleep_ms = port_task_max_sleep_ms;
+    if (sleep_ms < portTICK_PERIOD_MS)
+      sleep_ms = portTICK_PERIOD_MS;
+    vTaskDelay(pdMS_TO_TICKS(sleep_ms));
+  }
+}
+
+esp_err_t lvgl_port_init(const lvgl_port_cfg_t *cfg) {
+  lv_init();
+  port_task_max_sleep_ms = cfg->task_max_sleep_ms;
+
+  if (tap_period_s > 0)
+    xTaskCreate(touch_model_task, "touch_model", 2048, NULL, 1, NULL);
+
+  if (xTaskCreate(port_task, "taskLVGL", cfg->task_stack, NULL,
+                  cfg->task_priority, NULL) != pdPASS)
+    return ESP_FAIL;
+
+  return ESP_OK;
+}
+
+// PSRAM buffers are not DMA capable; the port copies them through an internal
+// buffer of trans_size pixels, one transfer per chunk
+static void draw_area(int x1, int y1, int x2, int y2, const uint8_t *px_map) {
+  const int w = x2 - x1;
+  int rows = y2 - y1;
+  if (port_cfg.trans_size > 0 && (uint32_t)w <= port_cfg.trans_size)
+    rows = port_cfg.trans_size / w;
+
+  for (int y = y1; y < y2; y += rows) {
+    int end = y + rows < y2 ? y + rows : y2;
+    esp_lcd_panel_draw_bitmap(port_panel, x1, y, x2, end, px_map);
+  }
+}
+
+static void port_flush_cb(lv_display_t *disp, const lv_area_t *area,
+                          uint8_t *px_map) {
+  if (port_cfg.flags.full_refresh || port_cfg.flags.direct_mode) {
+    // The whole frame buffer is sent once LVGL has finished with it
+    if (lv_display_flush_is_last(disp))
+      draw_area(0, 0, port_cfg.hres, port_cfg.vres, px_map);
+    else
+      lv_display_flush_ready(disp);
+  } else {
+    draw_area(area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+  }
+}
+
+static bool port_trans_done(esp_lcd_panel_io_handle_t io,
+                            esp_lcd_panel_io_event_data_t *edata,
+                            void *user_ctx) {
+  (void)io;
+  (void)edata;
+  lv_display_flush_ready(user_ctx);
+  return false;
+}
+
+lv_display_t *lvgl_port_add_disp(const lvgl_port_display_cfg_t *disp_cfg) {
+  // buffer_size is in pixels
+  const size_t bytes = disp_cfg->buffer_size * sizeof(uint16_t);
+  const uint32_t caps = disp_cfg->flags.buff_spiram ? MALLOC_CAP_SPIRAM
+                        : disp_cfg->flags.buff_dma  ? MALLOC_CAP_DMA
+                                                    : MALLOC_CAP_INTERNAL;
+  void *buf1 = heap_caps_malloc(bytes, caps);
+  void *buf2 = disp_cfg->double_buffer ? heap_caps_malloc(bytes, caps) : NULL;
+  void *trans = NULL;
+  if (disp_cfg->trans_size)
+    trans = heap_caps_malloc(disp_cfg->trans_size * sizeof(uint16_t),
+                             MALLOC_CAP_DMA);
+
+  if (buf1 == NULL || (disp_cfg->double_buffer && buf2 == NULL) ||
+      (disp_cfg->trans_size && trans == NULL)) {
+    heap_caps_free(buf1);
+    heap_caps_free(buf2);
+    heap_caps_free(trans);
+    return NULL;
+  }
+
+  int mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+  if (disp_cfg->flags.full_refresh)
+    mode = LV_DISPLAY_RENDER_MODE_FULL;
+  else if (disp_cfg->flags.direct_mode)
+    mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+
+  port_cfg = *disp_cfg;
+  port_bufs[0] = buf1;
+  port_bufs[1] = buf2;
+  port_trans = trans; // only its footprint matters on host
+  port_panel = disp_cfg->panel_handle;
+  port_disp = lv_display_create(disp_cfg->hres, disp_cfg->vres);
+  lv_display_set_flush_cb(port_disp, port_flush_cb);
+  lv_display_set_buffers(port_disp, buf1, buf2, bytes, mode);
+
+  const esp_lcd_panel_io_callbacks_t cbs = {
+      .on_color_trans_done = port_trans_done,
+  };
+  esp_lcd_panel_io_register_event_callbacks(disp_cfg->io_handle, &cbs,
+                                            port_disp);
+  return port_disp;
+}
+
+esp_err_t lvgl_port_remove_disp(lv_display_t *disp) {
+  if (disp == NULL || disp != port_disp)
+    return ESP_ERR_INVALID_ARG;
+
+  lv_display_delete(disp);
+  heap_caps_free(port_bufs[0]);
+  heap_caps_free(port_bufs[1]);
+  heap_caps_free(port_trans);
+  port_disp = NULL;
+  return ESP_OK;
+}
+
+static void port_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+  esp_lcd_touch_handle_t tp = lv_indev_get_user_data(indev);
+  uint16_t x, y;
+  uint8_t count = 0;
+
+  esp_lcd_touch_read_data(tp);
+  bool pressed = esp_lcd_touch_get_coordinates(tp, &x, &y, NULL, &count, 1);
+
+  if (pressed && count > 0) {
+    data->point.x = x;
+    data->point.y = y;
+    data->state = LV_INDEV_STATE_PRESSED;
+  } else {
+    data->state = LV_INDEV_STATE_RELEASED;
+  }
+}
+
+lv_indev_t *lvgl_port_add_touch(const lvgl_port_touch_cfg_t *touch_cfg) {
+  lv_indev_t *indev = lv_indev_create();
+  lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+  lv_indev_set_read_cb(indev, port_touch_read_cb);
+  lv_indev_set_display(indev, touch_cfg->disp);
+  lv_indev_set_user_data(indev, touch_cfg->handle);
+  return indev;
+}
+
+// Tasks never preempt each other, so the lock only documents intent
+bool lvgl_port_lock(uint32_t timeout_ms) {
+  (void)timeout_ms;
+  return true;
+}
+
+void lvgl_port_unlock(void) {}
@@ -0,0 +1,502 @@
+#include "sim.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "battery.h"
+#include "bsec_record.h"
+#include "esp_heap_caps.h"
+#include "esp_lvgl_port.h"
+#include "freertos/task.h"
+#include "history.h"
+#include "i2c_trace.h"
+#include "lcd_flush.h"
+#include "lcd_touch.h"
+#include "log_defer.h"
+#include "lvgl.h"
+#include "power_policy.h"
+#include "sample_bus.h"
+#include "sample_log.h"
+#include "sdkconfig.h"
+#include "sensor_registry.h"
+#include "sensors_bme680.h"
+#include "sprite_anim.h"
+#include "telemetry.h"
+#include "ui.h"
+#include "ui_screens.h"
+
+#define SIM_TOUR_START_MS 10000
+#define SIM_TOUR_STEP_MS 5000
+
+// Run on after the last replayed frame, so it reaches every subscriber
+#define SIM_REPLAY_TAIL_S 60
+
+static uint32_t mode_period_s;
+
+extern void app_main(void);
+extern const sprite_anim_dsc_t kitty_sprite;
+
+static void main_task(void *param) {
+  (void)param;
+  app_main();
+}
+
+// Shows every screen in turn, then the dashboard again, so the report has
+// the build cost of each and the budget gets exercised
+static void tour_task(void *param) {
+  (void)param;
+
+  vTaskDelay(pdMS_TO_TICKS(SIM_TOUR_START_MS));
+  for (int i = 1; i <= UI_SCREEN_COUNT; i++) {
+    if (lvgl_port_lock(0)) {
+      ui_screens_show(i % UI_SCREEN_COUNT);
+      lvgl_port_unlock();
+    }
+    vTaskDelay(pdMS_TO_TICKS(SIM_TOUR_STEP_MS));
+  }
+  vTaskDelete(NULL);
+}
+
+// Moves to the next BME680 sampling mode every mode_period_s, as taps on
+// the air quality card would
+static void mode_task(void *param) {
+  (void)param;
+
+  while (true) {
+    vTaskDelay(pdMS_TO_TICKS((uint64_t)mode_period_s * 1000));
+    bme680_set_mode((bme680_get_mode() + 1) % BME680_MODE_COUNT);
+  }
+}
+
+static bool file_sink(const void *data, size_t len, void *ctx) {
+  return fwrite(data, 1, len, ctx) == len;
+}
+
+// The driver replays from memory, so the file is read in one go
+static uint8_t *load_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL)
+    return NULL;
+
+  uint8_t *buf = NULL;
+  if (fseek(f, 0, SEEK_END) == 0) {
+    const long size = ftell(f);
+    rewind(f);
+    buf = size > 0 ? malloc((size_t)size) : NULL;
+    if (buf && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+      free(buf);
+      buf = NULL;
+    }
+    *len = buf ? (size_t)size : 0;
+  }
+  fclose(f);
+  return buf;
+}
+
+// Device time a replay of `buf` needs, from boot
+static double replay_hours(const uint8_t *buf, size_t len) {
+  static bsec_record_frame_t frame;
+  bsec_record_reader_t reader;
+  int64_t first_us = -1;
+  int64_t last_us = 0;
+
+  if (!bsec_record_reader_init(&reader, buf, len))
+    return 0;
+  while (bsec_record_next(&reader, &frame)) {
+    if (first_us < 0)
+      first_us = frame.timestamp_us;
+    last_us = frame.timestamp_us;
+  }
+  if (first_us < 0)
+    return 0;
+  return ((double)(last_us - first_us) / 1e6 + SIM_REPLAY_TAIL_S) / 3600.0;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [--hours H] [--epoch UNIX_S] [--flash FILE]\n"
+          "          [--power-loss-after N] [--psram KB] [--tap-every S]\n"
+          "          [--mode-every S] [--record FILE] [--replay FILE]\n"
+          "          [--telemetry FILE] [--console-stall MS] [--tour] "
+          "[--quiet]\n"
+          "  --hours H        device time to simulate (default 1, or the "
+          "length\n"
+          "                   of the --replay recording)\n"
+          "  --epoch UNIX_S   wall clock at boot (default 2024-01-01)\n"
+          "  --flash FILE     keep the flash partitions in FILE across runs\n"
+          "  --power-loss-after N\n"
+          "                   cut power during the N-th flash write/erase\n"
+          "  --psram KB       give the board KB of PSRAM (default none)\n"
+          "  --tap-every S    tap the touch screen every S seconds (default "
+          "600, 0 = never)\n"
+          "  --mode-every S   change the BME680 sampling mode every S seconds\n"
+          "  --record FILE    record the BME680 frames and BSEC outputs\n"
+          "  --replay FILE    feed a recording through the sensor pipeline "
+          "instead\n"
+          "                   of BSEC (a file from --record or the bsecrec "
+          "partition)\n"
+          "  --telemetry FILE write the binary telemetry stream to FILE\n"
+          "  --console-stall MS\n"
+          "                   hold up each task printing a console line for "
+          "MS ms,\n"
+          "                   as a USB console without a host can\n"
+          "  --tour           visit every screen once after boot\n"
+          "  --quiet          only print warnings, errors and the report\n",
+          prog);
+}
+
+static void print_report(double wall_s) {
+  const double sim_s = (double)sim_now_us() / 1e6;
+
+  printf("\n=== Simulation report ===\n");
+  printf("device time: %.0f s, wall time: %.2f s (x%.0f)\n", sim_s, wall_s,
+         wall_s > 0 ? sim_s / wall_s : 0.0);
+
+  sim_task_stats_t stats[SIM_MAX_TASKS];
+  size_t n = sim_task_stats(stats, SIM_MAX_TASKS);
+
+  printf("\n%-12s %10s %12s %12s %12s\n", "task", "iterations", "cpu total",
+         "cpu/iter", "cpu max");
+  for (size_t i = 0; i < n; i++) {
+    const sim_task_stats_t *t = &stats[i];
+    printf("%-12s %10llu %10.1fms %10.2fus %10.2fus\n", t->name,
+           (unsigned long long)t->iterations, (double)t->cpu_ns / 1e6,
+           t->iterations ? (double)t->cpu_ns / 1e3 / (double)t->iterations
+                         : 0.0,
+           (double)t->max_cpu_ns / 1e3);
+  }
+
+  sim_panel_stats_t panel;
+  sim_panel_get_stats(&panel);
+  printf("\npanel: %llu transfers, %llu bytes (%.1f B/s), %llu commands, "
+         "%llu touch reads\n",
+         (unsigned long long)panel.flushes, (unsigned long long)panel.bytes,
+         sim_s > 0 ? (double)panel.bytes / sim_s : 0.0,
+         (unsigned long long)panel.commands,
+         (unsigned long long)panel.touch_reads);
+
+  lcd_flush_stats_t flush;
+  lcd_flush_get_stats(&flush);
+  printf("flush: %lu bands, %lu windows, %lu continued, %lu areas merged, "
+         "%.1f ms waiting on the bus\n",
+         (unsigned long)flush.flushes, (unsigned long)flush.windows,
+         (unsigned long)flush.continued, (unsigned long)flush.merged_areas,
+         (double)flush.dma_wait_us / 1e3);
+
+  sim_i2c_stats_t i2c;
+  i2c_trace_stats_t trace;
+  sim_i2c_get_stats(&i2c);
+  i2c_trace_get_stats(I2C_NUM_0, &trace);
+  printf("i2c: %llu transactions, %llu bytes at %u kHz, %.1f ms on the "
+         "wire, max %lu us; %lu NACKs, %lu errors\n",
+         (unsigned long long)i2c.transactions, (unsigned long long)i2c.bytes,
+         CONFIG_SENSOR_I2C_CLK_HZ / 1000, (double)trace.bus_us / 1e3,
+         (unsigned long)trace.max_us, (unsigned long)trace.nacks,
+         (unsigned long)trace.errors);
+  printf("  us:");
+  for (int i = 0; i < I2C_TRACE_US_BUCKETS; i++)
+    printf(" %s%lu:%lu", i < I2C_TRACE_US_BUCKETS - 1 ? "<" : ">=",
+           32ul << (i < I2C_TRACE_US_BUCKETS - 1 ? i : i - 1),
+           (unsigned long)trace.us_hist[i]);
+  printf("\n  bytes:");
+  for (int i = 0; i < I2C_TRACE_BYTES_BUCKETS; i++)
+    printf(" %s%lu:%lu", i < I2C_TRACE_BYTES_BUCKETS - 1 ? "<=" : ">",
+           1ul << (i < I2C_TRACE_BYTES_BUCKETS - 1 ? i : i - 1),
+           (unsigned long)trace.bytes_hist[i]);
+  putchar('\n');
+
+  sensor_driver_stats_t drivers[SENSOR_REGISTRY_MAX_DRIVERS];
+  const size_t n_drivers =
+      sensor_registry_get_stats(drivers, SENSOR_REGISTRY_MAX_DRIVERS);
+  for (size_t i = 0; i < n_drivers; i++) {
+    const sensor_driver_stats_t *d = &drivers[i];
+    printf("  %s: %s, %lu polls, %.2f ms max, %.1f ms total "
+           "(%.1f ms on the wire)\n",
+           d->name, d->ready ? "ready" : "failed", (unsigned long)d->polls,
+           (double)d->poll_us_max / 1e3, (double)d->bus_us / 1e3,
+           (double)d->wire_us / 1e3);
+    printf("    lateness: %.2f ms mean, %.2f ms max, %lu over budget\n",
+           d->polls ? (double)d->late_us_sum / d->polls / 1e3 : 0.0,
+           (double)d->late_us_max / 1e3, (unsigned long)d->late);
+  }
+
+  sample_bus_stats_t bus;
+  sample_bus_subscriber_stats_t subs[SAMPLE_BUS_MAX_SUBSCRIBERS];
+  sample_bus_get_stats(&bus);
+  const size_t n_subs =
+      sample_bus_get_subscriber_stats(subs, SAMPLE_BUS_MAX_SUBSCRIBERS);
+  printf("sample bus: %lu publishes, %lu samples;",
+         (unsigned long)bus.publishes, (unsigned long)bus.samples);
+  for (size_t i = 0; i < n_subs; i++)
+    printf(" %s %lu%s", subs[i].name, (unsigned long)subs[i].deliveries,
+           i + 1 < n_subs ? "," : "");
+  putchar('\n');
+
+  log_defer_stats_t dlog;
+  log_defer_get_stats(&dlog);
+  printf("deferred log: %lu records, %lu dropped, peak %lu of %lu\n",
+         (unsigned long)dlog.written, (unsigned long)dlog.dropped,
+         (unsigned long)dlog.peak, (unsigned long)dlog.capacity);
+
+  static history_raw_t raw[HISTORY_RAW_LEN];
+  static history_agg_t agg[HISTORY_5MIN_LEN];
+  printf("history: %u bytes, %u raw, %u 5 min, %u hourly entries\n",
+         (unsigned)history_memory_bytes(),
+         (unsigned)history_read_raw(raw, HISTORY_RAW_LEN, NULL),
+         (unsigned)history_read_agg(HISTORY_TIER_5MIN, agg, HISTORY_5MIN_LEN),
+         (unsigned)history_read_agg(HISTORY_TIER_1H, agg, HISTORY_5MIN_LEN));
+
+  ui_update_stats_t ui_stats;
+  ui_get_update_stats(&ui_stats);
+  printf("widget updates: %lu applied, %lu skipped\n",
+         (unsigned long)ui_stats.applied, (unsigned long)ui_stats.skipped);
+
+  // The kitty redraws every 150 ms and everything else at most every 3 s,
+  // so the LVGL task time per animation frame is dominated by the sprite
+  sprite_anim_stats_t anim;
+  sprite_anim_get_stats(&anim);
+  uint64_t lvgl_cpu_ns = 0;
+  for (size_t i = 0; i < n; i++)
+    if (strcmp(stats[i].name, "taskLVGL") == 0)
+      lvgl_cpu_ns = stats[i].cpu_ns;
+  printf("kitty: %lu frames, %.1f us LVGL cpu/frame, %u B heap, "
+         "%u B sprite sheet\n",
+         (unsigned long)anim.frames_shown,
+         anim.frames_shown ? (double)lvgl_cpu_ns / 1e3 / anim.frames_shown
+                           : 0.0,
+         (unsigned)anim.heap_bytes, (unsigned)kitty_sprite.sheet_bytes);
+
+  bme680_stats_t sensor;
+  bme680_get_stats(&sensor);
+  printf("bsec: state %s, %u saves, accuracy >= 2 after %s",
+         sensor.state_restored ? "restored" : "fresh",
+         (unsigned)sensor.state_saves,
+         sensor.accuracy2_after_us < 0 ? "never" : "");
+  if (sensor.accuracy2_after_us >= 0)
+    printf("%.0f s", (double)sensor.accuracy2_after_us / 1e6);
+  putchar('\n');
+  if (sensor.replayed > 0)
+    printf("  %u frames replayed\n", (unsigned)sensor.replayed);
+  if (sensor.bsec_runs > 0)
+    printf("  bsec2_run: %u measuring calls, avg %.2f ms (max %.2f), "
+           "%.0f%% on the wire\n",
+           (unsigned)sensor.bsec_runs,
+           (double)sensor.bsec_run_us / 1e3 / sensor.bsec_runs,
+           (double)sensor.bsec_run_us_max / 1e3,
+           (double)sensor.bsec_wire_us * 100.0 / (double)sensor.bsec_run_us);
+  printf("  %u mode switches, %u rejected\n", (unsigned)sensor.mode_switches,
+         (unsigned)sensor.mode_failures);
+  for (int m = 0; m < BME680_MODE_COUNT; m++) {
+    const bme680_mode_stats_t *ms = &sensor.modes[m];
+    if (ms->time_us == 0)
+      continue;
+    printf("  %-4s%s %7.0f s, %5u measurements, duty %.3f%%, budget %u uA\n",
+           bme680_mode_name(m), m == (int)sensor.mode ? "*" : " ",
+           (double)ms->time_us / 1e6, (unsigned)ms->runs,
+           (double)ms->run_us * 100.0 / (double)ms->time_us,
+           (unsigned)bme680_mode_budget_ua(m, ms));
+  }
+
+  sample_log_stats_t log;
+  sim_flash_stats_t flash;
+  sample_log_get_stats(&log);
+  sim_flash_get_stats(&flash);
+  const double payload = (double)log.appended * 16.0;
+  printf("sample log: %u appended, %u blocks, %u erases, next seq %u, "
+         "%u torn\n",
+         (unsigned)log.appended, (unsigned)log.blocks_written,
+         (unsigned)log.sectors_erased, (unsigned)log.next_seq,
+         (unsigned)log.torn_blocks);
+  printf("  recovery: %u reads, %.2f ms; write amplification %.2f "
+         "(%llu programmed + %llu erased bytes)\n",
+         (unsigned)log.recovery_reads, (double)log.recovery_us / 1e3,
+         payload > 0 ? (double)(flash.bytes_written + flash.erases * 4096) /
+                           payload
+                     : 0.0,
+         (unsigned long long)flash.bytes_written,
+         (unsigned long long)(flash.erases * 4096));
+
+  battery_stats_t bat_stats;
+  battery_state_t bat = {0};
+  battery_get_stats(&bat_stats);
+  battery_get(&bat);
+  printf("battery: %lu bursts, %lu samples, %lu events, %lu held back by "
+         "hysteresis; %u%% (%u mV)\n",
+         (unsigned long)bat_stats.bursts, (unsigned long)bat_stats.samples,
+         (unsigned long)bat_stats.events, (unsigned long)bat_stats.suppressed,
+         bat.percent, bat.mv);
+
+  ui_screen_stats_t screens[UI_SCREENS_MAX];
+  const size_t n_screens = ui_screens_get_stats(screens, UI_SCREENS_MAX);
+  printf("screens (%u B of a %u B budget built):",
+         (unsigned)ui_screens_heap_bytes(), CONFIG_UI_SCREEN_BUDGET_KB * 1024);
+  for (size_t i = 0; i < n_screens; i++)
+    printf(" %s %lu builds %.2f ms %u B%s%s", screens[i].name,
+           (unsigned long)screens[i].builds,
+           (double)screens[i].build_us / 1e3, (unsigned)screens[i].heap_bytes,
+           screens[i].built ? "" : " freed",
+           i + 1 < n_screens ? "," : "\n");
+
+  lcd_touch_stats_t touch;
+  lcd_touch_get_stats(&touch);
+  printf("touch: %lu SPI transactions/h, %lu reads, %lu wakeups, "
+         "%lu suspends, %.1f ms on the bus\n",
+         (unsigned long)lcd_touch_transactions_per_hour(&touch),
+         (unsigned long)touch.reads,
+         (unsigned long)touch.wakeups, (unsigned long)touch.suspends,
+         (double)touch.bus_us / 1e3);
+
+  power_core_stats_t power;
+  uint32_t avg_ua, baseline_ua;
+  power_policy_get_stats(&power, &avg_ua, &baseline_ua);
+  printf("power:");
+  for (int st = 0; st < POWER_STATE_COUNT; st++)
+    printf(" %s %.1f s%s", power_state_name(st),
+           (double)power.time_us[st] / 1e6,
+           st + 1 < POWER_STATE_COUNT ? "," : "");
+  printf("; %u light sleeps\n", (unsigned)power.sleeps);
+  printf("  estimated %.2f mA vs %.2f mA at a fixed 240 MHz\n",
+         (double)avg_ua / 1e3, (double)baseline_ua / 1e3);
+
+  printf("internal heap: %u bytes free, minimum %u\n",
+         (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+         (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  printf("lvgl heap: %u/%u bytes used, peak %u, largest free %u, frag %u%%\n",
+         (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.total_size,
+         (unsigned)mon.max_used, (unsigned)mon.free_biggest_size,
+         (unsigned)mon.frag_pct);
+}
+
+int main(int argc, char **argv) {
+  static const struct option options[] = {
+      {"hours", required_argument, NULL, 'h'},
+      {"epoch", required_argument, NULL, 'e'},
+      {"flash", required_argument, NULL, 'f'},
+      {"power-loss-after", required_argument, NULL, 'p'},
+      {"psram", required_argument, NULL, 's'},
+      {"tap-every", required_argument, NULL, 't'},
+      {"mode-every", required_argument, NULL, 'm'},
+      {"record", required_argument, NULL, 'r'},
+      {"replay", required_argument, NULL, 'y'},
+      {"telemetry", required_argument, NULL, 'l'},
+      {"console-stall", required_argument, NULL, 'c'},
+      {"tour", no_argument, NULL, 'o'},
+      {"quiet", no_argument, NULL, 'q'},
+      {NULL, 0, NULL, 0},
+  };
+
+  double hours = 0;
+  bool tour = false;
+  FILE *record = NULL;
+  uint8_t *replay = NULL;
+  size_t replay_len = 0;
+  FILE *telemetry = NULL;
+  int opt;
+
+  while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+    switch (opt) {
+    case 'h':
+      hours = atof(optarg);
+      break;
+    case 'e':
+      sim_set_epoch(atoll(optarg));
+      break;
+    case 'f':
+      sim_flash_set_file(optarg);
+      sim_nvs_set_file(optarg);
+      break;
+    case 'p':
+      sim_flash_set_power_loss((uint32_t)atol(optarg));
+      break;
+    case 's':
+      sim_heap_set_psram((size_t)atol(optarg) * 1024);
+      break;
+    case 't':
+      sim_touch_set_tap_period((uint32_t)atol(optarg));
+      break;
+    case 'm':
+      mode_period_s = (uint32_t)atol(optarg);
+      break;
+    case 'r':
+      record = fopen(optarg, "wb");
+      if (record == NULL || !bsec_record_start(file_sink, record)) {
+        fprintf(stderr, "Cannot record to %s\n", optarg);
+        return 1;
+      }
+      break;
+    case 'y':
+      replay = load_file(optarg, &replay_len);
+      if (replay == NULL || !bme680_replay(replay, replay_len)) {
+        fprintf(stderr, "Cannot replay %s\n", optarg);
+        return 1;
+      }
+      break;
+    case 'l':
+      telemetry = fopen(optarg, "wb");
+      if (telemetry == NULL || !telemetry_start(telemetry)) {
+        fprintf(stderr, "Cannot write telemetry to %s\n", optarg);
+        return 1;
+      }
+      break;
+    case 'c':
+      sim_log_set_console_stall((uint32_t)(atof(optarg) * 1000));
+      break;
+    case 'o':
+      tour = true;
+      break;
+    case 'q':
+      sim_log_set_level(ESP_LOG_WARN);
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (hours <= 0)
+    hours = replay ? replay_hours(replay, replay_len) : 1.0;
+
+  setenv("TZ", "UTC0", 1);
+  tzset();
+
+  sim_set_tick_hook(lv_tick_inc);
+  xTaskCreate(main_task, "main", 3584, NULL, 1, NULL);
+  if (tour)
+    xTaskCreate(tour_task, "tour", 2048, NULL, 1, NULL);
+  if (mode_period_s > 0)
+    xTaskCreate(mode_task, "mode", 2048, NULL, 1, NULL);
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  sim_run_until((uint64_t)(hours * 3600.0 * 1e6));
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  print_report((double)(end.tv_sec - start.tv_sec) +
+               (double)(end.tv_nsec - start.tv_nsec) / 1e9);
+
+  if (record) {
+    bsec_record_stats_t rec;
+    bsec_record_get_stats(&rec);
+    bsec_record_stop();
+    fclose(record);
+    printf("recording: %u frames, %llu bytes, %u dropped\n",
+           (unsigned)rec.frames, (unsigned long long)rec.bytes,
+           (unsigned)rec.dropped);
+  }
+  if (telemetry) {
+    telemetry_stats_t tel;
+    telemetry_get_stats(&tel);
+    fclose(telemetry);
+    printf("telemetry: %u frames, %llu bytes, %u dropped\n",
+           (unsigned)tel.frames, (unsigned long long)tel.bytes,
+           (unsigned)tel.dropped);
+  }
+  free(replay);
+  return 0;
+}
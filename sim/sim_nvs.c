@@ -0,0 +1,158 @@
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvs_flash.h"
+
+// Minimal NVS: a flat table of blobs keyed by namespace and key. When the
+// flash is file-backed the table is saved next to it as "<file>.nvs" on
+// every commit, so calibration survives between simulator runs.
+
+#define SIM_NVS_MAX_ENTRIES 16
+#define SIM_NVS_MAX_BLOB 1024
+#define SIM_NVS_NAME_LEN 16
+// NVS commits a blob in 32-byte entries, each costing a flash write
+#define SIM_NVS_WRITE_US_PER_32B 60
+
+typedef struct {
+  char ns[SIM_NVS_NAME_LEN];
+  char key[SIM_NVS_NAME_LEN];
+  uint16_t len;
+  uint8_t data[SIM_NVS_MAX_BLOB];
+} sim_nvs_entry_t;
+
+typedef struct {
+  char ns[SIM_NVS_NAME_LEN];
+  bool writable;
+} sim_nvs_handle_t;
+
+static sim_nvs_entry_t entries[SIM_NVS_MAX_ENTRIES];
+static size_t n_entries;
+static sim_nvs_handle_t handles[8];
+static size_t n_handles;
+static bool initialized;
+static char nvs_path[512];
+
+void sim_nvs_set_file(const char *flash_path) {
+  snprintf(nvs_path, sizeof(nvs_path), "%s.nvs", flash_path);
+}
+
+static void nvs_save_file(void) {
+  if (nvs_path[0] == '\0')
+    return;
+
+  FILE *f = fopen(nvs_path, "wb");
+  if (f == NULL)
+    return;
+  fwrite(&n_entries, sizeof(n_entries), 1, f);
+  fwrite(entries, sizeof(entries[0]), n_entries, f);
+  fclose(f);
+}
+
+esp_err_t nvs_flash_init(void) {
+  initialized = true;
+  n_entries = 0;
+
+  if (nvs_path[0] == '\0')
+    return ESP_OK;
+
+  FILE *f = fopen(nvs_path, "rb");
+  if (f == NULL)
+    return ESP_OK;
+
+  if (fread(&n_entries, sizeof(n_entries), 1, f) != 1 ||
+      n_entries > SIM_NVS_MAX_ENTRIES ||
+      fread(entries, sizeof(entries[0]), n_entries, f) != n_entries)
+    n_entries = 0;
+  fclose(f);
+  return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void) {
+  n_entries = 0;
+  nvs_save_file();
+  return ESP_OK;
+}
+
+static sim_nvs_entry_t *find(const char *ns, const char *key) {
+  for (size_t i = 0; i < n_entries; i++) {
+    if (strcmp(entries[i].ns, ns) == 0 && strcmp(entries[i].key, key) == 0)
+      return &entries[i];
+  }
+  return NULL;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode,
+                   nvs_handle_t *out_handle) {
+  if (!initialized)
+    return ESP_ERR_NVS_NOT_INITIALIZED;
+  if (strlen(name) >= SIM_NVS_NAME_LEN)
+    return ESP_ERR_INVALID_ARG;
+
+  // A read-only namespace must already exist, as on the device
+  bool exists = false;
+  for (size_t i = 0; i < n_entries && !exists; i++)
+    exists = strcmp(entries[i].ns, name) == 0;
+  if (!exists && open_mode == NVS_READONLY)
+    return ESP_ERR_NVS_NOT_FOUND;
+
+  if (n_handles == sizeof(handles) / sizeof(handles[0]))
+    n_handles = 0;
+
+  sim_nvs_handle_t *h = &handles[n_handles];
+  strcpy(h->ns, name);
+  h->writable = open_mode == NVS_READWRITE;
+  *out_handle = (nvs_handle_t)++n_handles;
+  return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { (void)handle; }
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value,
+                       size_t *length) {
+  const sim_nvs_entry_t *e = find(handles[handle - 1].ns, key);
+  if (e == NULL)
+    return ESP_ERR_NVS_NOT_FOUND;
+
+  if (out_value == NULL) {
+    *length = e->len;
+    return ESP_OK;
+  }
+  if (*length < e->len)
+    return ESP_ERR_NVS_INVALID_LENGTH;
+
+  memcpy(out_value, e->data, e->len);
+  *length = e->len;
+  return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value,
+                       size_t length) {
+  const sim_nvs_handle_t *h = &handles[handle - 1];
+  if (!h->writable)
+    return ESP_ERR_INVALID_STATE;
+  if (length > SIM_NVS_MAX_BLOB || strlen(key) >= SIM_NVS_NAME_LEN)
+    return ESP_ERR_INVALID_SIZE;
+
+  sim_nvs_entry_t *e = find(h->ns, key);
+  if (e == NULL) {
+    if (n_entries == SIM_NVS_MAX_ENTRIES)
+      return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    e = &entries[n_entries++];
+    strcpy(e->ns, h->ns);
+    strcpy(e->key, key);
+  }
+
+  memcpy(e->data, value, length);
+  e->len = (uint16_t)length;
+  sim_consume_us((length + 31) / 32 * SIM_NVS_WRITE_US_PER_32B);
+  return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+  (void)handle;
+  nvs_save_file();
+  return ESP_OK;
+}
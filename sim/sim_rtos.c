@@ -0,0 +1,440 @@
+#include "sim.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// Host stacks are generous: LVGL rendering on x86-64 needs far more than the
+// byte counts passed to xTaskCreate on the device.
+#define SIM_STACK_SIZE (256 * 1024)
+#define SIM_TICK_US (1000000ULL / configTICK_RATE_HZ)
+#define SIM_WAIT_FOREVER UINT64_MAX
+// Fill pattern used to find the stack high-water mark
+#define SIM_STACK_FILL 0xA5
+
+struct sim_task {
+  ucontext_t ctx;
+  void *stack;
+  TaskFunction_t fn;
+  void *param;
+  UBaseType_t priority;
+  UBaseType_t number;
+  uint64_t wake_us;
+  uint64_t ready_seq;
+  const void *waiting_on; // object whose signal ends the block early
+  uint32_t notify_value;
+  bool used;
+  bool finished;
+  sim_task_stats_t stats;
+};
+
+struct sim_mutex {
+  struct sim_task *holder;
+};
+
+struct sim_event_group {
+  EventBits_t bits;
+};
+
+static struct sim_task tasks[SIM_MAX_TASKS];
+static struct sim_task *current;
+static ucontext_t scheduler_ctx;
+static uint64_t now_us;
+static void (*tick_hook)(uint32_t ms);
+static uint64_t tick_rem_us;
+static uint64_t ready_counter;
+static UBaseType_t task_counter;
+static int64_t epoch_s = 1704067200; // 2024-01-01 00:00:00 UTC
+static esp_log_level_t log_level = ESP_LOG_INFO;
+static uint32_t console_stall_us;
+
+static uint64_t thread_cpu_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void advance_to(uint64_t target_us) {
+  if (target_us <= now_us)
+    return;
+
+  uint64_t delta = target_us - now_us + tick_rem_us;
+  now_us = target_us;
+
+  if (tick_hook)
+    tick_hook((uint32_t)(delta / 1000));
+  tick_rem_us = delta % 1000;
+}
+
+static void block_until(uint64_t wake_us) {
+  current->wake_us = wake_us;
+  current->ready_seq = ready_counter++;
+  current->stats.iterations++;
+  swapcontext(&current->ctx, &scheduler_ctx);
+}
+
+static uint64_t deadline_after(TickType_t ticks) {
+  return ticks == portMAX_DELAY ? SIM_WAIT_FOREVER
+                                : now_us + (uint64_t)ticks * SIM_TICK_US;
+}
+
+// Blocks until `obj` is signalled with wake_waiters() or the deadline passes
+static void block_on(const void *obj, uint64_t deadline_us) {
+  current->waiting_on = obj;
+  block_until(deadline_us);
+  current->waiting_on = NULL;
+}
+
+static void wake_waiters(const void *obj) {
+  for (size_t i = 0; i < SIM_MAX_TASKS; i++) {
+    struct sim_task *t = &tasks[i];
+    if (t->used && !t->finished && t->waiting_on == obj) {
+      t->waiting_on = NULL;
+      t->wake_us = now_us;
+      t->ready_seq = ready_counter++;
+    }
+  }
+}
+
+static void task_trampoline(void) {
+  current->fn(current->param);
+  // A FreeRTOS task must never return; treat it like vTaskDelete(NULL)
+  current->finished = true;
+  setcontext(&scheduler_ctx);
+}
+
+static struct sim_task *pick_next(void) {
+  struct sim_task *best = NULL;
+
+  for (size_t i = 0; i < SIM_MAX_TASKS; i++) {
+    struct sim_task *t = &tasks[i];
+    if (!t->used || t->finished || t->wake_us == SIM_WAIT_FOREVER)
+      continue;
+
+    if (best == NULL || t->wake_us < best->wake_us ||
+        (t->wake_us == best->wake_us && t->priority > best->priority) ||
+        (t->wake_us == best->wake_us && t->priority == best->priority &&
+         t->ready_seq < best->ready_seq)) {
+      best = t;
+    }
+  }
+
+  return best;
+}
+
+void sim_run_until(uint64_t until_us) {
+  while (true) {
+    struct sim_task *next = pick_next();
+    if (next == NULL || next->wake_us > until_us)
+      break;
+
+    advance_to(next->wake_us);
+
+    current = next;
+    uint64_t start = thread_cpu_ns();
+    swapcontext(&scheduler_ctx, &next->ctx);
+    uint64_t spent = thread_cpu_ns() - start;
+    current = NULL;
+
+    next->stats.cpu_ns += spent;
+    if (spent > next->stats.max_cpu_ns)
+      next->stats.max_cpu_ns = spent;
+
+    if (next->finished) {
+      free(next->stack);
+      next->stack = NULL;
+    }
+  }
+
+  advance_to(until_us);
+}
+
+uint64_t sim_now_us(void) { return now_us; }
+
+void sim_consume_us(uint64_t us) { advance_to(now_us + us); }
+
+void sim_set_epoch(int64_t epoch) { epoch_s = epoch; }
+
+void sim_set_tick_hook(void (*hook)(uint32_t ms)) { tick_hook = hook; }
+
+size_t sim_task_stats(sim_task_stats_t *out, size_t max) {
+  size_t n = 0;
+
+  for (size_t i = 0; i < SIM_MAX_TASKS && n < max; i++) {
+    if (tasks[i].used)
+      out[n++] = tasks[i].stats;
+  }
+
+  return n;
+}
+
+void sim_log_set_level(esp_log_level_t level) { log_level = level; }
+
+esp_log_level_t esp_log_level_get(const char *tag) { return log_level; }
+
+void sim_log_set_console_stall(uint32_t us) { console_stall_us = us; }
+
+uint32_t esp_log_timestamp(void) { return (uint32_t)(now_us / 1000); }
+
+// A console line blocks the task printing it for console_stall_us, as a
+// USB write waiting for the host does; other tasks run meanwhile
+static void console_stall(void) {
+  if (console_stall_us > 0 && current)
+    block_until(now_us + console_stall_us);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                   ...) {
+  if (level > log_level)
+    return;
+
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  va_end(args);
+  console_stall();
+}
+
+void sim_log_write(esp_log_level_t level, const char *tag, const char *fmt,
+                   ...) {
+  static const char letters[] = "NEWIDV";
+
+  if (level > log_level)
+    return;
+
+  printf("%c (%llu) %s: ", letters[level],
+         (unsigned long long)(now_us / 1000), tag);
+
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  va_end(args);
+
+  putchar('\n');
+  console_stall();
+}
+
+// Linked with -Wl,--wrap=time so the dashboard clock follows virtual time
+time_t __wrap_time(time_t *out) {
+  time_t t = (time_t)(epoch_s + (int64_t)(now_us / 1000000));
+  if (out)
+    *out = t;
+  return t;
+}
+
+int64_t esp_timer_get_time(void) { return (int64_t)now_us; }
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                       uint32_t stack_depth, void *param,
+                       UBaseType_t priority, TaskHandle_t *out_handle) {
+  (void)stack_depth;
+
+  for (size_t i = 0; i < SIM_MAX_TASKS; i++) {
+    struct sim_task *t = &tasks[i];
+    if (t->used)
+      continue;
+
+    memset(t, 0, sizeof(*t));
+    t->stack = malloc(SIM_STACK_SIZE);
+    if (t->stack == NULL)
+      return pdFAIL;
+    memset(t->stack, SIM_STACK_FILL, SIM_STACK_SIZE);
+
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack;
+    t->ctx.uc_stack.ss_size = SIM_STACK_SIZE;
+    t->ctx.uc_link = &scheduler_ctx;
+    makecontext(&t->ctx, task_trampoline, 0);
+
+    t->fn = fn;
+    t->param = param;
+    t->priority = priority;
+    t->number = ++task_counter;
+    t->wake_us = now_us;
+    t->ready_seq = ready_counter++;
+    t->used = true;
+    t->stats.name = name;
+
+    if (out_handle)
+      *out_handle = t;
+    return pdPASS;
+  }
+
+  return pdFAIL;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void) {
+  UBaseType_t n = 0;
+
+  for (size_t i = 0; i < SIM_MAX_TASKS; i++)
+    if (tasks[i].used && !tasks[i].finished)
+      n++;
+
+  return n;
+}
+
+// Measured against the host stack, so this is headroom on x86-64 rather than
+// what the device would have left
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (task == NULL)
+    task = current;
+  if (task == NULL || task->stack == NULL)
+    return 0;
+
+  // Stacks grow down from the end of the allocation
+  const uint8_t *p = task->stack;
+  size_t untouched = 0;
+  while (untouched < SIM_STACK_SIZE && p[untouched] == SIM_STACK_FILL)
+    untouched++;
+
+  return (UBaseType_t)untouched;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t max,
+                                 uint32_t *total_run_time) {
+  UBaseType_t n = 0;
+  uint64_t total_us = 0;
+
+  for (size_t i = 0; i < SIM_MAX_TASKS; i++) {
+    struct sim_task *t = &tasks[i];
+    if (!t->used || t->finished)
+      continue;
+
+    const uint64_t run_us = t->stats.cpu_ns / 1000;
+    total_us += run_us;
+    if (n >= max)
+      continue;
+
+    status[n++] = (TaskStatus_t){
+        .xHandle = t,
+        .pcTaskName = t->stats.name,
+        .xTaskNumber = t->number,
+        .eCurrentState = t == current                  ? eRunning
+                         : t->wake_us == SIM_WAIT_FOREVER ? eSuspended
+                         : t->wake_us > now_us          ? eBlocked
+                                                        : eReady,
+        .uxCurrentPriority = t->priority,
+        .uxBasePriority = t->priority,
+        .ulRunTimeCounter = (uint32_t)run_us,
+        .pxStackBase = t->stack,
+        .usStackHighWaterMark = uxTaskGetStackHighWaterMark(t),
+    };
+  }
+
+  if (total_run_time)
+    *total_run_time = (uint32_t)total_us;
+  return n;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task == NULL || task == current) {
+    current->finished = true;
+    setcontext(&scheduler_ctx);
+  }
+
+  task->finished = true;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  block_until(now_us + (uint64_t)ticks * SIM_TICK_US);
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)(now_us / SIM_TICK_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return current; }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  task->notify_value++;
+  wake_waiters(&task->notify_value);
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  if (current->notify_value == 0)
+    block_on(&current->notify_value, deadline_after(ticks));
+
+  uint32_t value = current->notify_value;
+  if (value > 0)
+    current->notify_value = clear_on_exit ? 0 : value - 1;
+  return value;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return calloc(1, sizeof(struct sim_mutex));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+  uint64_t deadline = deadline_after(ticks);
+
+  while (mutex->holder != NULL && mutex->holder != current) {
+    if (now_us >= deadline)
+      return pdFALSE;
+    block_on(mutex, deadline);
+  }
+
+  mutex->holder = current;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  if (mutex->holder != current)
+    return pdFALSE;
+
+  mutex->holder = NULL;
+  wake_waiters(mutex);
+  return pdTRUE;
+}
+
+EventGroupHandle_t xEventGroupCreate(void) {
+  return calloc(1, sizeof(struct sim_event_group));
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+  group->bits |= bits;
+  wake_waiters(group);
+  return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+  EventBits_t prev = group->bits;
+  group->bits &= ~bits;
+  return prev;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+  return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits,
+                                BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks) {
+  uint64_t deadline = deadline_after(ticks);
+
+  while (true) {
+    EventBits_t set = group->bits & bits;
+    bool done = wait_for_all ? set == bits : set != 0;
+
+    if (done) {
+      EventBits_t ret = group->bits;
+      if (clear_on_exit)
+        group->bits &= ~bits;
+      return ret;
+    }
+
+    if (now_us >= deadline)
+      return group->bits;
+
+    block_on(group, deadline);
+  }
+}
@@ -0,0 +1,513 @@
+#!/usr/bin/env python3
+"""Subset one of LVGL's built-in fonts to the glyphs a set of sources uses.
+
+The input is an LVGL font C file as generated by lv_font_conv (for example
+lvgl/src/font/lv_font_montserrat_20.c). The glyph set is collected from the
+string literals of the --scan sources, the LV_SYMBOL_* macros they name
+(resolved through lv_symbol_def.h) and any --chars/--range given for text
+built at run time. Only those glyphs, their cmaps and the kerning classes
+they use are written out, renumbered, as a new font.
+
+Usage: font_subset.py FONT.c OUTPUT.c --name ui_font_20
+           --scan ui.c [...] [--symbols lv_symbol_def.h]
+           [--chars 0123456789] [--range 0x20-0x7E]
+
+The build fails if a required character is not in the input font, so a new
+label string cannot silently render as a placeholder box. The flash taken by
+the glyph data before and after subsetting is printed. Only the standard
+library is used so it runs from the ESP-IDF Python environment.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Sizes on the 32-bit target, without LV_FONT_FMT_TXT_LARGE
+GLYPH_DSC_BYTES = 8
+CMAP_BYTES = 24
+KERN_CLASSES_BYTES = 16
+KERN_PAIRS_BYTES = 12
+
+# A run of at least this many consecutive code points gets a FORMAT0 cmap
+# (direct index); shorter runs are merged into SPARSE cmaps (binary search)
+MIN_FORMAT0_RUN = 5
+
+TOKEN_RE = re.compile(r"""
+    (?P<comment>/\*.*?\*/|//[^\n]*)
+  | (?P<include>^\s*\#\s*include[^\n]*)
+  | (?P<char>'(?:[^'\\\n]|\\.)*')
+  | (?P<string>"(?:[^"\\\n]|\\.)*")
+  | (?P<symbol>\bLV_SYMBOL_[A-Z0-9_]+\b)
+""", re.S | re.M | re.X)
+
+
+class FontError(Exception):
+    pass
+
+
+def strip_comments(text):
+    return re.sub(r"/\*.*?\*/|//[^\n]*", "", text, flags=re.S)
+
+
+def c_string_bytes(body):
+    """Bytes of a C string literal body (without the quotes)."""
+    out = bytearray()
+    i = 0
+    simple = {"n": 10, "t": 9, "r": 13, "0": 0, "\\": 92, '"': 34, "'": 39,
+              "a": 7, "b": 8, "f": 12, "v": 11, "?": 63}
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+        nxt = body[i + 1]
+        if nxt == "x":
+            m = re.match(r"[0-9a-fA-F]+", body[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        elif nxt in "01234567":
+            m = re.match(r"[0-7]{1,3}", body[i + 1:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += 1 + len(m.group(0))
+        else:
+            out.append(simple.get(nxt, ord(nxt)))
+            i += 2
+    return bytes(out)
+
+
+def parse_symbols(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    symbols = {}
+    for m in re.finditer(r'#define\s+(LV_SYMBOL_\w+)\s+"((?:[^"\\]|\\.)*)"',
+                         text):
+        symbols[m.group(1)] = c_string_bytes(m.group(2)).decode("utf-8")
+    return symbols
+
+
+def scan_sources(paths, symbols):
+    """Returns {code point: first place it is needed}."""
+    needed = {}
+    for path in paths:
+        with open(path, encoding="utf-8") as f:
+            text = f.read()
+        for m in TOKEN_RE.finditer(text):
+            line = text.count("\n", 0, m.start()) + 1
+            where = "%s:%d" % (os.path.basename(path), line)
+            if m.group("string"):
+                try:
+                    s = c_string_bytes(m.group("string")[1:-1]).decode("utf-8")
+                except UnicodeDecodeError:
+                    raise FontError("%s: string is not UTF-8" % where)
+            elif m.group("symbol"):
+                name = m.group("symbol")
+                if symbols is None:
+                    raise FontError("%s: %s needs --symbols" % (where, name))
+                if name not in symbols:
+                    raise FontError("%s: unknown symbol %s" % (where, name))
+                s = symbols[name]
+            else:
+                continue
+            for ch in s:
+                if ord(ch) >= 0x20:
+                    needed.setdefault(ord(ch), where)
+    return needed
+
+
+def parse_array(text, name):
+    m = re.search(r"\b%s\s*\[\s*\]\s*=\s*\{(.*?)\};" % re.escape(name), text,
+                  re.S)
+    if m is None:
+        raise FontError("array %s not found" % name)
+    return [int(v, 0) for v in re.findall(r"-?(?:0x[0-9a-fA-F]+|\d+)",
+                                           m.group(1))]
+
+
+def parse_struct(text, type_name):
+    m = re.search(r"\b%s\s+\w+\s*=\s*\{(.*?)\};" % re.escape(type_name), text,
+                  re.S)
+    if m is None:
+        return None
+    return dict(re.findall(r"\.(\w+)\s*=\s*([^,\n]+?)\s*(?:,|$)", m.group(1),
+                           re.M))
+
+
+def parse_font(text):
+    text = strip_comments(text)
+    font = {}
+
+    dsc = parse_struct(text, "lv_font_fmt_txt_dsc_t")
+    if dsc is None:
+        raise FontError("no lv_font_fmt_txt_dsc_t")
+    font["bpp"] = int(dsc["bpp"])
+    if int(dsc.get("bitmap_format", "0")) != 0:
+        raise FontError("compressed fonts are not supported")
+    font["kern_scale"] = int(dsc.get("kern_scale", "0"))
+
+    public = parse_struct(text, "lv_font_t")
+    for key in ("line_height", "base_line", "underline_position",
+                "underline_thickness"):
+        font[key] = int(public.get(key, "0"))
+    font["subpx"] = public.get("subpx", "LV_FONT_SUBPX_NONE")
+
+    m = re.search(r"\bglyph_bitmap\s*\[\s*\]\s*=\s*\{(.*?)\};", text, re.S)
+    bitmap = bytes(int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\d+",
+                                                  m.group(1)))
+
+    m = re.search(r"\bglyph_dsc\s*\[\s*\]\s*=\s*\{(.*?)\};", text, re.S)
+    glyphs = []
+    for entry in re.findall(r"\{([^{}]*)\}", m.group(1)):
+        fields = dict((k, int(v)) for k, v in
+                      re.findall(r"\.(\w+)\s*=\s*(-?\d+)", entry))
+        glyphs.append(fields)
+
+    # Bitmaps are byte aligned per glyph and stored in glyph id order
+    for gid, g in enumerate(glyphs):
+        end = len(bitmap)
+        for later in glyphs[gid + 1:]:
+            if later["bitmap_index"] >= g["bitmap_index"] and \
+                    (later["box_w"] and later["box_h"]):
+                end = later["bitmap_index"]
+                break
+        g["bitmap"] = bitmap[g["bitmap_index"]:end] \
+            if g["box_w"] and g["box_h"] else b""
+    font["glyphs"] = glyphs
+
+    # Code point -> glyph id
+    cmap_of = {}
+    m = re.search(r"\bcmaps\s*\[\s*\]\s*=\s*\{(.*?)\};", text, re.S)
+    cmaps = re.findall(r"\{([^{}]*)\}", m.group(1))
+    for entry in cmaps:
+        f = dict(re.findall(r"\.(\w+)\s*=\s*([^,\n]+?)\s*(?:,|$)", entry,
+                            re.M))
+        start = int(f["range_start"])
+        length = int(f["range_length"])
+        gid0 = int(f["glyph_id_start"])
+        kind = f["type"].strip()
+        ulist = f["unicode_list"].strip()
+        olist = f["glyph_id_ofs_list"].strip()
+        unicode_list = parse_array(text, ulist) if ulist != "NULL" else None
+        ofs_list = parse_array(text, olist) if olist != "NULL" else None
+
+        if kind.endswith("FORMAT0_TINY"):
+            for i in range(length):
+                cmap_of[start + i] = gid0 + i
+        elif kind.endswith("FORMAT0_FULL"):
+            for i in range(length):
+                if ofs_list[i] or i == 0:
+                    cmap_of[start + i] = gid0 + ofs_list[i]
+        elif kind.endswith("SPARSE_TINY"):
+            for i, ofs in enumerate(unicode_list):
+                cmap_of[start + ofs] = gid0 + i
+        elif kind.endswith("SPARSE_FULL"):
+            for i, ofs in enumerate(unicode_list):
+                cmap_of[start + ofs] = gid0 + ofs_list[i]
+        else:
+            raise FontError("unknown cmap type %s" % kind)
+    font["cmap"] = cmap_of
+    font["cmap_num"] = len(cmaps)
+    font["unicode_lists"] = sum(
+        len(parse_array(text, n)) for n in
+        re.findall(r"\.unicode_list\s*=\s*(unicode_list_\w+)", text))
+    font["ofs_lists"] = sum(
+        len(parse_array(text, n)) for n in
+        re.findall(r"\.glyph_id_ofs_list\s*=\s*(glyph_id_ofs_list_\w+)",
+                   text))
+
+    font["kern"] = None
+    if int(dsc.get("kern_classes", "0")) == 1:
+        k = parse_struct(text, "lv_font_fmt_txt_kern_classes_t")
+        font["kern"] = {
+            "classes": True,
+            "left_map": parse_array(text, k["left_class_mapping"]),
+            "right_map": parse_array(text, k["right_class_mapping"]),
+            "values": parse_array(text, k["class_pair_values"]),
+            "left_cnt": int(k["left_class_cnt"]),
+            "right_cnt": int(k["right_class_cnt"]),
+        }
+    elif dsc.get("kern_dsc", "NULL") != "NULL":
+        k = parse_struct(text, "lv_font_fmt_txt_kern_pair_t")
+        ids = parse_array(text, k["glyph_ids"])
+        font["kern"] = {
+            "classes": False,
+            "pairs": list(zip(ids[0::2], ids[1::2],
+                              parse_array(text, k["values"]))),
+            "ids_size": int(k["glyph_ids_size"]),
+        }
+    return font
+
+
+def glyph_data_bytes(bitmap_len, glyph_count, cmap_num, list_entries,
+                     kern):
+    """Flash taken by the font data, excluding the two fixed descriptors."""
+    size = bitmap_len + glyph_count * GLYPH_DSC_BYTES
+    size += cmap_num * CMAP_BYTES + list_entries * 2
+    if kern and kern["classes"]:
+        size += KERN_CLASSES_BYTES + 2 * glyph_count
+        size += kern["left_cnt"] * kern["right_cnt"]
+    elif kern:
+        size += KERN_PAIRS_BYTES
+        size += len(kern["pairs"]) * (3 if kern["ids_size"] == 0 else 5)
+    return size
+
+
+def build_cmaps(codes):
+    """Splits sorted code points into (start, codes, is_format0) cmaps."""
+    runs = []
+    for cp in codes:
+        if runs and cp == runs[-1][-1] + 1:
+            runs[-1].append(cp)
+        else:
+            runs.append([cp])
+
+    cmaps = []
+    sparse = []
+    for run in runs:
+        if len(run) >= MIN_FORMAT0_RUN:
+            if sparse:
+                cmaps.append((sparse, False))
+                sparse = []
+            cmaps.append((run, True))
+            continue
+        for cp in run:
+            if sparse and cp - sparse[0] >= 0xFFFF:
+                cmaps.append((sparse, False))
+                sparse = []
+            sparse.append(cp)
+    if sparse:
+        cmaps.append((sparse, False))
+    return cmaps
+
+
+def c_bytes(data, indent="    ", per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ", ".join(
+            "0x%x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def c_ints(values, indent="    ", per_line=16):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(
+            str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def describe(cp):
+    ch = chr(cp)
+    return ch if 0x20 < cp < 0x7F else "U+%04X" % cp
+
+
+def generate(font, codes, name, source):
+    old_gids = [font["cmap"][cp] for cp in codes]
+    new_gid = {old: i + 1 for i, old in enumerate(old_gids)}
+
+    out = []
+    out.append("// Generated by tools/font_subset.py from %s; do not edit.\n"
+               "// %d glyphs: %s\n"
+               % (source, len(codes), " ".join(describe(cp) for cp in codes)))
+    out.append('#include "lvgl.h"\n')
+
+    bitmap = bytearray()
+    dsc_lines = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, "
+                 ".ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,"]
+    for cp, gid in zip(codes, old_gids):
+        g = font["glyphs"][gid]
+        dsc_lines.append(
+            "    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, "
+            ".ofs_x = %d, .ofs_y = %d}, /* %s */"
+            % (len(bitmap), g["adv_w"], g["box_w"], g["box_h"], g["ofs_x"],
+               g["ofs_y"], describe(cp)))
+        bitmap += g["bitmap"]
+    if not bitmap:
+        bitmap = bytearray(1)
+
+    out.append("static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] "
+               "= {\n%s\n};\n" % c_bytes(bitmap))
+    out.append("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n%s\n"
+               "};\n" % "\n".join(dsc_lines))
+
+    cmap_lines = []
+    list_entries = 0
+    gid = 1
+    for i, (cps, format0) in enumerate(build_cmaps(codes)):
+        if format0:
+            cmap_lines.append(
+                "    {.range_start = %d, .range_length = %d, "
+                ".glyph_id_start = %d, .unicode_list = NULL, "
+                ".glyph_id_ofs_list = NULL, .list_length = 0, "
+                ".type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY},"
+                % (cps[0], len(cps), gid))
+        else:
+            offsets = [cp - cps[0] for cp in cps]
+            out.append("static const uint16_t unicode_list_%d[] = {\n%s\n};\n"
+                       % (i, c_ints(offsets)))
+            list_entries += len(offsets)
+            cmap_lines.append(
+                "    {.range_start = %d, .range_length = %d, "
+                ".glyph_id_start = %d, .unicode_list = unicode_list_%d, "
+                ".glyph_id_ofs_list = NULL, .list_length = %d, "
+                ".type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY},"
+                % (cps[0], offsets[-1] + 1, gid, i, len(offsets)))
+        gid += len(cps)
+    out.append("static const lv_font_fmt_txt_cmap_t cmaps[] = {\n%s\n};\n"
+               % "\n".join(cmap_lines))
+
+    kern = font["kern"]
+    new_kern = None
+    kern_dsc = "NULL"
+    kern_classes = 0
+    if kern and kern["classes"]:
+        # Renumber the classes the subset still uses; 0 means no kerning
+        left = sorted({kern["left_map"][g] for g in old_gids} - {0})
+        right = sorted({kern["right_map"][g] for g in old_gids} - {0})
+        if left and right:
+            lmap = {c: i + 1 for i, c in enumerate(left)}
+            rmap = {c: i + 1 for i, c in enumerate(right)}
+            values = [kern["values"][(lc - 1) * kern["right_cnt"] + rc - 1]
+                      for lc in left for rc in right]
+            if any(values):
+                out.append(
+                    "static const uint8_t kern_left_class_mapping[] = {\n%s\n"
+                    "};\n" % c_ints([0] + [lmap.get(kern["left_map"][g], 0)
+                                           for g in old_gids]))
+                out.append(
+                    "static const uint8_t kern_right_class_mapping[] = {\n%s\n"
+                    "};\n" % c_ints([0] + [rmap.get(kern["right_map"][g], 0)
+                                           for g in old_gids]))
+                out.append("static const int8_t kern_class_values[] = {\n%s\n"
+                           "};\n" % c_ints(values))
+                out.append(
+                    "static const lv_font_fmt_txt_kern_classes_t "
+                    "kern_classes = {\n"
+                    "    .class_pair_values = kern_class_values,\n"
+                    "    .left_class_mapping = kern_left_class_mapping,\n"
+                    "    .right_class_mapping = kern_right_class_mapping,\n"
+                    "    .left_class_cnt = %d,\n"
+                    "    .right_class_cnt = %d,\n"
+                    "};\n" % (len(left), len(right)))
+                kern_dsc = "&kern_classes"
+                kern_classes = 1
+                new_kern = {"classes": True, "left_cnt": len(left),
+                            "right_cnt": len(right)}
+    elif kern:
+        pairs = [(new_gid[a], new_gid[b], v) for a, b, v in kern["pairs"]
+                 if a in new_gid and b in new_gid]
+        if pairs:
+            wide = len(codes) > 0xFF
+            out.append("static const %s kern_pair_glyph_ids[] = {\n%s\n};\n"
+                       % ("uint16_t" if wide else "uint8_t",
+                          c_ints([x for a, b, _ in pairs for x in (a, b)])))
+            out.append("static const int8_t kern_pair_values[] = {\n%s\n};\n"
+                       % c_ints([v for _, _, v in pairs]))
+            out.append("static const lv_font_fmt_txt_kern_pair_t kern_pairs = "
+                       "{\n"
+                       "    .glyph_ids = kern_pair_glyph_ids,\n"
+                       "    .values = kern_pair_values,\n"
+                       "    .pair_cnt = %d,\n"
+                       "    .glyph_ids_size = %d,\n"
+                       "};\n" % (len(pairs), 1 if wide else 0))
+            kern_dsc = "&kern_pairs"
+            new_kern = {"classes": False, "pairs": pairs,
+                        "ids_size": 1 if wide else 0}
+
+    out.append("static const lv_font_fmt_txt_dsc_t font_dsc = {\n"
+               "    .glyph_bitmap = glyph_bitmap,\n"
+               "    .glyph_dsc = glyph_dsc,\n"
+               "    .cmaps = cmaps,\n"
+               "    .kern_dsc = %s,\n"
+               "    .kern_scale = %d,\n"
+               "    .cmap_num = %d,\n"
+               "    .bpp = %d,\n"
+               "    .kern_classes = %d,\n"
+               "    .bitmap_format = 0,\n"
+               "};\n" % (kern_dsc, font["kern_scale"], len(cmap_lines),
+                         font["bpp"], kern_classes))
+
+    out.append("const lv_font_t %s = {\n"
+               "    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,\n"
+               "    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,\n"
+               "    .line_height = %d,\n"
+               "    .base_line = %d,\n"
+               "    .subpx = %s,\n"
+               "    .underline_position = %d,\n"
+               "    .underline_thickness = %d,\n"
+               "    .dsc = &font_dsc,\n"
+               "    .fallback = NULL,\n"
+               "    .user_data = NULL,\n"
+               "};" % (name, font["line_height"], font["base_line"],
+                       font["subpx"], font["underline_position"],
+                       font["underline_thickness"]))
+
+    size = glyph_data_bytes(len(bitmap), len(codes) + 1, len(cmap_lines),
+                            list_entries, new_kern)
+    return "\n".join(out) + "\n", size
+
+
+def parse_ranges(values):
+    codes = set()
+    for value in values or []:
+        lo, _, hi = value.partition("-")
+        codes.update(range(int(lo, 0), int(hi or lo, 0) + 1))
+    return codes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("font")
+    parser.add_argument("output")
+    parser.add_argument("--name", required=True,
+                        help="C identifier of the generated lv_font_t")
+    parser.add_argument("--scan", nargs="+", default=[],
+                        help="sources whose string literals are rendered")
+    parser.add_argument("--symbols", help="lvgl's lv_symbol_def.h")
+    parser.add_argument("--chars", default="",
+                        help="characters produced at run time")
+    parser.add_argument("--range", action="append",
+                        help="code point range to keep, e.g. 0x20-0x7E")
+    args = parser.parse_args()
+
+    source = os.path.basename(args.font)
+    try:
+        symbols = parse_symbols(args.symbols) if args.symbols else None
+        needed = scan_sources(args.scan, symbols)
+        with open(args.font, encoding="utf-8") as f:
+            font = parse_font(f.read())
+    except (FontError, OSError, KeyError, AttributeError, TypeError) as e:
+        sys.exit("font_subset: %s" % e)
+
+    for ch in args.chars:
+        needed.setdefault(ord(ch), "--chars")
+    for cp in parse_ranges(args.range):
+        needed.setdefault(cp, "--range")
+
+    missing = [(cp, where) for cp, where in sorted(needed.items())
+               if cp not in font["cmap"]]
+    if missing:
+        for cp, where in missing:
+            print("%s: %s needs %s, which %s does not have"
+                  % (args.name, where, describe(cp), source), file=sys.stderr)
+        sys.exit(1)
+
+    codes = sorted(needed)
+    text, size = generate(font, codes, args.name, source)
+
+    full = glyph_data_bytes(
+        sum(len(g["bitmap"]) for g in font["glyphs"]), len(font["glyphs"]),
+        font["cmap_num"], font["unicode_lists"] + font["ofs_lists"],
+        font["kern"])
+
+    with open(args.output, "w") as f:
+        f.write(text)
+
+    print("%s: %d of %d glyphs, %d -> %d bytes of flash (%d saved)"
+          % (args.name, len(codes), len(font["glyphs"]) - 1, full, size,
+             full - size))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""Convert an animated GIF into a pre-decoded LVGL sprite sheet.
+
+Every GIF frame is decoded and composited (honouring the disposal method and
+transparency) into a full canvas, converted to LV_COLOR_FORMAT_RGB565A8 and
+written as one C array. Consecutive identical frames are merged by adding
+their delays, and repeated frames share their pixel data, so the output only
+holds distinct images.
+
+Usage: gif_to_sprite.py INPUT.gif OUTPUT.c --name kitty [--header NOTICE.txt]
+
+The generated file defines `const sprite_anim_dsc_t <name>_sprite` (see
+main/sprite_anim.h). Only the standard library is used so it runs from the
+ESP-IDF Python environment.
+"""
+
+import argparse
+import struct
+import sys
+
+# Browsers clamp delays below 20 ms to 100 ms; do the same so the animation
+# runs at the speed it was authored for
+MIN_DELAY_MS = 20
+DEFAULT_DELAY_MS = 100
+
+
+class GifError(Exception):
+    pass
+
+
+def read_sub_blocks(data, pos):
+    out = bytearray()
+    while True:
+        size = data[pos]
+        pos += 1
+        if size == 0:
+            return bytes(out), pos
+        out += data[pos:pos + size]
+        pos += size
+
+
+def lzw_decode(data, min_code_size, pixel_count):
+    clear = 1 << min_code_size
+    end = clear + 1
+    code_size = min_code_size + 1
+    table = [bytes([i]) for i in range(clear)] + [b"", b""]
+    out = bytearray()
+    prev = None
+    bit_pos = 0
+    total_bits = len(data) * 8
+
+    while bit_pos + code_size <= total_bits and len(out) < pixel_count:
+        byte_pos = bit_pos >> 3
+        chunk = int.from_bytes(data[byte_pos:byte_pos + 3], "little")
+        code = (chunk >> (bit_pos & 7)) & ((1 << code_size) - 1)
+        bit_pos += code_size
+
+        if code == clear:
+            table = table[:clear + 2]
+            code_size = min_code_size + 1
+            prev = None
+            continue
+        if code == end:
+            break
+
+        if code < len(table):
+            entry = table[code]
+            if prev is not None:
+                table.append(prev + entry[:1])
+        elif prev is not None and code == len(table):
+            entry = prev + prev[:1]
+            table.append(entry)
+        else:
+            raise GifError("invalid LZW code %d" % code)
+
+        out += entry
+        prev = entry
+        if len(table) == 1 << code_size and code_size < 12:
+            code_size += 1
+
+    if len(out) < pixel_count:
+        out += bytes(pixel_count - len(out))
+    return bytes(out[:pixel_count])
+
+
+def deinterlace(indices, w, h):
+    rows = [indices[y * w:(y + 1) * w] for y in range(h)]
+    order = (list(range(0, h, 8)) + list(range(4, h, 8)) +
+             list(range(2, h, 4)) + list(range(1, h, 2)))
+    out = [None] * h
+    for src, dst in enumerate(order):
+        out[dst] = rows[src]
+    return b"".join(out)
+
+
+def decode_gif(data):
+    """Returns (width, height, [(rgba_pixels, delay_ms), ...])."""
+    if data[:6] not in (b"GIF87a", b"GIF89a"):
+        raise GifError("not a GIF file")
+
+    width, height, flags, bg_index, _ = struct.unpack("<HHBBB", data[6:13])
+    pos = 13
+    global_palette = None
+    if flags & 0x80:
+        size = 3 * (2 << (flags & 7))
+        global_palette = data[pos:pos + size]
+        pos += size
+
+    canvas = [(0, 0, 0, 0)] * (width * height)
+    frames = []
+    gce = None
+
+    while pos < len(data):
+        block = data[pos]
+        pos += 1
+
+        if block == 0x3B:  # trailer
+            break
+
+        if block == 0x21:  # extension
+            label = data[pos]
+            payload, pos = read_sub_blocks(data, pos + 1)
+            if label == 0xF9 and len(payload) >= 4:
+                packed, delay_cs, transparent = struct.unpack(
+                    "<BHB", payload[:4])
+                gce = {
+                    "disposal": (packed >> 2) & 7,
+                    "delay_ms": delay_cs * 10,
+                    "transparent": transparent if packed & 1 else None,
+                }
+            continue
+
+        if block != 0x2C:
+            raise GifError("unexpected block 0x%02x" % block)
+
+        x, y, w, h, iflags = struct.unpack("<HHHHB", data[pos:pos + 9])
+        pos += 9
+        palette = global_palette
+        if iflags & 0x80:
+            size = 3 * (2 << (iflags & 7))
+            palette = data[pos:pos + size]
+            pos += size
+        if palette is None:
+            raise GifError("frame without a colour table")
+
+        min_code_size = data[pos]
+        lzw, pos = read_sub_blocks(data, pos + 1)
+        indices = lzw_decode(lzw, min_code_size, w * h)
+        if iflags & 0x40:
+            indices = deinterlace(indices, w, h)
+
+        g = gce or {"disposal": 0, "delay_ms": 0, "transparent": None}
+        saved = list(canvas) if g["disposal"] == 3 else None
+
+        for row in range(h):
+            cy = y + row
+            if cy >= height:
+                break
+            for col in range(w):
+                cx = x + col
+                if cx >= width:
+                    break
+                idx = indices[row * w + col]
+                if idx == g["transparent"]:
+                    continue
+                r, gr, b = palette[3 * idx:3 * idx + 3]
+                canvas[cy * width + cx] = (r, gr, b, 255)
+
+        delay = g["delay_ms"]
+        if delay < MIN_DELAY_MS:
+            delay = DEFAULT_DELAY_MS
+        frames.append((list(canvas), delay))
+
+        if g["disposal"] == 2:
+            for row in range(y, min(y + h, height)):
+                for col in range(x, min(x + w, width)):
+                    canvas[row * width + col] = (0, 0, 0, 0)
+        elif g["disposal"] == 3:
+            canvas = saved
+        gce = None
+
+    if not frames:
+        raise GifError("GIF has no frames")
+    return width, height, frames
+
+
+def to_rgb565a8(pixels):
+    """RGB565 plane (little endian) followed by the A8 plane."""
+    color = bytearray()
+    alpha = bytearray()
+    for r, g, b, a in pixels:
+        if a == 0:
+            r = g = b = 0
+        c = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+        color += struct.pack("<H", c)
+        alpha.append(a)
+    return bytes(color + alpha)
+
+
+def c_bytes(data, indent="  ", per_line=12):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ", ".join(
+            "0x%02x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def generate(name, width, height, frames, notice, source):
+    # Merge runs of identical frames, then share data between repeats
+    merged = []
+    for image, delay in frames:
+        if merged and merged[-1][0] == image:
+            merged[-1][1] += delay
+        else:
+            merged.append([image, delay])
+
+    unique = []
+    frame_slot = []
+    for image, _ in merged:
+        if image not in unique:
+            unique.append(image)
+        frame_slot.append(unique.index(image))
+
+    frame_bytes = width * height * 3
+    sheet = b"".join(to_rgb565a8(image) for image in unique)
+
+    out = []
+    if notice:
+        out.append(notice.rstrip() + "\n")
+    out.append("// Generated by tools/gif_to_sprite.py from %s; do not edit.\n"
+               "// %d GIF frames -> %d frames, %d distinct images, %d bytes\n"
+               % (source, len(frames), len(merged), len(unique), len(sheet)))
+    out.append('#include "sprite_anim.h"\n')
+    out.append("#define FRAME_BYTES %d\n" % frame_bytes)
+    out.append("static const uint8_t %s_sheet[] = {\n%s\n};\n"
+               % (name, c_bytes(sheet)))
+
+    out.append("static const lv_image_dsc_t %s_frames[] = {" % name)
+    for slot in frame_slot:
+        out.append("    {\n"
+                   "        .header.magic = LV_IMAGE_HEADER_MAGIC,\n"
+                   "        .header.cf = LV_COLOR_FORMAT_RGB565A8,\n"
+                   "        .header.w = %d,\n"
+                   "        .header.h = %d,\n"
+                   "        .header.stride = %d,\n"
+                   "        .data_size = FRAME_BYTES,\n"
+                   "        .data = %s_sheet + %d * FRAME_BYTES,\n"
+                   "    }," % (width, height, width * 2, name, slot))
+    out.append("};\n")
+
+    out.append("static const uint16_t %s_durations_ms[] = {%s};\n"
+               % (name, ", ".join(str(d) for _, d in merged)))
+
+    out.append("const sprite_anim_dsc_t %s_sprite = {\n"
+               "    .frames = %s_frames,\n"
+               "    .durations_ms = %s_durations_ms,\n"
+               "    .frame_count = %d,\n"
+               "    .sheet_bytes = sizeof(%s_sheet),\n"
+               "};" % (name, name, name, len(merged), name))
+    return "\n".join(out) + "\n", len(merged), len(unique), len(sheet)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("--name", required=True,
+                        help="C identifier prefix of the generated symbols")
+    parser.add_argument("--header",
+                        help="file whose text is copied to the top of the "
+                             "output, e.g. an asset licence notice")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    notice = None
+    if args.header:
+        with open(args.header) as f:
+            notice = f.read()
+
+    try:
+        width, height, frames = decode_gif(data)
+    except (GifError, IndexError, struct.error) as e:
+        sys.exit("%s: %s" % (args.input, e))
+
+    import os
+    text, n_frames, n_unique, sheet_len = generate(
+        args.name, width, height, frames, notice,
+        os.path.basename(args.input))
+
+    with open(args.output, "w") as f:
+        f.write(text)
+
+    print("%s: %dx%d, %d frames (%d distinct), sprite sheet %d bytes"
+          % (os.path.basename(args.input), width, height, n_frames, n_unique,
+             sheet_len))
+
+
+if __name__ == "__main__":
+    main()
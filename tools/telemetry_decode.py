@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""Decode the binary telemetry stream of the desk clock into a table.
+
+The firmware (CONFIG_TELEMETRY_STREAM, main/telemetry.h) writes one COBS
+frame per sample bus publish to the USB console, between the log lines.
+This tool picks the frames out of a capture, a serial port or stdin, checks
+their CRC and writes one row per frame: sequence number, esp_timer time,
+wall clock, then the value and accuracy of every channel. Channels a frame
+does not carry are left empty.
+
+Usage: telemetry_decode.py INPUT [-o OUT.csv] [--parquet OUT.parquet]
+
+INPUT is a file, "-" for stdin, or a serial device such as /dev/ttyACM0
+(needs pyserial). Rows are written as frames arrive, so the tool can follow
+a live port. --parquet writes a columnar file at the end instead of CSV
+(needs pyarrow). A summary of frames, gaps in the sequence and skipped
+bytes goes to stderr.
+"""
+
+import argparse
+import csv
+import os
+import stat
+import struct
+import sys
+import zlib
+
+VERSION = 1
+
+# sample_channel_t order and sample_channel_name() spelling
+CHANNELS = ["iaq", "temp", "pressure", "humidity", "gas", "co2eq", "co2",
+            "pm1", "pm2.5", "pm10"]
+
+HEADER = struct.Struct("<BIqIH")
+CHANNEL = struct.Struct("<fB")
+
+COLUMNS = ["seq", "time_us", "time_s"] + [
+    name + suffix for name in CHANNELS for suffix in ("", "_acc")]
+
+
+class FrameError(Exception):
+    pass
+
+
+def cobs_decode(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        if code == 0 or pos + code > len(data):
+            raise FrameError("bad COBS block")
+        out += data[pos + 1:pos + code]
+        pos += code
+        if code < 0xff and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def shortest_f32(value):
+    """The float with the fewest digits that is still the same f32, so the
+    CSV shows 21.3 rather than 21.299999237060547."""
+    bits = struct.pack("<f", value)
+    for digits in range(6, 10):
+        short = float("%.*g" % (digits, value))
+        if struct.pack("<f", short) == bits:
+            return short
+    return value
+
+
+def decode_frame(data):
+    payload = cobs_decode(data)
+    if len(payload) < HEADER.size + 4:
+        raise FrameError("short frame")
+    body, crc = payload[:-4], struct.unpack("<I", payload[-4:])[0]
+    if zlib.crc32(body) != crc:
+        raise FrameError("CRC mismatch")
+
+    version, seq, time_us, time_s, mask = HEADER.unpack_from(body)
+    if version != VERSION:
+        raise FrameError("version %d" % version)
+
+    row = {"seq": seq, "time_us": time_us, "time_s": time_s}
+    pos = HEADER.size
+    for ch, name in enumerate(CHANNELS):
+        if not mask & (1 << ch):
+            continue
+        if pos + CHANNEL.size > len(body):
+            raise FrameError("short frame")
+        value, row[name + "_acc"] = CHANNEL.unpack_from(body, pos)
+        row[name] = shortest_f32(value)
+        pos += CHANNEL.size
+    if pos != len(body) or mask >> len(CHANNELS):
+        raise FrameError("unknown channels")
+    return row
+
+
+class Decoder:
+    """Splits a byte stream at 0x00 and decodes what lies in between.
+
+    Console text between frames fails the decode and is skipped. Frames
+    lost on the device or garbled on the way show up as sequence gaps."""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.frames = 0
+        self.skipped = 0  # bytes of console text and garbled frames
+        self.gaps = 0
+        self.missing = 0
+        self.last_seq = None
+
+    def feed(self, data):
+        self.pending += data
+        *chunks, self.pending = self.pending.split(b"\0")
+        for chunk in chunks:
+            if not chunk:
+                continue
+            try:
+                row = decode_frame(chunk)
+            except (FrameError, struct.error):
+                self.skipped += len(chunk)
+                continue
+            self.count(row["seq"])
+            yield row
+
+    def count(self, seq):
+        self.frames += 1
+        if self.last_seq is not None:
+            missing = (seq - self.last_seq - 1) & 0xffffffff
+            if missing:
+                self.gaps += 1
+                self.missing += missing
+        self.last_seq = seq
+
+
+def open_input(path):
+    if path == "-":
+        return sys.stdin.buffer
+    if stat.S_ISCHR(os.stat(path).st_mode):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("reading %s needs pyserial (pip install pyserial)" % path)
+        return serial.Serial(path, timeout=1)
+    return open(path, "rb")
+
+
+def read_chunks(f):
+    # A serial port is read until interrupted; read1 returns what a pipe
+    # has so far instead of waiting for a full buffer
+    live = hasattr(f, "in_waiting")
+    read = getattr(f, "read1", f.read)
+    while True:
+        data = f.read(max(1, f.in_waiting)) if live else read(4096)
+        if data:
+            yield data
+        elif not live:
+            return
+
+
+def write_parquet(path, rows):
+    try:
+        import pyarrow
+        import pyarrow.parquet
+    except ImportError:
+        sys.exit("--parquet needs pyarrow (pip install pyarrow)")
+    types = {"seq": pyarrow.uint32(), "time_us": pyarrow.int64(),
+             "time_s": pyarrow.uint32()}
+    arrays = [pyarrow.array([r.get(c) for r in rows],
+                            types.get(c, pyarrow.uint8() if c.endswith("_acc")
+                                      else pyarrow.float32()))
+              for c in COLUMNS]
+    pyarrow.parquet.write_table(pyarrow.table(arrays, names=COLUMNS), path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("input")
+    parser.add_argument("-o", "--output",
+                        help="CSV file to write (default stdout)")
+    parser.add_argument("--parquet",
+                        help="write a Parquet file instead of CSV")
+    args = parser.parse_args()
+
+    decoder = Decoder()
+    rows = []
+    out = None
+    writer = None
+    if not args.parquet:
+        out = open(args.output, "w", newline="") if args.output \
+            else sys.stdout
+        writer = csv.DictWriter(out, COLUMNS)
+        writer.writeheader()
+
+    f = open_input(args.input)
+    try:
+        for data in read_chunks(f):
+            for row in decoder.feed(data):
+                if writer:
+                    writer.writerow(row)
+                else:
+                    rows.append(row)
+            if out:
+                out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        f.close()
+
+    if args.parquet:
+        write_parquet(args.parquet, rows)
+    elif args.output:
+        out.close()
+
+    print("%d frames, %d gaps (%d frames missing), %d other bytes skipped"
+          % (decoder.frames, decoder.gaps, decoder.missing, decoder.skipped),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()